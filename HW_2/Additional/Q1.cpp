@@ -1,6 +1,10 @@
 #include <opencv2/opencv.hpp>
 #include <bits/stdc++.h>
 
+#include "stego/dwt.hpp"
+#include "stego/large_image.hpp"
+#include "stego/opencv.hpp"
+
 using namespace cv;
 using namespace std;
 
@@ -10,70 +14,10 @@ int adjust_dim(int dim, int levels) {
     return (dim / factor) * factor;
 }
 
-// --- Function to perform 1-level 2D Haar DWT ---
-// Input: src (CV_32F grayscale image)
-// Outputs: ll, lh, hl, hh (CV_32F subbands)
-void haar_dwt_2d(const Mat& src, Mat& ll, Mat& lh, Mat& hl, Mat& hh) {
-    if (src.empty() || src.type() != CV_32F) {
-        cerr << "Error: Input matrix for haar_dwt_2d must be CV_32F and non-empty." << "\n";
-        return;
-    }
-    if (src.rows % 2 != 0 || src.cols % 2 != 0) {
-         cerr << "Error: Input matrix dimensions must be even for Haar DWT." << "\n";
-         return;
-    }
-
-    int rows = src.rows;
-    int cols = src.cols;
-    int half_rows = rows / 2;
-    int half_cols = cols / 2;
-
-    // Temporary matrices for row transform
-    Mat temp_l(rows, half_cols, CV_32F);
-    Mat temp_h(rows, half_cols, CV_32F);
-
-    // 1. Row transform (Horizontal)
-    for (int i = 0; i < rows; ++i) {
-        for (int j = 0; j < half_cols; ++j) {
-            float p1 = src.at<float>(i, 2 * j);
-            float p2 = src.at<float>(i, 2 * j + 1);
-            temp_l.at<float>(i, j) = (p1 + p2) / 2.0f; // Average (Low pass)
-            temp_h.at<float>(i, j) = (p1 - p2) / 2.0f; // Difference (High pass)
-            // Using sqrt(2) scaling factor is theoretically correct,
-            // but /2 is common in image processing for range.
-            // temp_l.at<float>(i, j) = (p1 + p2) / sqrt(2.0f);
-            // temp_h.at<float>(i, j) = (p1 - p2) / sqrt(2.0f);
-        }
-    }
-
-    // Allocate output matrices
-    ll = Mat(half_rows, half_cols, CV_32F);
-    lh = Mat(half_rows, half_cols, CV_32F);
-    hl = Mat(half_rows, half_cols, CV_32F);
-    hh = Mat(half_rows, half_cols, CV_32F);
-
-    // 2. Column transform (Vertical)
-    for (int j = 0; j < half_cols; ++j) {
-        // On Low-pass columns from row transform
-        for (int i = 0; i < half_rows; ++i) {
-            float p1 = temp_l.at<float>(2 * i, j);
-            float p2 = temp_l.at<float>(2 * i + 1, j);
-            ll.at<float>(i, j) = (p1 + p2) / 2.0f; // LL (Avg of Avg)
-            lh.at<float>(i, j) = (p1 - p2) / 2.0f; // LH (Diff of Avg)
-            // ll.at<float>(i, j) = (p1 + p2) / sqrt(2.0f);
-            // lh.at<float>(i, j) = (p1 - p2) / sqrt(2.0f);
-        }
-        // On High-pass columns from row transform
-        for (int i = 0; i < half_rows; ++i) {
-            float p1 = temp_h.at<float>(2 * i, j);
-            float p2 = temp_h.at<float>(2 * i + 1, j);
-            hl.at<float>(i, j) = (p1 + p2) / 2.0f; // HL (Avg of Diff)
-            hh.at<float>(i, j) = (p1 - p2) / 2.0f; // HH (Diff of Diff)
-            // hl.at<float>(i, j) = (p1 + p2) / sqrt(2.0f);
-            // hh.at<float>(i, j) = (p1 - p2) / sqrt(2.0f);
-        }
-    }
-}
+// --- Multi-level 2D Haar DWT ---
+// 由 stego_core 實作: stego::forwardHaarDWT (HaarScaling::Average 即 (p1 ± p2) / 2)
+// 各層列、行轉換合併為單次掃描，直接寫入同一張係數圖 (左上 LL、右上 HL、左下 LH、右下 HH)
+// 子帶以 stego::subband 取視圖
 
 // --- Helper function to normalize and display a subband ---
 void display_subband(const Mat& subband, const string& window_name, bool normalize_for_display = true) {
@@ -98,8 +42,40 @@ void display_subband(const Mat& subband, const string& window_name, bool normali
     imshow(window_name, display_mat);
 }
 
+// --- Streaming mode for images larger than RAM ---
+// Q1 <slide.tif> [levels]  或  Q1 <scan.raw> <rows> <cols> [levels]
+// 來源以記憶體映射逐列讀取 (stego::MappedGrayImage)，stego::streamHaarDWT 每層只保留一列，
+// 子帶逐列寫入 Q1_stream_L<level>_<band>.f32 (float32 raw)，每一層的 LL 都輸出，不做縮放也不顯示
+int run_streaming(int argc, char** argv) {
+    string path = argv[1];
+    bool is_raw = argc >= 4;
+    int levels = argc == 3 || argc == 5 ? atoi(argv[argc - 1]) : 3;
+
+    stego::MappedGrayImage source;
+    bool opened = is_raw ? source.openRaw(path, atoi(argv[2]), atoi(argv[3])) : source.openTIFF(path);
+    if (!opened) {
+        cerr << "Error: Could not map " << (is_raw ? "raw" : "TIFF (uncompressed 8-bit grayscale)") << " image: " << path << "\n";
+        return -1;
+    }
+    cout << "Streaming " << source.cols() << "x" << source.rows() << ", " << levels << " levels" << "\n";
+
+    stego::SubbandFileWriter writer("Q1_stream", levels, true);
+    if (!writer.ok() || !stego::streamHaarDWT(source.rows(), source.cols(), source.rowSource(), writer.sink(), levels, stego::HaarScaling::Average, true)) {
+        cerr << "Error: Streaming Haar DWT failed." << "\n";
+        return -1;
+    }
+    for (int level = 1; level <= levels; ++level) {
+        int sub_rows = adjust_dim(source.rows(), levels) >> level;
+        int sub_cols = adjust_dim(source.cols(), levels) >> level;
+        cout << "Level " << level << ": wrote " << stego::SubbandFileWriter::fileName("Q1_stream", level, stego::Subband::LL)
+             << " (" << sub_cols << "x" << sub_rows << " float32) and the detail subbands" << "\n";
+    }
+    return 0;
+}
+
+int main (int argc, char** argv) {
+    if (argc >= 2) return run_streaming(argc, argv);
 
-int main (void) {
     // --- 1. Load Image ---
     string image_path = "../img/image.png";
     Mat img = imread(image_path, IMREAD_GRAYSCALE);
@@ -121,79 +97,51 @@ int main (void) {
     resized_img.convertTo(float_img, CV_32F); // Convert to float for calculations
 
     // --- 3. Multi-level Haar DWT ---
-    vector<Mat> ll_levels, lh_levels, hl_levels, hh_levels;
-    Mat current_ll = float_img.clone(); // Start with the full (resized) image
+    Mat coeffs(float_img.size(), CV_32F);
+    if (!stego::forwardHaarDWT(stego::toView<float>(float_img), stego::toView<float>(coeffs), levels, stego::HaarScaling::Average)) {
+        cerr << "Error: Haar DWT failed." << "\n";
+        return -1;
+    }
+    // 子帶只是 coeffs 上的視圖 (Mat header，不複製資料)
+    auto subband = [&](int level, stego::Subband band) {
+        stego::ImageView<float> v = stego::subband(stego::toView<float>(coeffs), level, band);
+        return Mat(v.rows, v.cols, CV_32F, v.data, v.step * sizeof(float));
+    };
+
+    // 係數圖只保留最後一層的 LL；第 level 層的 LL 由左上 (rows >> level) x (cols >> level) 區域
+    // (最後一層 LL 與第 level+1 層以後的細節子帶) 做 levels - level 層反轉換得到，只處理這一小塊
+    auto level_ll = [&](int level) {
+        if (level == levels) return subband(level, stego::Subband::LL);
+        Mat ll(float_img.rows >> level, float_img.cols >> level, CV_32F);
+        stego::inverseHaarDWT(stego::subband<const float>(stego::toView<float>(coeffs), level, stego::Subband::LL), stego::toView<float>(ll),
+                              levels - level, stego::HaarScaling::Average);
+        return ll;
+    };
 
     for (int level = 1; level <= levels; ++level) {
-        Mat ll, lh, hl, hh;
-        haar_dwt_2d(current_ll, ll, lh, hl, hh);
-
-        // Store the subbands for this level
-        ll_levels.push_back(ll);
-        lh_levels.push_back(lh);
-        hl_levels.push_back(hl);
-        hh_levels.push_back(hh);
-
         // Display subbands for the current level
         string level_str = "Level " + to_string(level) + " ";
-        display_subband(ll, level_str + "LL", false); // LL doesn't usually need normalization like others
-        display_subband(lh, level_str + "LH");
-        display_subband(hl, level_str + "HL");
-        display_subband(hh, level_str + "HH");
-
-        // Update the input for the next level
-        current_ll = ll; // Next level processes the current LL band
+        display_subband(level_ll(level), level_str + "LL", false); // LL doesn't usually need normalization like others
+        display_subband(subband(level, stego::Subband::LH), level_str + "LH");
+        display_subband(subband(level, stego::Subband::HL), level_str + "HL");
+        display_subband(subband(level, stego::Subband::HH), level_str + "HH");
     }
 
     // --- 4. Create Composite Visualization Image ---
+    // 係數圖本身就是合成排列，只需把每個子帶各自正規化到 0-255
     Mat dwt_display = Mat::zeros(float_img.size(), CV_8U); // Create black canvas
-
-    // Place the final LL subband (LL3) in the top-left corner
-    Mat final_ll_display;
-    ll_levels.back().convertTo(final_ll_display, CV_8U); // Convert LL3 to 8U
-    final_ll_display.copyTo(dwt_display(Rect(0, 0, final_ll_display.cols, final_ll_display.rows)));
-
-    // Place the LH, HL, HH subbands from highest level to lowest
-    int current_row_offset = 0;
-    int current_col_offset = 0;
-    for (int level = levels - 1; level >= 0; --level) {
-        Mat lh_norm, hl_norm, hh_norm;
-        int sub_cols = lh_levels[level].cols;
-        int sub_rows = lh_levels[level].rows;
-
-        normalize(lh_levels[level], lh_norm, 0, 255, NORM_MINMAX, CV_8U);
-        normalize(hl_levels[level], hl_norm, 0, 255, NORM_MINMAX, CV_8U);
-        normalize(hh_levels[level], hh_norm, 0, 255, NORM_MINMAX, CV_8U);
-
-        // Calculate top-left corner for this level's subbands
-        // For level 'l', offset is based on size of LL_(l+1) if l < levels-1
-        // For the highest level (l = levels-1), offset is (0, size_ll) for HL, (size_ll, 0) for LH, (size_ll, size_ll) for HH
-        if (level == levels - 1) { // Highest level subbands placement relative to LL_N
-           current_col_offset = sub_cols; // HL starts right of LL_N
-           current_row_offset = 0;
-           hl_norm.copyTo(dwt_display(Rect(current_col_offset, current_row_offset, sub_cols, sub_rows)));
-
-           current_col_offset = 0;        // LH starts below LL_N
-           current_row_offset = sub_rows;
-           lh_norm.copyTo(dwt_display(Rect(current_col_offset, current_row_offset, sub_cols, sub_rows)));
-
-           current_col_offset = sub_cols; // HH starts diagonal to LL_N
-           current_row_offset = sub_rows;
-           hh_norm.copyTo(dwt_display(Rect(current_col_offset, current_row_offset, sub_cols, sub_rows)));
-
-        } else { // Lower levels placement relative to the whole quadrant
-            current_col_offset = sub_cols; // HL is in top-right quadrant of its level block
-            current_row_offset = 0;
-             hl_norm.copyTo(dwt_display(Rect(current_col_offset, current_row_offset, sub_cols, sub_rows)));
-
-             current_col_offset = 0;       // LH is in bottom-left quadrant
-             current_row_offset = sub_rows;
-             lh_norm.copyTo(dwt_display(Rect(current_col_offset, current_row_offset, sub_cols, sub_rows)));
-
-             current_col_offset = sub_cols; // HH is in bottom-right quadrant
-             current_row_offset = sub_rows;
-             hh_norm.copyTo(dwt_display(Rect(current_col_offset, current_row_offset, sub_cols, sub_rows)));
-        }
+    Mat final_ll = subband(levels, stego::Subband::LL);
+    Mat ll_display = dwt_display(Rect(0, 0, final_ll.cols, final_ll.rows));
+    final_ll.convertTo(ll_display, CV_8U); // LL_N doesn't need normalization
+    for (int level = 1; level <= levels; ++level) {
+        int sub_cols = float_img.cols >> level;
+        int sub_rows = float_img.rows >> level;
+        Mat hl_display = dwt_display(Rect(sub_cols, 0, sub_cols, sub_rows));        // HL: top-right
+        Mat lh_display = dwt_display(Rect(0, sub_rows, sub_cols, sub_rows));        // LH: bottom-left
+        Mat hh_display = dwt_display(Rect(sub_cols, sub_rows, sub_cols, sub_rows)); // HH: bottom-right
+        normalize(subband(level, stego::Subband::HL), hl_display, 0, 255, NORM_MINMAX, CV_8U);
+        normalize(subband(level, stego::Subband::LH), lh_display, 0, 255, NORM_MINMAX, CV_8U);
+        normalize(subband(level, stego::Subband::HH), hh_display, 0, 255, NORM_MINMAX, CV_8U);
     }
 
 
@@ -1,170 +1,29 @@
 #include <bits/stdc++.h>
+#include "stego/huffman.hpp"
 using namespace std;
 
-// --- Huffman Tree Node Structure ---
-struct HuffmanNode {
-    char data;            // Character ('\0' for internal nodes)
-    int frequency;        // Frequency of the character/subtree
-    HuffmanNode *left, *right; // Pointers to children
-
-    // Constructor for leaf nodes
-    HuffmanNode(char data, int frequency): data(data), frequency(frequency), left(nullptr), right(nullptr) {}
-
-    // Constructor for internal nodes
-    HuffmanNode(HuffmanNode* l, HuffmanNode* r): data('\0'), frequency(l->frequency + r->frequency), left(l), right(r) {}
-
-    // Check if it's a leaf node
-    bool isLeaf() const {
-        return left == nullptr and right == nullptr;
-    }
-};
-
-// --- Comparator for Priority Queue (Min Heap) ---
-struct cmp {
-    bool operator () (const HuffmanNode* n1, const HuffmanNode* n2) {
-        // We want the node with LOWER frequency to have HIGHER priority
-        return n1->frequency > n2->frequency;
-    }
-};
+// --- 正規 (canonical) Huffman 編碼 ---
+// 由 stego_core 實作 (stego/huffman.hpp)：不再建立 HuffmanNode* 樹、也不以 '0'/'1' 字元組成字串
+// 1. 由次數求各字元的碼長 (最長 15 位元)，碼字由碼長依序指定，串流只需存 256 個 4 位元的碼長
+// 2. 編碼輸出真正打包的位元串流 (每個位元 1 bit，而不是 1 個 char)
+// 3. 解碼以 11 位元的查表一次解出 1 ~ 2 個字元，不再逐位元走訪樹
 
 // --- Function to calculate character frequencies ---
-unordered_map<char, int> calculateFrequencies (const string& text) {
-    unordered_map<char, int> freqMap;
-    for (char c: text) {
-        freqMap[c]++;
-    }
-    return freqMap;
-}
-
-// --- Function to build the Huffman Tree ---
-HuffmanNode* buildHuffmanTree (const unordered_map<char, int>& freqMap) {
-    // Priority queue to store nodes (min heap based on frequency)
-    priority_queue<HuffmanNode*, vector<HuffmanNode*>, cmp> pq;
-
-    // Create a leaf node for each character and add it to the priority queue
-    for (const auto &[key, val] : freqMap) {
-        if (val > 0) { // Only include characters that actually appear
-             pq.push(new HuffmanNode(key, val));
-        }
-    }
-
-     // Handle edge case: empty text or text with only one unique character
-    if (pq.empty()) return nullptr;
-    if (pq.size() == 1) {
-        // Create a dummy parent node if only one character exists
-        HuffmanNode* leaf = pq.top();
-        pq.pop();
-        // Create an internal node with the leaf as left child (or right, doesn't matter)
-        // Assign a dummy character like '\0' or keep the leaf's char if needed, freq is same
-        return new HuffmanNode(leaf, new HuffmanNode('\1', 0)); // Use a dummy char like SOH
-    }
-
-
-    // Build the tree by merging nodes
-    while (pq.size() > 1) {
-        // Extract the two nodes with the lowest frequencies
-        HuffmanNode* left = pq.top();
-        pq.pop();
-        HuffmanNode* right = pq.top();
-        pq.pop();
-
-        // Create a new internal node with these two nodes as children
-        // The frequency of the new node is the sum of the frequencies of the children
-        HuffmanNode* newNode = new HuffmanNode(left, right);
-
-        // Add the new internal node back into the priority queue
-        pq.push(newNode);
-    }
-
-    // The remaining node is the root of the Huffman Tree
-    return pq.top();
-}
-
-// --- Function to generate Huffman codes (recursive traversal) ---
-void generateCodes (HuffmanNode* root, const string& currentCode, map<char, string>& huffmanCodes) {
-    if (!root) {
-        return;
+array<uint64_t, 256> calculateFrequencies (const string& text) {
+    array<uint64_t, 256> freq{};
+    for (unsigned char c: text) {
+        freq[c]++;
     }
-
-    // If it's a leaf node, store the code
-    if (root->isLeaf()) {
-         // Avoid storing code for the dummy node if created for single char case
-        if (root->data != '\1' || root->frequency > 0) {
-            huffmanCodes[root->data] = currentCode.empty()? "0" : currentCode; // Handle single node tree case
-        }
-        return;
-    }
-
-    // Traverse left (append '0')
-    generateCodes(root->left, currentCode + "0", huffmanCodes);
-    // Traverse right (append '1')
-    generateCodes(root->right, currentCode + "1", huffmanCodes);
-}
-
-// --- Function to encode the input text ---
-string encode (const string& text, const map<char, string>& huffmanCodes) {
-    string encodedString = "";
-    for (char c: text) {
-        // Handle case where character might not be in codes (shouldn't happen with proper build)
-        if (huffmanCodes.count(c)) {
-             encodedString += huffmanCodes.at(c);
-        } else {
-            cerr << "Warning: Character '" << c << "' not found in Huffman codes map." << '\n';
-        }
-    }
-    return encodedString;
+    return freq;
 }
 
-// --- Function to decode the encoded text ---
-string decode (const string& encodedString, HuffmanNode* root) {
-    string decodedString = "";
-    if (!root) return ""; // Handle empty tree
-    // Handle single node tree case (where root might be the only leaf)
-    if (root->isLeaf()) {
-        for (size_t i = 0; i < encodedString.length(); ++i) { // Assuming '0'*n encoding
-             if (encodedString[i] == '0') {
-                 decodedString += root->data;
-             } else {
-                 cerr << "Warning: Invalid bit in single-node encoded string." << '\n';
-             }
-        }
-        return decodedString;
-    }
-
-
-    HuffmanNode* currentNode = root;
-    for (char bit: encodedString) {
-        if (bit == '0') {
-            currentNode = currentNode->left;
-        } else { // bit == '1'
-            currentNode = currentNode->right;
-        }
-
-        // If reached a leaf node
-        if (currentNode && currentNode->isLeaf()) {
-            decodedString += currentNode->data;
-            currentNode = root; // Go back to the root for the next character
-        }
-         // Basic error check
-        if (!currentNode) {
-            cerr << "Error: Invalid encoded sequence or incomplete tree traversal." << '\n';
-            break; // Stop decoding
-        }
-    }
-    return decodedString;
+// --- 顯示用：碼字轉成 '0'/'1' 字串 ---
+string codeString (uint16_t code, int length) {
+    string s;
+    for (int i = length - 1; i >= 0; --i) s += ((code >> i) & 1) ? '1' : '0';
+    return s;
 }
 
-// --- Function to delete the Huffman Tree (Post-order traversal) ---
-void deleteTree (HuffmanNode* node) {
-    if (!node) {
-        return;
-    }
-    deleteTree(node->left);
-    deleteTree(node->right);
-    delete node;
-}
-
-
 int main (void) {
     string text = "Never gonna give you up, never gonna let you down, never gonna run around and desert you.";
 
@@ -177,56 +36,60 @@ int main (void) {
     }
 
     // 1. Calculate Frequencies
-    unordered_map<char, int> frequencies = calculateFrequencies(text);
+    array<uint64_t, 256> frequencies = calculateFrequencies(text);
     cout << "\nCharacter Frequencies:" << '\n';
-    for (const auto &[key, val]: frequencies) {
-        cout << "'" << key << "': " << val << '\n';
+    for (int c = 0; c < 256; ++c) {
+        if (frequencies[c]) cout << "'" << static_cast<char>(c) << "': " << frequencies[c] << '\n';
     }
 
-    // 2. Build Huffman Tree
-    HuffmanNode* root = buildHuffmanTree(frequencies);
-    if (!root) {
-        cerr << "Error building Huffman tree." << '\n';
+    // 2. Code lengths + canonical codes (取代建樹與遞迴產生字串碼)
+    stego::HuffmanLengths lengths = stego::huffmanCodeLengths(frequencies);
+    stego::HuffmanCodes codes;
+    if (!stego::canonicalHuffmanCodes(lengths, codes)) {
+        cerr << "Error building Huffman codes." << '\n';
         return 1;
     }
-
-
-    // 3. Generate Huffman Codes
-    map<char, string> huffmanCodes;
-    generateCodes(root, "", huffmanCodes); // Start with empty code string
-    cout << "\nHuffman Codes:" << '\n';
-    for (const auto &[key, val] : huffmanCodes) {
-        cout << "'" << key << "': " << val << '\n';
+    cout << "\nHuffman Codes (canonical):" << '\n';
+    for (int c = 0; c < 256; ++c) {
+        if (lengths[c]) cout << "'" << static_cast<char>(c) << "': " << codeString(codes[c], lengths[c]) << '\n';
     }
 
-    // 4. Encode the Text
-    string encodedText = encode(text, huffmanCodes);
-    cout << "\nEncoded Text: " << encodedText << '\n';
-    cout << "Encoded Size: " << encodedText.length() << " bits" << '\n';
+    // 3. Encode the Text (打包的位元串流：標頭 + 碼長 + 碼字)
+    stego::BitBuffer encoded = stego::huffmanEncode(text.data(), text.size());
+    uint64_t payloadBits = 0;
+    for (int c = 0; c < 256; ++c) payloadBits += frequencies[c] * lengths[c];
+    cout << "\nEncoded Size: " << payloadBits << " bits of codes + " << encoded.size() - payloadBits << " bits of header = " << encoded.byteSize() << " bytes" << '\n';
+    cout << "As a '0'/'1' string it would take " << payloadBits << " bytes (" << payloadBits * 8 << " bits)" << '\n';
+    cout << "Compression Ratio (code bits/original bits): " << (payloadBits / (text.length() * 8.0)) << '\n';
 
-    // Calculate compression ratio (simple bit comparison)
-    if (!text.empty()) {
-        double original_bits = text.length() * 8.0;
-        double encoded_bits = encodedText.length();
-        if (original_bits > 0) {
-            cout << "Compression Ratio (encoded/original bits): " << (encoded_bits / original_bits) << '\n';
-        }
+    // 4. Decode the Text
+    vector<uint8_t> decoded;
+    if (!stego::huffmanDecode(encoded, decoded)) {
+        cerr << "Error: Invalid encoded stream." << '\n';
+        return 1;
     }
-
-
-    // 5. Decode the Text
-    string decodedText = decode(encodedText, root);
+    string decodedText(decoded.begin(), decoded.end());
     cout << "\nDecoded Text: " << decodedText << '\n';
 
-    // 6. Verify
+    // 5. Verify
     if (text == decodedText) {
         cout << "\nVerification Successful: Original and Decoded texts match!" << '\n';
     } else {
         cout << "\nVerification Failed: Texts do not match!" << '\n';
     }
 
-    // 7. Clean up: Delete the Huffman Tree
-    deleteTree(root);
-    cout << "\nHuffman tree deleted." << '\n';
+    // 6. Throughput on a larger input (重複文字到 16 MB)
+    string large;
+    while (large.size() < (16u << 20)) large += text + ' ';
+    auto start = chrono::steady_clock::now();
+    stego::BitBuffer largeEncoded = stego::huffmanEncode(large.data(), large.size());
+    auto mid = chrono::steady_clock::now();
+    vector<uint8_t> largeDecoded;
+    bool ok = stego::huffmanDecode(largeEncoded, largeDecoded);
+    auto end = chrono::steady_clock::now();
+    ok = ok && equal(largeDecoded.begin(), largeDecoded.end(), large.begin(), large.end());
+    double mb = large.size() / 1e6;
+    cout << "\n" << mb << " MB: encode " << mb / chrono::duration<double>(mid - start).count() << " MB/s, decode "
+         << mb / chrono::duration<double>(end - mid).count() << " MB/s, match: " << (ok ? "True" : "False") << '\n';
     return 0;
-}
\ No newline at end of file
+}
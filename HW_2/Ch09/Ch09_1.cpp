@@ -1,4 +1,6 @@
 #include <bits/stdc++.h>
+#include "stego/cipher.hpp"
+#include "stego/shamir.hpp"
 using namespace std;
 
 using ll = long long;
@@ -6,10 +8,6 @@ const ll mod = INT_MAX;
 
 int n = 5, m = 5;
 using pi = pair<long, long>;
-// 快速冪
-ll power (ll a, ll b) { ll ans = 1; for (; b; b >>= 1, a = a * a % mod) if (b & 1) ans = ans * a % mod; return ans; }
-ll inv (ll a) { return power(a, mod - 2); } // modulo inverse
-
 auto seed = std::chrono::high_resolution_clock::now().time_since_epoch().count();
 mt19937 Generate(seed);
 
@@ -44,37 +42,27 @@ vector<pi> encode(ll secret) {
 }
 
 // 解碼函數：使用 m 個份額 v 來還原秘密值
-ll decode(const vector<pi>& v) {
-    ll secret = 0;  // 初始化還原的秘密值
-
-    // 使用拉格朗日插值法找出多項式的常數項 (即秘密值)
-    // P(0) = sum( y_i * L_i(0) ) for i = 0 to m-1
-    // L_i(x) = product( (x - x_j) / (x_i - x_j) ) for j = 0 to m-1, j != i
-    // L_i(0) = product( (-x_j) / (x_i - x_j) ) for j = 0 to m-1, j != i
-    for (int i = 0; i < m; ++i) {  // 迭代選擇的 m 個份額
-        ll x = v[i].first;         // 當前份額的 x 座標
-        ll y = v[i].second;        // 當前份額的 y 座標
-
-        ll num = 1;    // 拉格朗日基底多項式 L_i(0) 的分子部分
-        ll denom = 1;  // 拉格朗日基底多項式 L_i(0) 的分母部分
-
-        // 計算 L_i(0)
-        for (int j = 0; j < m; ++j) {  // 迭代其他 m-1 個份額
-            if (i ^ j) {               // 如果 i 不等於 j
-                // 計算分子: product (-x_j)
-                num = num * (mod - v[j].first) % mod;  // (mod - x_j) 等價於 -x_j 模 mod
-                // 計算分母: product (x_i - x_j)
-                denom = denom * (x - v[j].first + mod) % mod;  // (x_i - x_j + mod) % mod 避免負數
-            }
-        }
+// 使用拉格朗日插值法找出多項式的常數項 (即秘密值)
+// P(0) = sum( y_i * L_i(0) )，L_i(0) = product( (-x_j) / (x_i - x_j) ) for j != i
+// 權重 L_i(0) 由 stego::LagrangeReconstructor 計算：m 個分母以批次反元素只做一次快速冪，
+// 同一組 x 座標要還原很多秘密時，建好一次就能重複使用 (見 decodeBatch)
+static_assert(mod == stego::MERSENNE_31, "mod 必須是 2^31 - 1");
 
-        // 計算 L_i(0) = num / denom = num * inv(denom) % mod
-        ll term = num * inv(denom) % mod;
+ll decode(const vector<pi>& v) {
+    vector<uint32_t> xs(m), ys(m);
+    for (int i = 0; i < m; ++i) xs[i] = v[i].first, ys[i] = v[i].second;
+    stego::LagrangeReconstructor reconstructor(xs);
+    return reconstructor.reconstruct(ys.data());  // 回傳還原的秘密值
+}
 
-        // 將 y_i * L_i(0) 加到 secret 中
-        secret = (secret + y * term % mod) % mod;
-    }
-    return secret % mod;  // 回傳還原的秘密值
+// 批次解碼：shares[i][j] 為第 i 個份額 (x = xs[i]) 對第 j 個秘密的 y 值，一次還原全部秘密
+vector<uint32_t> decodeBatch(const vector<uint32_t>& xs, const vector<vector<uint32_t>>& shares) {
+    stego::LagrangeReconstructor reconstructor(xs);
+    vector<const uint32_t*> ys;
+    for (auto& s: shares) ys.emplace_back(s.data());
+    vector<uint32_t> secrets(shares.empty() ? 0 : shares[0].size());
+    reconstructor.reconstruct(ys.data(), secrets.size(), secrets.data());
+    return secrets;
 }
 
 int main (void) {
@@ -91,5 +79,49 @@ int main (void) {
     ll decoded = decode(v);
     cout << "Decoded: " << decoded << "\n";
     cout << "Decoded == Secret: " << (decoded == secret ? "True" : "False") << "\n";
+
+    // 同一組 x 座標 (1..n) 的大量秘密：逐一 encode 後以 decodeBatch 一次還原
+    const int count = 1 << 20;
+    vector<ll> secrets(count);
+    vector<uint32_t> xs(m);
+    vector<vector<uint32_t>> ys(m, vector<uint32_t>(count));
+    for (int j = 0; j < count; ++j) {
+        secrets[j] = Generate() % mod;
+        auto points = encode(secrets[j]);
+        for (int i = 0; i < m; ++i) xs[i] = points[i].first, ys[i][j] = points[i].second;
+    }
+    auto start = chrono::steady_clock::now();
+    vector<uint32_t> batch = decodeBatch(xs, ys);
+    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    bool batchOk = equal(batch.begin(), batch.end(), secrets.begin());
+    cout << "Batch decoded " << count << " secrets in " << ms << " ms: " << (batchOk ? "True" : "False") << "\n";
+
+    // GF(2^8) 上的 (k,n) Shamir：整個緩衝區 (影像、金鑰) 逐位元組一次分享，由 stego_core 實作
+    // 拉格朗日權重只對選到的分享計算一次，之後每個位元組都是查表相乘後 XOR
+    const int threshold = 3;
+    vector<uint8_t> buffer(1 << 20);
+    for (auto& b: buffer) b = Generate() & 0xFF;
+    const uint64_t bufferSeed = (static_cast<uint64_t>(Generate()) << 32) | Generate();
+    vector<stego::ShamirShare> shares = stego::shamirSplit(buffer.data(), buffer.size(), threshold, n, bufferSeed);
+    vector<stego::ShamirShare> subset = {shares[0], shares[2], shares[4]};  // 任取 threshold 張
+    vector<uint8_t> recovered = stego::shamirCombine(subset);
+    cout << "\nGF(256) (" << threshold << "," << n << ") buffer of " << buffer.size() << " bytes, recovered from shares 1, 3, 5: " << (recovered == buffer ? "True" : "False") << "\n";
+
+    // 影像秘密分享 (Thien-Lin)：每 threshold 個像素當作一個多項式的全部係數，每張影子只有 1/threshold 寬
+    // 係數就是像素本身，先以串流加密打亂；GF(251) 中 >= 250 的像素拆成兩個值，還原後無損
+    const int rows = 2048, cols = 2048;
+    stego::Image<uint8_t> image(rows, cols);
+    for (int r = 0; r < rows; ++r)
+        for (int c = 0; c < cols; ++c) image.at(r, c) = static_cast<uint8_t>((r + c) / 16);  // 漸層測試影像
+    const unsigned int imageKey = Generate();
+    stego::Image<uint8_t> encrypted = stego::encryptDecryptStream(image, imageKey);
+    vector<stego::ShadowImage> shadows = stego::splitSecretImage(encrypted, threshold, n, stego::SharingField::GF251);
+    vector<stego::ShadowImage> chosen = {shadows[4], shadows[1], shadows[3]};  // 任取 threshold 張，順序不拘
+    stego::Image<uint8_t> combined(rows, cols);
+    bool imageOk = stego::combineSecretImage(chosen, threshold, stego::SharingField::GF251, combined);
+    stego::Image<uint8_t> decrypted = stego::encryptDecryptStream(combined, imageKey);
+    imageOk = imageOk && equal(decrypted.data(), decrypted.data() + decrypted.total(), image.data());
+    cout << "GF(251) (" << threshold << "," << n << ") image " << rows << "x" << cols << " -> shadows " << shadows[0].image.rows() << "x" << shadows[0].image.cols()
+         << ", recovered from shadows 5, 2, 4: " << (imageOk ? "True" : "False") << "\n";
     return 0;
 }
\ No newline at end of file
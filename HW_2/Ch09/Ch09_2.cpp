@@ -1,6 +1,9 @@
 #include <opencv2/opencv.hpp>
 #include <bits/stdc++.h>
 
+#include "stego/halftone.hpp"
+#include "stego/opencv.hpp"
+
 using namespace std;
 using cv::Mat;
 
@@ -11,33 +14,13 @@ uchar clamp (float val) { // 限制值在 0 到 255 之間
     return static_cast<uchar>(val);
 }
 
-void floydSteinberg (const Mat &src, Mat &dst) { // Floyd-Steinberg dithering algorithm
-    Mat input;
-    src.convertTo(input, CV_32F);
-    int n = src.rows, m = src.cols;
-    dst = Mat::zeros(n, m, CV_8U);
-
-    // 遍歷每個像素
-    // 對於每個像素，計算其錯誤並將其分配給相鄰的像素
-    // 這裡使用了 Floyd-Steinberg 算法的錯誤擴散
-    // 將每個像素的值四捨五入到最接近的顏色
-    // 並將錯誤分配給右側和下方的像素
-    // 右側像素的錯誤分配比例為 7/16，下方像素的錯誤分配比例為 5/16
-    // 左下角像素的錯誤分配比例為 3/16，右下角像素的錯誤分配比例為 1/16
-    for (int i = 0; i < n; ++i) for (int j = 0; j < m; ++j) {
-        float oldPixel = input.at<float>(i, j);
-        float newPixel = (oldPixel > 127)? 255: 0;
-
-        dst.at<uchar>(i, j) = newPixel;
-        float quantError = oldPixel - newPixel;
-
-        if (j + 1 < m) input.at<float>(i, j + 1) += quantError * 7.0f / 16.0f;
-        if (i + 1 < n) {
-            if (j > 0) input.at<float>(i + 1, j - 1) += quantError * 3.0f / 16.0f;
-            input.at<float>(i + 1, j) += quantError * 5.0f / 16.0f;
-            if (j + 1 < m) input.at<float>(i + 1, j + 1) += quantError * 1.0f / 16.0f;
-        }
-    }
+// Floyd-Steinberg dithering algorithm
+// 由 stego_core 實作: stego::floydSteinberg (誤差擴散的運算與原本逐點迴圈相同，輸出逐位元一致)
+// 右側 7/16、左下 3/16、下方 5/16、右下 1/16；各列以波前排程平行處理，上一列領先至少 2 個像素即可開始
+void floydSteinberg (const Mat &src, Mat &dst) {
+    const int threads = 0;
+    dst = Mat::zeros(src.rows, src.cols, CV_8U);
+    stego::floydSteinberg(stego::toGrayView(src), stego::toGrayView(dst), threads);
 }
 
 int main (void) {
@@ -49,6 +32,19 @@ int main (void) {
     cv::imshow("Original", image);
     cv::imshow("Dithered", output);
     cv::imwrite("ch09_2_dithered.png", output);
+
+    // 定點整數誤差擴散：各濾波器、一般與蛇形掃描的比較
+    const pair<stego::DiffusionFilter, string> filters[] = {
+        {stego::DiffusionFilter::FloydSteinberg, "fs"},
+        {stego::DiffusionFilter::JarvisJudiceNinke, "jjn"},
+        {stego::DiffusionFilter::Stucki, "stucki"},
+        {stego::DiffusionFilter::Atkinson, "atkinson"},
+    };
+    for (const auto& [filter, name] : filters) for (bool serpentine : {false, true}) {
+        Mat halftone(image.size(), CV_8U);
+        stego::errorDiffusion(stego::toGrayView(image), stego::toGrayView(halftone), filter, serpentine);
+        cv::imwrite("ch09_2_" + name + (serpentine ? "_serpentine" : "") + ".png", halftone);
+    }
     cv::waitKey(0);
     cv::destroyAllWindows();
     return 0;
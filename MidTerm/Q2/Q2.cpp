@@ -1,151 +1,19 @@
 #include <opencv2/opencv.hpp>
 #include <bits/stdc++.h>
 
-const int BLOCK_SIZE = 8; // DCT 處理區塊大小
+#include "stego/bits.hpp"
+#include "stego/dct.hpp"
+#include "stego/metrics.hpp"
+#include "stego/opencv.hpp"
+
+const int BLOCK_SIZE = stego::DCT_BLOCK; // DCT 處理區塊大小
 const int COEFF_U = 4;
 const int COEFF_V = 1;
+const float MODIFICATION_STEP = 4.0f; // 奇偶性不符時嘗試的修改步長
 
-// --- DCT 嵌入函數 ---
-cv::Mat embedDCT(const cv::Mat& coverImage, const std::string& message, int u, int v) {
-    cv::Mat stegoImage = coverImage.clone();
-    stegoImage.convertTo(stegoImage, CV_32F); // 轉換為浮點數進行計算
-
-    int messageIndex = 0;
-    int messageLen = message.length();
-    const float modification_step = 4.0f; // 嘗試更大的步長
-
-    for (int r = 0; r < stegoImage.rows; r += BLOCK_SIZE) {
-        for (int c = 0; c < stegoImage.cols; c += BLOCK_SIZE) {
-            if (messageIndex >= messageLen) {
-                goto end_embedding;
-            }
-
-            cv::Mat block = stegoImage(cv::Rect(c, r, BLOCK_SIZE, BLOCK_SIZE));
-            cv::dct(block, block); // 進行 DCT
-
-            float& coeff = block.at<float>(u, v); // 取得係數參考
-            int coeff_int = static_cast<int>(round(coeff)); // 四捨五入取整
-            int current_lsb = std::abs(coeff_int) & 1; // 計算目前奇偶性
-            int bit_to_embed = message[messageIndex] - '0'; // 取得要嵌入的位元
-
-            if (current_lsb != bit_to_embed) {
-                // 如果奇偶性不符，需要修改係數
-                float original_coeff = coeff; // 保留原始浮點值
-
-                // 嘗試直接增減 modification_step 來改變奇偶性
-                int parity_after_add = std::abs(static_cast<int>(round(coeff + modification_step))) % 2;
-                int parity_after_sub = std::abs(static_cast<int>(round(coeff - modification_step))) % 2;
-
-                if (parity_after_add == bit_to_embed) {
-                    coeff += modification_step;
-                } else if (parity_after_sub == bit_to_embed) {
-                    coeff -= modification_step;
-                } else {
-                    // *** 強化備用策略 ***
-                    // 如果加減 step 都無效，強制設定為一個絕對值較大的整數
-                    int new_coeff_int;
-                    if (bit_to_embed == 1) { // 需要奇數
-                        new_coeff_int = 5;  // 選擇一個奇數
-                    } else { // 需要偶數
-                        new_coeff_int = -6; // 選擇一個偶數
-                    }
-                    coeff = static_cast<float>(new_coeff_int);
-                }
-            }
-
-            cv::idct(block, block); // 進行反 DCT
-            messageIndex++;
-        }
-    }
-
-end_embedding:
-    stegoImage.convertTo(stegoImage, CV_8U); // 轉換回 8 位元整數
-
-    if (messageIndex < messageLen) {
-        std::cerr << "警告：嵌入過程結束，但只嵌入了 " << messageIndex << " 個位元 (可能有問題)。" << "\n";
-    }
-    return stegoImage;
-}
-
-// --- DCT 取出函數 ---
-std::string extractDCT (const cv::Mat& stegoImage, int messageLength, int u, int v) {
-    cv::Mat workImage; // 用於處理的影像副本
-    // 轉換為浮點數格式以進行 DCT 計算
-    stegoImage.convertTo(workImage, CV_32F);
-
-    std::string extractedMessage = ""; // 初始化取出的訊息字串
-    int bitsExtracted = 0; // 已取出的位元數量
-
-    // 以 8x8 區塊迭代影像
-    for (int r = 0; r < workImage.rows; r += BLOCK_SIZE) {
-        for (int c = 0; c < workImage.cols; c += BLOCK_SIZE) {
-            if (bitsExtracted >= messageLength) { // 如果已取出足夠長度的訊息，提前結束
-                 goto end_extraction;
-            }
-
-            // 取得目前的 8x8 區塊 (建立副本以進行 DCT，避免修改 workImage)
-            cv::Mat block = workImage(cv::Rect(c, r, BLOCK_SIZE, BLOCK_SIZE)).clone();
-
-            // 進行 DCT 轉換 (in-place)
-            cv::dct(block, block);
-
-            // 取得目標係數的值
-            float coeff = block.at<float>(u, v);
-            // 將係數四捨五入到最接近的整數
-            int coeff_int = static_cast<int>(round(coeff));
-
-            // 取出係數整數部分的 LSB (奇偶性) 作為隱藏的位元
-            int extracted_bit = std::abs(coeff_int) % 2;
-
-            // 將取出的位元 (0 或 1) 添加到訊息字串中
-            extractedMessage += std::to_string(extracted_bit);
-            bitsExtracted++; // 增加已取出位元計數
-        }
-    }
-
-end_extraction: // goto 跳轉標籤
-
-    if (bitsExtracted < messageLength) {
-        std::cerr << "警告：取出過程結束，但只取出了 " << bitsExtracted << " 個位元 (預期 " << messageLength << " 個)。" << "\n";
-    }
-
-    // 確保返回的訊息字串長度不超過預期長度
-    if (extractedMessage.length() > messageLength) {
-        return extractedMessage.substr(0, messageLength);
-    }
-
-    return extractedMessage; // 返回取出的訊息字串
-}
-
-
-// --- PSNR 計算函數 (與 LSB 範例相同) ---
-double calculatePSNR (const cv::Mat& img1, const cv::Mat& img2) {
-    // 檢查輸入影像的有效性、尺寸、類型是否匹配且為 CV_8UC1
-    if (img1.empty() || img2.empty() || img1.size() != img2.size() || img1.type() != img2.type() || img1.type() != CV_8UC1) {
-         std::cerr << "錯誤/警告 (PSNR)：輸入影像無效、不匹配或非 CV_8UC1 格式。" << "\n";
-        return 0.0; // 返回 0 或其他錯誤值
-    }
-
-    cv::Mat diff;
-    cv::absdiff(img1, img2, diff);       // 計算絕對差值 |img1 - img2|
-    diff.convertTo(diff, CV_64F);        // 轉換為 64 位元浮點數以避免平方後溢位
-    diff = diff.mul(diff);               // 計算差值的平方 (element-wise)
-
-    cv::Scalar sumScalar = cv::sum(diff); // 計算所有平方差的總和
-    // 除以像素總數得到均方誤差 (MSE)
-    double mse = sumScalar[0] / (double)(img1.rows * img1.cols);
-
-    // 處理 MSE 為 0 (或極小) 的情況，表示影像完全相同
-    if (mse <= 1e-10) { // 使用一個小的容忍值比較浮點數
-        return std::numeric_limits<double>::infinity(); // 返回正無窮大
-    }
-
-    double maxPixelValue = 255.0; // 8 位元影像的最大像素值
-    // 計算 PSNR (dB)
-    double psnr = 10.0 * log10((maxPixelValue * maxPixelValue) / mse);
-
-    return psnr;
-}
+// 單一係數 (u, v) 奇偶性 DCT 嵌入/取出與 PSNR 計算由 stego_core 實作:
+// stego::embedDCTParity / stego::extractDCTParity / stego::calculatePSNR
+// 區塊 DCT 以整條 8 列區塊帶為單位批次轉換 (AAN 分解 + AVX)，只轉換攜帶位元的區塊並平行處理各條帶
 
 // --- 主函數 ---
 int main (void) {
@@ -192,12 +60,16 @@ int main (void) {
     std::cout << "----------------------------------------" << "\n";
 
     // --- 嵌入訊息 ---
-    cv::Mat stegoImage = embedDCT(coverImage, secretMessage, COEFF_U, COEFF_V);
+    size_t bitsEmbedded = 0;
+    cv::Mat stegoImage = stego::toMat(stego::embedDCTParity(stego::toGrayView(coverImage), stego::binaryStringToBits(secretMessage), COEFF_U, COEFF_V, MODIFICATION_STEP, bitsEmbedded));
+    if (bitsEmbedded < secretMessage.length()) {
+        std::cerr << "警告：嵌入過程結束，但只嵌入了 " << bitsEmbedded << " 個位元 (可能有問題)。" << "\n";
+    }
     std::string stegoImagePath = "Result image/stego_image_dct.png";
     cv::imwrite(stegoImagePath, stegoImage);
 
     // --- 取出訊息 ---
-    std::string extractedMessage = extractDCT(stegoImage, secretMessage.length(), COEFF_U, COEFF_V);
+    std::string extractedMessage = stego::bitsToBinaryString(stego::extractDCTParity(stego::toGrayView(stegoImage), secretMessage.length(), COEFF_U, COEFF_V));
     std::cout << "取出的訊息: " << extractedMessage << "\n";
 
     // --- 驗證訊息 ---
@@ -210,7 +82,7 @@ int main (void) {
     }
 
 
-    double psnr = calculatePSNR(coverImage, stegoImage);
+    double psnr = stego::calculatePSNR(stego::toGrayView(coverImage), stego::toGrayView(stegoImage));
      if (psnr == std::numeric_limits<double>::infinity()) {
           std::cout << "PSNR: Infinity (影像完全相同)" << "\n";
      } else {
@@ -1,6 +1,9 @@
 #include <opencv2/opencv.hpp>
 #include <bits/stdc++.h>
 
+#include "stego/opencv.hpp"
+#include "stego/vq.hpp"
+
 // --- 參數設定 ---
 const int CODEBOOK_SIZE = 128;       // 目標碼書大小
 const int BLOCK_SIZE = 4;           // 影像區塊邊長 (4x4)
@@ -10,10 +13,8 @@ const int MAX_KMEANS_ITERATIONS = 100;// K-means 最大迭代次數
 const double SPLIT_PERTURBATION = 1.0; // 分裂時的擾動值
 
 // 從影像檔案載入訓練向量
-bool loadTrainingVectors(const std::vector<std::string>& imagePaths, int blockSize, std::vector<cv::Mat>& trainingVectors) {
+bool loadTrainingVectors(const std::vector<std::string>& imagePaths, int blockSize, std::vector<stego::VQVector>& trainingVectors) {
     trainingVectors.clear();
-    int vectorDim = blockSize * blockSize;
-
     for (const std::string& path : imagePaths) {
         cv::Mat img = cv::imread(path, cv::IMREAD_GRAYSCALE);
         if (img.empty()) {
@@ -42,151 +43,25 @@ bool loadTrainingVectors(const std::vector<std::string>& imagePaths, int blockSi
         }
 
 
-        // 提取區塊並轉換為向量
-        for (int r = 0; r < img.rows; r += blockSize) {
-            for (int c = 0; c < img.cols; c += blockSize) {
-                cv::Mat block = img(cv::Rect(c, r, blockSize, blockSize));
-                cv::Mat block_float;
-                block.convertTo(block_float, CV_32F); // 轉換為浮點數進行計算
-                // 將區塊攤平成 1xN 的向量 (N = vectorDim)
-                cv::Mat vector = block_float.reshape(1, 1);
-                trainingVectors.push_back(vector.clone()); // 加入 clone 以免指向 ROI
-            }
-        }
-        // std::cout << "已處理影像: " << path << "\n";
+        // 提取區塊並攤平成向量 (N = vectorDim)
+        std::vector<stego::VQVector> vectors = stego::extractBlockVectors(stego::toGrayView(img), blockSize);
+        trainingVectors.insert(trainingVectors.end(), vectors.begin(), vectors.end());
     }
     return !trainingVectors.empty(); // 如果至少有一個向量被提取，則返回 true
 }
 
-// 計算一組向量的質心 (平均向量)
-cv::Mat calculateCentroid(const std::vector<cv::Mat>& vectors) {
-    if (vectors.empty()) {
-        return cv::Mat(); // 返回空 Mat
-    }
-    // 假設所有向量維度相同，取第一個向量的維度
-    int vectorDim = vectors[0].cols;
-    int numVectors = vectors.size();
-
-    // 初始化總和向量為零
-    cv::Mat sumVector = cv::Mat::zeros(1, vectorDim, CV_32F);
-
-    // 累加所有向量
-    for (const cv::Mat& vec : vectors) {
-        // 確保維度一致 (可以增加錯誤檢查)
-        if (vec.cols == vectorDim && vec.rows == 1 && vec.type() == CV_32F) {
-             sumVector += vec;
-        } else {
-            std::cerr << "向量維度或類型不符，已跳過。" << "\n";
-        }
+// 碼書轉成 1xN CV_32F 的 cv::Mat 列表 (儲存與視覺化使用)
+std::vector<cv::Mat> toMatCodebook(const std::vector<stego::VQVector>& codebook) {
+    std::vector<cv::Mat> mats;
+    for (const stego::VQVector& codeword : codebook) {
+        cv::Mat m(1, static_cast<int>(codeword.size()), CV_32F);
+        for (int i = 0; i < m.cols; ++i) m.at<float>(0, i) = static_cast<float>(codeword[i]);
+        mats.push_back(m);
     }
-
-    // 計算平均值
-    cv::Mat centroid = sumVector / static_cast<double>(numVectors);
-    return centroid;
+    return mats;
 }
 
-// LBG 演算法主體
-std::vector<cv::Mat> trainLBG(const std::vector<cv::Mat>& trainingVectors, int targetCodebookSize, int vectorDim, double epsilon, int maxIterations, double perturbation) {
-    if (trainingVectors.empty()) {
-        return {}; // 返回空碼書
-    }
-
-    // --- 1. 初始化碼書 (大小為 1) ---
-    std::vector<cv::Mat> codebook;
-    codebook.push_back(calculateCentroid(trainingVectors)); // 初始碼向量是所有訓練資料的平均值
-    std::cout << "  初始碼書大小: 1" << "\n";
-
-    double lastAvgDistortion = std::numeric_limits<double>::max();
-
-    // --- 2. 迭代增長碼書 ---
-    while (codebook.size() < targetCodebookSize) {
-        // --- 2a. 分裂碼書 ---
-        std::vector<cv::Mat> newCodebook;
-        cv::Mat perturbationVector = cv::Mat::ones(1, vectorDim, CV_32F) * perturbation; // 建立擾動向量
-        perturbationVector.at<float>(0,0) += 0.1; // 稍微打破對稱性
-
-        std::cout << "  分裂碼書從 " << codebook.size() << " 到 ";
-        for (const cv::Mat& codeword : codebook) {
-            if (newCodebook.size() < targetCodebookSize) {
-                newCodebook.push_back(codeword + perturbationVector);
-            }
-            if (newCodebook.size() < targetCodebookSize) {
-                 newCodebook.push_back(codeword - perturbationVector);
-            }
-        }
-        codebook = newCodebook;
-        std::cout << codebook.size() << "..." << "\n";
-
-
-        // --- 2b. K-means 迭代優化當前碼書 ---
-        std::cout << "    執行 K-means 優化 (目標大小 " << codebook.size() << "):" << "\n";
-        for (int iter = 0; iter < maxIterations; ++iter) {
-            // -- 分配步驟 --
-            std::vector<std::vector<int>> clusters(codebook.size()); // 儲存每個聚類包含的訓練向量索引
-            double currentTotalDistortion = 0.0;
-
-            for (int i = 0; i < trainingVectors.size(); ++i) {
-                double minDistSq = std::numeric_limits<double>::max();
-                int nearestCodewordIndex = -1;
-
-                // 找到最近的碼向量
-                for (int k = 0; k < codebook.size(); ++k) {
-                    // 使用平方歐氏距離以提高效率
-                    double distSq = cv::norm(trainingVectors[i], codebook[k], cv::NORM_L2SQR);
-                    if (distSq < minDistSq) {
-                        minDistSq = distSq;
-                        nearestCodewordIndex = k;
-                    }
-                }
-
-                if (nearestCodewordIndex != -1) {
-                    clusters[nearestCodewordIndex].push_back(i);
-                    currentTotalDistortion += minDistSq;
-                }
-            }
-
-            // -- 更新步驟 --
-            int emptyClusters = 0;
-            for (int k = 0; k < codebook.size(); ++k) {
-                if (!clusters[k].empty()) {
-                    // 計算新質心
-                    std::vector<cv::Mat> clusterVectors;
-                    for (int index : clusters[k]) {
-                        clusterVectors.push_back(trainingVectors[index]);
-                    }
-                    codebook[k] = calculateCentroid(clusterVectors);
-                } else {
-                    emptyClusters++;
-                }
-            }
-             if (emptyClusters > 0) {
-                 std::cerr << "    警告：K-means 迭代 " << iter << " 發現 " << emptyClusters << " 個空聚類！" << "\n";
-             }
-
-
-            // -- 檢查收斂 --
-            double avgDistortion = currentTotalDistortion / trainingVectors.size();
-            double distortionChange = std::abs(lastAvgDistortion - avgDistortion);
-
-            std::cout << "      迭代 " << iter << ": 平均失真 = " << avgDistortion
-                      << ", 變化 = " << distortionChange << "\n";
-
-            // 使用相對變化量判斷收斂
-            if (lastAvgDistortion != 0 && (distortionChange / lastAvgDistortion) < epsilon) {
-                 std::cout << "    K-means 收斂於迭代 " << iter << "\n";
-                break; // 收斂，跳出 K-means 迭代
-            }
-            lastAvgDistortion = avgDistortion;
-
-            if (iter == maxIterations - 1) {
-                std::cout << "    達到最大 K-means 迭代次數。" << "\n";
-            }
-        } // K-means 迭代結束
-         lastAvgDistortion = std::numeric_limits<double>::max(); // 重置失真，準備下一次分裂後的 K-means
-    } // 碼書增長迴圈結束
-
-    return codebook;
-}
+// LBG 碼書訓練 (分裂 + K-means) 由 stego_core 實作: stego::trainLBG
 
 // 將碼書儲存到檔案 (使用 OpenCV FileStorage)
 bool saveCodebook(const std::string& filename, const std::vector<cv::Mat>& codebook) {
@@ -298,7 +173,7 @@ int main (void) {
     std::cout << "使用的訓練影像數量: " << imagePaths.size() << "\n";
 
     // --- 載入訓練向量 ---
-    std::vector<cv::Mat> trainingVectors;
+    std::vector<stego::VQVector> trainingVectors;
     if (!loadTrainingVectors(imagePaths, BLOCK_SIZE, trainingVectors)) {
         std::cerr << "載入訓練向量失敗。" << "\n";
         return -1;
@@ -311,7 +186,7 @@ int main (void) {
 
     // --- 執行 LBG 演算法訓練碼書 ---
     std::cout << "開始訓練 LBG 碼書..." << "\n";
-    std::vector<cv::Mat> codebook = trainLBG(trainingVectors, CODEBOOK_SIZE, VECTOR_DIM, KMEANS_EPSILON, MAX_KMEANS_ITERATIONS, SPLIT_PERTURBATION);
+    std::vector<cv::Mat> codebook = toMatCodebook(stego::trainLBG(trainingVectors, CODEBOOK_SIZE, KMEANS_EPSILON, MAX_KMEANS_ITERATIONS, SPLIT_PERTURBATION, &std::cout));
     std::cout << "LBG 訓練完成，最終碼書大小: " << codebook.size() << "\n";
 
     // --- 儲存碼書 ---
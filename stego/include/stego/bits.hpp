@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "stego/bitstream.hpp"
+
+namespace stego {
+
+// 將字串轉換成位元序列 (每個字元由最高位元到最低位元，不含結束符)
+BitBuffer stringToBits (const std::string& s);
+
+// 將位元序列轉換回字串，遇到 '\0' 即停止
+std::string bitsToString (const BitBuffer& bits);
+
+// 將位元序列依每 8 位元轉回字串，不檢查結束符 (可含 '\0' 的二進位資料)
+std::string bitsToRawString (const BitBuffer& bits);
+
+// 將 "0101..." 形式的字串轉成位元序列 (MidTerm 題目使用的訊息格式)
+BitBuffer binaryStringToBits (const std::string& s);
+
+// 將位元序列轉成 "0101..." 形式的字串
+std::string bitsToBinaryString (const BitBuffer& bits);
+
+// 將整數的低 numBits 個位元轉成位元序列 (最高位元在前)
+BitBuffer intToBits (std::uint32_t n, int numBits = 32);
+
+// 將位元序列的前 numBits 個位元組合成整數 (最高位元在前)
+std::uint32_t bitsToInt (const BitBuffer& bits, int numBits = 32);
+
+}  // namespace stego
@@ -0,0 +1,244 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace stego {
+
+// --- 打包位元序列 ---
+// 位元以「最高位元在前 (MSB-first)」的順序打包成位元組：第 i 個位元位於 bytes[i / 8] 的第 (7 - i % 8) 位
+// 因此字串負載打包後的位元組就是字串本身，byte 對齊的讀寫可以直接 memcpy
+
+namespace detail {
+
+inline std::uint64_t lowMask (int n) { return n >= 64 ? ~0ULL : ((1ULL << n) - 1); }
+
+// 由 p 讀取最多 8 個位元組並以大端序組成 64 位元整數 (不足的部分補 0)
+inline std::uint64_t loadBE64 (const std::uint8_t* p, std::size_t avail) {
+    std::uint64_t v = 0;
+    if (avail >= 8) {
+        std::memcpy(&v, p, 8);
+        return __builtin_bswap64(v);
+    }
+    for (std::size_t i = 0; i < 8; ++i) v = (v << 8) | (i < avail ? p[i] : 0);
+    return v;
+}
+
+}  // namespace detail
+
+class BitBuffer {
+public:
+    BitBuffer () = default;
+    BitBuffer (std::vector<std::uint8_t> bytes, std::size_t numBits) : bytes_(std::move(bytes)), size_(numBits) {
+        bytes_.resize((numBits + 7) >> 3);
+        if (numBits & 7) bytes_.back() &= static_cast<std::uint8_t>(0xFF00u >> (numBits & 7));  // 尾端未用的位元保持為 0
+    }
+
+    // 直接以位元組內容建立 (字串負載使用，不需要逐位元轉換)
+    static BitBuffer fromBytes (const void* data, std::size_t numBytes) {
+        const auto* p = static_cast<const std::uint8_t*>(data);
+        return BitBuffer(std::vector<std::uint8_t>(p, p + numBytes), numBytes << 3);
+    }
+
+    std::size_t size () const { return size_; }
+    bool empty () const { return size_ == 0; }
+    std::size_t byteSize () const { return bytes_.size(); }
+    const std::uint8_t* data () const { return bytes_.data(); }
+    const std::vector<std::uint8_t>& bytes () const { return bytes_; }
+
+    bool operator[] (std::size_t i) const { return (bytes_[i >> 3] >> (7 - (i & 7))) & 1; }
+
+    void set (std::size_t i, bool b) {
+        std::uint8_t m = static_cast<std::uint8_t>(0x80u >> (i & 7));
+        bytes_[i >> 3] = b ? (bytes_[i >> 3] | m) : (bytes_[i >> 3] & ~m);
+    }
+
+    // 從第 pos 個位元開始讀取 n (0..64) 個位元，結果靠右對齊；超出範圍的位元視為 0
+    std::uint64_t read (std::size_t pos, int n) const {
+        if (n <= 0) return 0;
+        const std::size_t byte = pos >> 3;
+        const int off = static_cast<int>(pos & 7);
+        const std::size_t avail = byte < bytes_.size() ? bytes_.size() - byte : 0;
+        std::uint64_t hi = detail::loadBE64(bytes_.data() + byte, avail);
+        if (off + n <= 64) return (hi << off) >> (64 - n);
+        // 需要第 9 個位元組
+        std::uint64_t extra = avail > 8 ? bytes_[byte + 8] : 0;
+        hi = (hi << off) | (extra >> (8 - off));
+        return hi >> (64 - n);
+    }
+
+    // 截斷或以 0 延長到 numBits
+    void resize (std::size_t numBits) {
+        bytes_.resize((numBits + 7) >> 3, 0);
+        if (numBits < size_ && (numBits & 7)) bytes_.back() &= static_cast<std::uint8_t>(0xFF00u >> (numBits & 7));
+        size_ = numBits;
+    }
+
+    bool operator== (const BitBuffer& other) const {
+        if (size_ != other.size_) return false;
+        const std::size_t full = size_ >> 3;
+        if (std::memcmp(bytes_.data(), other.bytes_.data(), full) != 0) return false;
+        const int rest = static_cast<int>(size_ & 7);
+        if (!rest) return true;
+        const std::uint8_t m = static_cast<std::uint8_t>(0xFF00u >> rest);
+        return (bytes_[full] & m) == (other.bytes_[full] & m);
+    }
+    bool operator!= (const BitBuffer& other) const { return !(*this == other); }
+
+private:
+    friend class BitWriter;
+    std::vector<std::uint8_t> bytes_;
+    std::size_t size_ = 0;
+};
+
+// 逐段寫入位元，內部以 64 位元累加器減少對 vector 的存取
+class BitWriter {
+public:
+    BitWriter () = default;
+    explicit BitWriter (std::size_t reserveBits) { buf_.bytes_.reserve((reserveBits + 7) >> 3); }
+
+    std::size_t size () const { return buf_.size_ + accBits_; }
+
+    void put (bool b) {
+        acc_ |= static_cast<std::uint64_t>(b) << (63 - accBits_);
+        if (++accBits_ == 64) flushWord();
+    }
+
+    // 寫入 value 的低 n (0..64) 個位元，最高位元先寫
+    void write (std::uint64_t value, int n) {
+        if (n <= 0) return;
+        value &= detail::lowMask(n);
+        const int space = 64 - accBits_;
+        if (n < space) {
+            acc_ |= value << (space - n);
+            accBits_ += n;
+            return;
+        }
+        // 先填滿累加器，再把剩下的位元放到新的累加器
+        const int rest = n - space;
+        acc_ |= value >> rest;
+        accBits_ = 64;
+        flushWord();
+        if (rest) {
+            acc_ = value << (64 - rest);
+            accBits_ = rest;
+        }
+    }
+
+    // 寫入整段位元組；目前位置 byte 對齊時直接複製
+    void writeBytes (const void* data, std::size_t numBytes) {
+        const auto* p = static_cast<const std::uint8_t*>(data);
+        if ((accBits_ & 7) == 0) {
+            flushBytes();
+            buf_.bytes_.insert(buf_.bytes_.end(), p, p + numBytes);
+            buf_.size_ += numBytes << 3;
+            return;
+        }
+        std::size_t i = 0;
+        for (; i + 8 <= numBytes; i += 8) write(detail::loadBE64(p + i, 8), 64);
+        for (; i < numBytes; ++i) write(p[i], 8);
+    }
+
+    // 在結尾預留 numBytes 個可直接寫入的位元組 (目前位置必須對齊 byte)，供批次核心直接輸出
+    std::uint8_t* appendBytes (std::size_t numBytes) {
+        flushBytes();
+        const std::size_t old = buf_.bytes_.size();
+        buf_.bytes_.resize(old + numBytes);
+        buf_.size_ += numBytes << 3;
+        return buf_.bytes_.data() + old;
+    }
+
+    void writeBits (const BitBuffer& bits) {
+        const std::size_t full = bits.size() >> 3;
+        writeBytes(bits.data(), full);
+        write(bits.read(full << 3, static_cast<int>(bits.size() & 7)), static_cast<int>(bits.size() & 7));
+    }
+
+    // 最後一個完整位元組 (size() 為 8 的倍數時用於檢查結束符)
+    std::uint8_t lastByte () const {
+        if (accBits_ >= 8) return static_cast<std::uint8_t>(acc_ >> (64 - (accBits_ & ~7)));
+        return buf_.bytes_.empty() ? 0 : buf_.bytes_.back();
+    }
+
+    // 取出結果並重置 writer
+    BitBuffer take () {
+        flushBytes();
+        if (accBits_) {
+            buf_.bytes_.push_back(static_cast<std::uint8_t>(acc_ >> 56));
+            buf_.size_ += accBits_;
+            acc_ = 0;
+            accBits_ = 0;
+        }
+        BitBuffer out = std::move(buf_);
+        buf_ = BitBuffer();
+        return out;
+    }
+
+private:
+    void flushWord () {
+        std::uint64_t be = __builtin_bswap64(acc_);
+        const auto* p = reinterpret_cast<const std::uint8_t*>(&be);
+        buf_.bytes_.insert(buf_.bytes_.end(), p, p + 8);
+        buf_.size_ += 64;
+        acc_ = 0;
+        accBits_ = 0;
+    }
+
+    // 將累加器中完整的位元組寫出
+    void flushBytes () {
+        while (accBits_ >= 8) {
+            buf_.bytes_.push_back(static_cast<std::uint8_t>(acc_ >> 56));
+            acc_ <<= 8;
+            accBits_ -= 8;
+            buf_.size_ += 8;
+        }
+    }
+
+    BitBuffer buf_;
+    std::uint64_t acc_ = 0;
+    int accBits_ = 0;
+};
+
+// 依序讀取位元
+class BitReader {
+public:
+    explicit BitReader (const BitBuffer& bits) : bits_(&bits) {}
+
+    std::size_t position () const { return pos_; }
+    std::size_t remaining () const { return pos_ < bits_->size() ? bits_->size() - pos_ : 0; }
+    bool done () const { return pos_ >= bits_->size(); }
+
+    bool get () { return (*bits_)[pos_++]; }
+
+    // 讀取 n (0..64) 個位元，超過結尾的部分為 0
+    std::uint64_t read (int n) {
+        std::uint64_t v = bits_->read(pos_, n);
+        pos_ += n;
+        return v;
+    }
+
+    // 讀取整段位元組；目前位置 byte 對齊時直接複製
+    void readBytes (void* out, std::size_t numBytes) {
+        auto* o = static_cast<std::uint8_t*>(out);
+        if ((pos_ & 7) == 0) {
+            const std::size_t byte = pos_ >> 3;
+            const std::size_t avail = byte < bits_->byteSize() ? std::min(numBytes, bits_->byteSize() - byte) : 0;
+            std::memcpy(o, bits_->data() + byte, avail);
+            std::memset(o + avail, 0, numBytes - avail);
+        } else {
+            for (std::size_t i = 0; i < numBytes; ++i) o[i] = static_cast<std::uint8_t>(bits_->read(pos_ + (i << 3), 8));
+        }
+        pos_ += numBytes << 3;
+    }
+
+    void skip (std::size_t n) { pos_ += n; }
+
+private:
+    const BitBuffer* bits_;
+    std::size_t pos_ = 0;
+};
+
+}  // namespace stego
@@ -0,0 +1,11 @@
+#pragma once
+
+#include "stego/image.hpp"
+
+namespace stego {
+
+// 簡易流加密/解密：以 key 為 PRNG 種子產生位元組流，並與像素進行 XOR
+// 加密和解密使用完全相同的函數和密鑰
+Image<std::uint8_t> encryptDecryptStream (ConstGrayView input, unsigned int key);
+
+}  // namespace stego
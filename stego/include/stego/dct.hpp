@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#include "stego/bitstream.hpp"
+#include "stego/frame.hpp"
+#include "stego/image.hpp"
+#include "stego/stream.hpp"
+
+namespace stego {
+
+constexpr int DCT_BLOCK = 8;
+
+// ZigZag 掃描順序中前 20 個 DCT 係數的 (row, col) (用於選擇嵌入位置，跳過 DC)
+extern const int ZIGZAG_ID[20][2];
+
+// 8x8 正交 DCT-II 及其反轉換，正規化方式與 cv::dct / cv::idct 相同
+// step 以元素為單位，src 與 dst 可以是同一塊記憶體
+void forwardDCT8x8 (const float* src, std::ptrdiff_t srcStep, float* dst, std::ptrdiff_t dstStep);
+void inverseDCT8x8 (const float* src, std::ptrdiff_t srcStep, float* dst, std::ptrdiff_t dstStep);
+
+// 批次版本：一次轉換水平相鄰的 blocks 個 8x8 區塊 (一條 8 列高的區塊帶)
+// 使用 AAN 分解，支援 AVX 的 CPU 以向量指令處理，純量與向量路徑結果逐位元相同
+// 係數留在各區塊原本的位置，src 與 dst 可以是同一塊記憶體
+void forwardDCTStrip (const float* src, std::ptrdiff_t srcStep, float* dst, std::ptrdiff_t dstStep, int blocks);
+void inverseDCTStrip (const float* src, std::ptrdiff_t srcStep, float* dst, std::ptrdiff_t dstStep, int blocks);
+
+// 以邊界複製方式將灰階影像補到 rows x cols 並轉成浮點數 (對應 copyMakeBorder + convertTo)
+Image<float> padReplicateToFloat (ConstGrayView src, int rows, int cols);
+
+// 浮點影像四捨五入並截斷到 [0, 255] (對應 convertTo(CV_8U))
+Image<std::uint8_t> floatToU8 (ImageView<const float> src);
+
+// --- Ch10_2: 8x8 區塊 ZigZag 係數 LSB 偽裝 ---
+// 將 cover 補邊到 8 的倍數後，在每個區塊 ZigZag 順序前 coeffsPerBlock 個係數的整數 LSB 嵌入位元
+// 回傳補邊後的浮點隱寫影像 (係數 LSB 在轉成 8 位元後不一定能保留)
+// 只有攜帶位元的區塊會經過 DCT/IDCT，各條 8 列區塊帶分給執行緒池 (threads <= 0 時使用全部執行緒)
+Image<float> embedDCTZigZag (ConstGrayView cover, const BitBuffer& bits, int coeffsPerBlock, std::size_t& bitsEmbedded, int threads = 0);
+
+// 依序取出 numBits 個位元
+BitBuffer extractDCTZigZag (ImageView<const float> stego, int coeffsPerBlock, std::size_t numBits);
+
+// 串流提取：逐位元組交給 sink，sink 回傳 false 後不再轉換剩下的區塊
+void streamDCTZigZag (ImageView<const float> stego, int coeffsPerBlock, const ByteSink& sink);
+
+// 字串訊息 (含框架標頭) 版本，訊息過長無法框架化時回傳空影像；提取時框架無效回傳空字串
+Image<float> embedMessageDCTZigZag (ConstGrayView cover, const std::string& msg, int coeffsPerBlock = 10, int threads = 1);
+std::string extractMessageDCTZigZag (ImageView<const float> stego, int coeffsPerBlock = 10, FrameStatus* status = nullptr);
+
+// --- MidTerm/Q2: 單一係數 (u, v) 奇偶性偽裝，每個 8x8 區塊 1 位元 ---
+// 同樣只轉換前 numBits 個區塊，其餘像素直接複製；輸出與執行緒數無關
+Image<std::uint8_t> embedDCTParity (ConstGrayView cover, const BitBuffer& bits, int u, int v, float step, std::size_t& bitsEmbedded, int threads = 0);
+BitBuffer extractDCTParity (ConstGrayView stego, std::size_t numBits, int u, int v, int threads = 0);
+
+}  // namespace stego
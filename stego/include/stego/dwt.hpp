@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+#include "stego/image.hpp"
+#include "stego/iwt.hpp"
+
+namespace stego {
+
+// --- 浮點 Haar DWT (多層) ---
+// 每一層一次讀入一對列，2x2 區塊的列、行轉換在暫存器內完成後直接寫出四個子帶 (單次掃描，不需要中間影像)
+// 支援 AVX2 的 CPU 一次處理 8 個區塊，純量與向量路徑的運算順序相同，結果逐位元一致
+// 係數排列與 forwardIWT 相同 (左上 LL、右上 HL、左下 LH、右下 HH)，可用 subband() 取出各層子帶
+
+enum class HaarScaling : std::uint8_t {
+    Orthonormal = 0,  // (a ± b) / √2，能量守恆 (hw3 Haar2D)
+    Average = 1,      // (a ± b) / 2，LL 維持像素值範圍 (Additional/Q1 haar_dwt_2d)
+};
+
+// src 與 dst 尺寸相同且不能重疊；rows、cols 必須能被 2^levels 整除，否則回傳 false
+// 第 2 層以後的 LL 在兩塊 1/4、1/16 大小的暫存之間交替，不另外配置整張影像
+bool forwardHaarDWT (ImageView<const float> src, ImageView<float> dst, int levels = 1, HaarScaling scaling = HaarScaling::Orthonormal);
+bool inverseHaarDWT (ImageView<const float> src, ImageView<float> dst, int levels = 1, HaarScaling scaling = HaarScaling::Orthonormal);
+
+// --- 逐列 (line-based) 多層 Haar DWT，處理放不進記憶體的大影像 ---
+// 來源逐列讀入，每層只保留一列等待配對，湊成一對就立刻輸出該層的 HL/LH/HH 各一列，LL 列再送往下一層
+// 記憶體用量約 6 * cols 個 float，與影像高度無關；各子帶的係數與 forwardHaarDWT 逐位元相同
+
+// 把第 r 列 (cols 個像素) 寫到 out，失敗時回傳 false
+using GrayRowSource = std::function<bool(int r, std::uint8_t* out)>;
+
+// 第 level 層 band 子帶的第 row 列 (width 個係數)，每個子帶的列依序送出
+// LL 預設只輸出最後一層；everyLevelLL 為 true 時各層的 LL 列也會送出 (每層另外 1/4 的輸出量)
+// 回傳 false 時停止
+using SubbandRowSink = std::function<bool(int level, Subband band, int row, const float* data, int width)>;
+
+// rows、cols 不是 2^levels 的倍數時，最後不足的列與行略過；來源或 sink 失敗時回傳 false
+bool streamHaarDWT (int rows, int cols, const GrayRowSource& source, const SubbandRowSink& sink,
+                    int levels = 1, HaarScaling scaling = HaarScaling::Orthonormal, bool everyLevelLL = false);
+
+}  // namespace stego
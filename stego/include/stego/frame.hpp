@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "stego/bitstream.hpp"
+#include "stego/stream.hpp"
+
+namespace stego {
+
+// --- 負載框架 ---
+// 所有嵌入器共用的 16 位元組標頭 (大端序)，取代 '\0' 結束符:
+//   [0..3]   magic "STGF"
+//   [4]      版本
+//   [5]      演算法 (FrameAlgorithm)
+//   [6..7]   演算法參數 (LSB 的 k、DCT 每區塊係數數、HS 峰點...)
+//   [8..11]  負載位元數
+//   [12..15] 負載的 CRC32C (尾端不足一個位元組的部分補 0)
+// 提取端讀完標頭就知道確切的位元數，並能在讀到錯誤的 magic / 參數時立即放棄
+constexpr std::uint32_t FRAME_MAGIC = 0x53544746;  // "STGF"
+constexpr std::uint8_t FRAME_VERSION = 1;
+constexpr int FRAME_HEADER_BYTES = 16;
+constexpr int FRAME_HEADER_BITS = FRAME_HEADER_BYTES * 8;
+
+enum class FrameAlgorithm : std::uint8_t {
+    LSB = 1,
+    FixedLSB = 2,
+    AdaptiveLSB = 3,
+    DCTZigZag = 4,
+    HistogramShift = 5,
+    IWTHistogramShift = 6,
+    JPEGZigZag = 7,
+    MultiHistogramShift = 8,
+    PredictionErrorExpansion = 9,
+    BlindIWTHistogramShift = 10,
+};
+
+enum class FrameStatus {
+    Ok,
+    Incomplete,    // 資料在框架結束前就用完
+    BadMagic,
+    BadVersion,
+    BadParameters, // 演算法或參數與提取端不符
+    TooLong,       // 標頭記錄的長度超過載體容量
+    BadChecksum,
+};
+
+struct FrameHeader {
+    FrameAlgorithm algorithm = FrameAlgorithm::LSB;
+    std::uint16_t param = 0;
+    std::uint32_t payloadBits = 0;
+    std::uint32_t crc = 0;
+};
+
+// CRC32C (Castagnoli)，支援 SSE4.2 的 CPU 使用硬體指令
+std::uint32_t crc32c (const void* data, std::size_t size, std::uint32_t crc = 0);
+
+// 只產生標頭 (FRAME_HEADER_BITS 個位元)；負載超過 2^32 - 1 個位元時回傳空的 BitBuffer
+BitBuffer frameHeader (const BitBuffer& payload, FrameAlgorithm algorithm, std::uint16_t param);
+
+// 標頭 + 負載；負載過長時同樣回傳空的 BitBuffer (合法的框架至少有標頭，不會是空的)
+BitBuffer frame (const BitBuffer& payload, FrameAlgorithm algorithm, std::uint16_t param);
+
+// 解析並檢查標頭 (header 至少 FRAME_HEADER_BYTES 個位元組)
+FrameStatus parseFrameHeader (const std::uint8_t* header, FrameAlgorithm algorithm, std::uint16_t param, std::size_t maxPayloadBits, FrameHeader& out);
+
+// 檢查負載長度與 CRC
+FrameStatus verifyFramePayload (const FrameHeader& header, const BitBuffer& payload);
+
+// 逐位元組解析框架，可直接接在串流提取器後面
+// 標頭有誤或負載收齊後 sink 回傳 false，提取器就不會再讀取像素
+class FrameReader {
+public:
+    FrameReader (FrameAlgorithm algorithm, std::uint16_t param, std::size_t maxPayloadBits);
+
+    bool push (std::uint8_t byte);
+    ByteSink sink () {
+        return [this](std::uint8_t b) { return push(b); };
+    }
+
+    FrameStatus status () const { return status_; }
+    const FrameHeader& header () const { return header_; }
+    BitBuffer take () { return std::move(payload_); }
+
+    // 取出字串訊息；框架無效時回傳空字串，status 不為 nullptr 時回傳解析結果
+    std::string takeMessage (FrameStatus* status = nullptr);
+
+private:
+    FrameAlgorithm algorithm_;
+    std::uint16_t param_;
+    std::size_t maxPayloadBits_;
+    std::uint8_t headerBytes_[FRAME_HEADER_BYTES] = {};
+    std::size_t received_ = 0;
+    std::size_t payloadBytes_ = 0;
+    FrameHeader header_;
+    BitWriter writer_;
+    BitBuffer payload_;
+    FrameStatus status_ = FrameStatus::Incomplete;
+};
+
+// 字串訊息框架化 (訊息可包含 '\0')；超過 2^29 - 1 個位元組時回傳空的 BitBuffer
+BitBuffer frameMessage (const std::string& message, FrameAlgorithm algorithm, std::uint16_t param);
+
+}  // namespace stego
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+
+#include "stego/image.hpp"
+
+namespace stego {
+
+// --- Floyd-Steinberg 誤差擴散 (半色調) ---
+// 像素值 > 127 輸出 255，否則輸出 0；量化誤差以 7/16 (右)、3/16 (左下)、5/16 (下)、1/16 (右下) 擴散
+// 誤差以 float 累加，運算式與加總順序和 Ch09_2 / Final Demo 1 原本的逐點迴圈相同
+//
+// 平行版本以波前 (wavefront) 排程：執行緒依序認領列，每列記錄已完成的像素數，
+// 第 i 列處理第 j 個像素前，第 i - 1 列必須已完成到第 j + 2 個像素 (領先至少 2 個像素)，
+// 因此每個像素收到的誤差與加總順序都和依序執行相同，結果逐位元一致
+
+// src 與 dst 尺寸相同的單通道影像 (可以是同一張)，否則回傳 false
+// threads == 1 或影像太小時依序執行
+bool floydSteinberg (ConstGrayView src, GrayView dst, int threads = 0);
+
+// --- 定點整數誤差擴散 ---
+// 不轉成 float 影像：誤差以 int16 保存「誤差 x 權重」的累加值 (分子)，只保留濾波器高度那幾列 (FS 2 列，其餘 3 列)，
+// 讀到像素時才除以總權重 (四捨五入)；|誤差| <= 255 且權重和不超過分母，累加值不會超出 int16
+// 各濾波器的係數是編譯期常數，擴散迴圈在模板內完全展開
+enum class DiffusionFilter : std::uint8_t {
+    FloydSteinberg = 0,     // 7 / 3 5 1，分母 16
+    JarvisJudiceNinke = 1,  // 右側 2 個與下方兩列各 5 個鄰點，分母 48
+    Stucki = 2,             // JJN 的形狀，權重為 2 的冪次，分母 42
+    Atkinson = 3,           // 六個鄰點各 1/8，只擴散 3/4 的誤差 (亮、暗部對比較高)
+};
+
+// serpentine 為 true 時奇數列由右往左掃描 (濾波器左右翻轉)，減少規則的紋路
+// src 與 dst 尺寸相同的單通道影像 (可以是同一張)，否則回傳 false
+bool errorDiffusion (ConstGrayView src, GrayView dst, DiffusionFilter filter = DiffusionFilter::FloydSteinberg, bool serpentine = false);
+
+// --- 有序抖色 (ordered dithering) ---
+// 每個像素只和平鋪的門檻矩陣比較 (大於門檻輸出 255，否則 0)，像素之間沒有相依，
+// 可依列切段平行處理，支援 AVX2 的 CPU 一次比較 32 個像素；畫質不如誤差擴散，適合大量預覽
+enum class ThresholdMatrix : std::uint8_t {
+    Bayer4 = 0,       // 4x4 Bayer，17 個灰階
+    Bayer8 = 1,       // 8x8 Bayer，65 個灰階
+    BlueNoise64 = 2,  // 64x64 藍噪聲 (void-and-cluster 產生，第一次使用時計算並快取)，沒有 Bayer 的十字紋路
+};
+
+// src 與 dst 尺寸相同的單通道影像 (可以是同一張)，否則回傳 false；輸出與執行緒數無關
+bool orderedDither (ConstGrayView src, GrayView dst, ThresholdMatrix matrix = ThresholdMatrix::Bayer8, int threads = 0);
+
+}  // namespace stego
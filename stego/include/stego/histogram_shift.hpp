@@ -0,0 +1,91 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "stego/bitstream.hpp"
+#include "stego/frame.hpp"
+#include "stego/image.hpp"
+#include "stego/stream.hpp"
+
+namespace stego {
+
+// --- 空間域: 直方圖平移 (Histogram Shifting) RDH ---
+
+// 灰度直方圖 (0-255)，以灰度值直接索引
+using Histogram = std::array<std::uint32_t, 256>;
+
+// 計算灰度直方圖 (0-255)
+// 以下的 threads 參數: 依列切段交給執行緒池 (threads <= 0 時使用全部執行緒)，結果與單執行緒相同
+Histogram calculateHistogram (ConstGrayView grayImage, int threads = 0);
+
+// 尋找直方圖峰點 (像素最多的灰度值)，確保 P <= 254 以便 P+1 仍有效；找不到回傳 -1
+int findPeakBin (const Histogram& histogram);
+
+// 峰點 P 可嵌入的位元數
+int capacityHistogramShifting (ConstGrayView grayImage, int peakBin);
+
+// 峰點右側 (P, 255] 中像素最少的灰度值 (相同時取最靠近 P 者)；peakBin 無效時回傳 -1
+int findZeroBin (const Histogram& histogram, int peakBin);
+
+// 單組 (峰點 P, 零點 Z > P) 平移的提取與還原資訊
+// 零點不是空的 (例如影像含有灰度 255 且沒有空的灰度值) 時，原本位於 Z 的像素位置記錄在溢位表中，
+// 格式與多組版本的 MultiHSKey 相同
+struct HSKey {
+    std::uint8_t peak = 0;
+    std::uint8_t zero = 0;
+    std::size_t overflowCount = 0;
+    std::vector<std::uint8_t> overflowMap;  // 溢位像素的索引 (列優先) 差分後以 LEB128 編碼
+};
+
+// 嵌入位元：P < G < Z 的像素 +1，G == P 的像素依位元變為 P 或 P+1，G == Z 的像素不變並記錄位置
+// 平移以 SSE2 一次處理 16 個像素，只有峰點像素逐一處理
+// key 回傳提取時需要的資訊；容量不足或找不到峰點時回傳 false
+bool embedHistogramShifting (ConstGrayView grayImage, const BitBuffer& bits, Image<std::uint8_t>& stego, HSKey& key, int threads = 0);
+
+// 提取所有峰點位元並還原影像；key 無效時回傳空的結果
+BitBuffer extractAndRestoreHistogramShifting (ConstGrayView stego, const HSKey& key, Image<std::uint8_t>& restored, int threads = 0);
+
+// 串流提取：逐位元組交給 sink，sink 回傳 false 即停止走訪 (不還原影像)
+void streamHistogramShifting (ConstGrayView stego, const HSKey& key, const ByteSink& sink);
+
+// 只還原影像 (逐像素比較，不收集位元)
+Image<std::uint8_t> restoreHistogramShifting (ConstGrayView stego, const HSKey& key, int threads = 0);
+
+// 字串訊息 (含框架標頭) 版本，框架無效時回傳空字串 (影像仍會還原)
+bool embedMessageHistogramShifting (ConstGrayView grayImage, const std::string& message, Image<std::uint8_t>& stego, HSKey& key, int threads = 1);
+std::string extractMessageHistogramShifting (ConstGrayView stego, const HSKey& key, Image<std::uint8_t>& restored, FrameStatus* status = nullptr, int threads = 1);
+
+// --- 多組 (峰點, 零點) 直方圖平移 ---
+// 每組 (P, Z) 只平移 P 與 Z 之間的像素 (往 Z 的方向 1 格)，P 依位元變為 P 或 P±1
+// 各組的區間 [min(P,Z), max(P,Z)] 互不重疊，因此所有組可以在同一次走訪中以查表完成，容量為各峰點像素數總和
+// 零點不是空的時，原本位於 Z 的像素會和平移過來的像素重疊，其位置記錄在溢位位置表中，還原時保持原值
+struct HSPair {
+    std::uint8_t peak = 0;
+    std::uint8_t zero = 0;
+};
+
+// 提取與還原所需的資訊
+struct MultiHSKey {
+    std::vector<HSPair> pairs;
+    std::size_t overflowCount = 0;
+    std::vector<std::uint8_t> overflowMap;  // 溢位像素的索引 (列優先) 差分後以 LEB128 編碼
+};
+
+// 依峰點像素數由大到小挑選最多 maxPairs 組互不重疊的 (P, Z)，零點取可用範圍內像素最少的灰度值
+// 總容量達到 bitsNeeded 就停止
+std::vector<HSPair> selectHSPairs (const Histogram& histogram, int maxPairs, std::size_t bitsNeeded = static_cast<std::size_t>(-1));
+
+// 多組嵌入，影像只走訪一次 (另加一次直方圖)；容量不足時回傳 false
+bool embedMultiHistogramShifting (ConstGrayView grayImage, const BitBuffer& bits, Image<std::uint8_t>& stego, MultiHSKey& key, int maxPairs = 8, int threads = 0);
+
+// 取出所有峰點位元並還原影像
+BitBuffer extractAndRestoreMultiHistogramShifting (ConstGrayView stego, const MultiHSKey& key, Image<std::uint8_t>& restored, int threads = 0);
+
+// 字串訊息 (含框架標頭) 版本
+bool embedMessageMultiHistogramShifting (ConstGrayView grayImage, const std::string& message, Image<std::uint8_t>& stego, MultiHSKey& key, int maxPairs = 8, int threads = 1);
+std::string extractMessageMultiHistogramShifting (ConstGrayView stego, const MultiHSKey& key, Image<std::uint8_t>& restored, FrameStatus* status = nullptr, int threads = 1);
+
+}  // namespace stego
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "stego/bitstream.hpp"
+
+namespace stego {
+
+// --- 正規 (canonical) Huffman 編碼 ---
+// 只要知道每個符號的碼長就能重建碼字：碼長由短到長、同碼長依符號值排序，碼字依序遞增 (同 DEFLATE)，
+// 因此串流只需存碼長，不必存樹。碼長限制在 HUFFMAN_MAX_BITS 以內，解碼以 HUFFMAN_LOOKUP_BITS 位元的表
+// 一次查出碼長 <= 11 的符號，更長的碼字 (很少出現) 才逐一比較各碼長的上限
+constexpr int HUFFMAN_MAX_BITS = 15;
+constexpr int HUFFMAN_LOOKUP_BITS = 11;
+
+using HuffmanLengths = std::array<std::uint8_t, 256>;  // 0 表示符號沒有出現
+using HuffmanCodes = std::array<std::uint16_t, 256>;   // 碼字靠右對齊，長度見 HuffmanLengths
+
+// 由出現次數求碼長：一般的 Huffman 合併，最長碼超過 HUFFMAN_MAX_BITS 時把次數減半 (至少保留 1) 重算
+// 只出現一種符號時碼長為 1
+HuffmanLengths huffmanCodeLengths (const std::array<std::uint64_t, 256>& frequencies);
+
+// 由碼長指定正規碼字；碼長不合法 (超過上限或 Kraft 和大於 1) 時回傳 false
+bool canonicalHuffmanCodes (const HuffmanLengths& lengths, HuffmanCodes& codes);
+
+// 編碼格式 (MSB-first 打包位元):
+//   [32 位元] 符號數  [256 x 4 位元] 各符號的碼長  [碼字...] 最後不足一個位元組的部分補 0
+// 輸入超過 2^32 - 1 個位元組時回傳空的 BitBuffer
+BitBuffer huffmanEncode (const void* data, std::size_t size);
+
+// 解碼；標頭的碼長不合法、符號數超過資料所能容納或資料在符號數之前就用完時回傳 false (out 清空)
+bool huffmanDecode (const BitBuffer& encoded, std::vector<std::uint8_t>& out);
+
+}  // namespace stego
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+namespace stego {
+
+// 不擁有記憶體的影像視圖 (列優先，通道交錯存放)
+// step 以「元素」為單位，可直接對應 cv::Mat 的 step1()
+template <typename T>
+struct ImageView {
+    T* data = nullptr;
+    int rows = 0;
+    int cols = 0;
+    int channels = 1;
+    std::ptrdiff_t step = 0;
+
+    ImageView () = default;
+    ImageView (T* data, int rows, int cols, int channels = 1, std::ptrdiff_t step = 0)
+        : data(data), rows(rows), cols(cols), channels(channels), step(step ? step : static_cast<std::ptrdiff_t>(cols) * channels) {}
+
+    // 允許 ImageView<T> 隱式轉成 ImageView<const T>
+    template <typename U, typename = std::enable_if_t<std::is_same<const U, T>::value>>
+    ImageView (const ImageView<U>& other) : data(other.data), rows(other.rows), cols(other.cols), channels(other.channels), step(other.step) {}
+
+    bool empty () const { return data == nullptr || rows <= 0 || cols <= 0; }
+    bool continuous () const { return step == static_cast<std::ptrdiff_t>(cols) * channels; }
+    std::size_t total () const { return static_cast<std::size_t>(rows) * cols; }
+    std::size_t samples () const { return total() * channels; }
+
+    T* ptr (int r) const { return data + r * step; }
+    T& at (int r, int c, int ch = 0) const { return data[r * step + static_cast<std::ptrdiff_t>(c) * channels + ch]; }
+
+    // 取出子區域 (與 cv::Mat(cv::Rect) 相同，不複製資料)
+    ImageView roi (int x, int y, int width, int height) const {
+        return ImageView(data + y * step + static_cast<std::ptrdiff_t>(x) * channels, height, width, channels, step);
+    }
+};
+
+// 擁有記憶體的連續影像
+template <typename T>
+class Image {
+public:
+    Image () = default;
+    Image (int rows, int cols, int channels = 1, T fill = T())
+        : rows_(rows), cols_(cols), channels_(channels), data_(static_cast<std::size_t>(rows) * cols * channels, fill) {}
+
+    // 從任意視圖深複製 (對應 cv::Mat::clone)
+    static Image clone (ImageView<const T> src) {
+        Image out(src.rows, src.cols, src.channels);
+        const std::size_t rowLen = static_cast<std::size_t>(src.cols) * src.channels;
+        for (int r = 0; r < src.rows; ++r) {
+            const T* in = src.ptr(r);
+            std::copy(in, in + rowLen, out.data_.begin() + r * rowLen);
+        }
+        return out;
+    }
+
+    bool empty () const { return data_.empty(); }
+    int rows () const { return rows_; }
+    int cols () const { return cols_; }
+    int channels () const { return channels_; }
+    std::size_t total () const { return static_cast<std::size_t>(rows_) * cols_; }
+
+    T* data () { return data_.data(); }
+    const T* data () const { return data_.data(); }
+    T* ptr (int r) { return data_.data() + static_cast<std::size_t>(r) * cols_ * channels_; }
+    const T* ptr (int r) const { return data_.data() + static_cast<std::size_t>(r) * cols_ * channels_; }
+    T& at (int r, int c, int ch = 0) { return ptr(r)[static_cast<std::size_t>(c) * channels_ + ch]; }
+    const T& at (int r, int c, int ch = 0) const { return ptr(r)[static_cast<std::size_t>(c) * channels_ + ch]; }
+
+    ImageView<T> view () { return ImageView<T>(data_.data(), rows_, cols_, channels_); }
+    ImageView<const T> view () const { return ImageView<const T>(data_.data(), rows_, cols_, channels_); }
+    operator ImageView<T> () { return view(); }
+    operator ImageView<const T> () const { return view(); }
+
+private:
+    int rows_ = 0;
+    int cols_ = 0;
+    int channels_ = 1;
+    std::vector<T> data_;
+};
+
+using GrayView = ImageView<std::uint8_t>;
+using ConstGrayView = ImageView<const std::uint8_t>;
+
+}  // namespace stego
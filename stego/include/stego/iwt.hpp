@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <string>
+
+#include "stego/bitstream.hpp"
+#include "stego/frame.hpp"
+#include "stego/image.hpp"
+#include "stego/stream.hpp"
+
+namespace stego {
+
+// --- 頻率域: IWT-Haar + HS on HH subband RDH ---
+
+// 正向 IWT-Haar (1 level)，輸入尺寸必須為偶數
+// 輸出排列: 左上 LL、右上 HL、左下 LH、右下 HH
+Image<std::int32_t> forwardIWTHaar (ConstGrayView input);
+
+// 反向 IWT-Haar (1 level)，結果鉗位到 [0, 255]
+Image<std::uint8_t> inverseIWTHaar (ImageView<const std::int32_t> input);
+
+// --- 多層 lifting IWT (原地轉換) ---
+// Haar: h = x0 - x1, l = x1 + floor(h / 2) (與 forwardIWTHaar 相同)
+// LeGall53: JPEG 2000 可逆 5/3，d = x1 - floor((x0 + x2) / 2), s = x0 + floor((d- + d + 2) / 4)，邊界對稱延伸
+enum class Wavelet : std::uint8_t {
+    Haar = 0,
+    LeGall53 = 1,
+};
+
+// 第 k 層把上一層的 LL (左上 rows >> (k - 1) x cols >> (k - 1) 區域) 再分成 LL/HL/LH/HH，排列同 forwardIWTHaar
+// 係數直接在 coeffs 上轉換，只另外使用 O(rows + cols) 的暫存 (行轉換以 16 行為一組搬進暫存，對齊快取列)
+// rows、cols 必須能被 2^levels 整除，否則回傳 false 且不修改係數
+bool forwardIWT (ImageView<std::int32_t> coeffs, int levels, Wavelet wavelet = Wavelet::Haar);
+bool inverseIWT (ImageView<std::int32_t> coeffs, int levels, Wavelet wavelet = Wavelet::Haar);
+
+enum class Subband : std::uint8_t { LL, HL, LH, HH };
+
+// 第 level 層 (從 1 起算) 的子帶視圖；LL 只有最深一層存放的是低頻係數
+template <typename T>
+ImageView<T> subband (ImageView<T> coeffs, int level, Subband band) {
+    const int rows = coeffs.rows >> level, cols = coeffs.cols >> level;
+    const int x = band == Subband::HL || band == Subband::HH ? cols : 0;
+    const int y = band == Subband::LH || band == Subband::HH ? rows : 0;
+    return coeffs.roi(x, y, cols, rows);
+}
+
+// 取出 HH 子帶視圖 (右下四分之一)
+template <typename T>
+ImageView<T> hhBand (ImageView<T> coeffs) {
+    return subband(coeffs, 1, Subband::HH);
+}
+
+constexpr int INVALID_PEAK = std::numeric_limits<int>::min();
+
+// 整數矩陣的直方圖
+std::map<int, int> calculateHistogramInt (ImageView<const std::int32_t> intMatrix);
+
+// 整數直方圖的峰點 (避開 P+1 溢位)，找不到回傳 INVALID_PEAK
+int findPeakBinInt (const std::map<int, int>& histogram);
+
+// 在 IWT 係數的 HH 子帶以 HS 嵌入位元，失敗時回傳空影像
+Image<std::int32_t> embedHSInHH (ImageView<const std::int32_t> iwtCoeffs, const BitBuffer& bits, int& peakBinHH);
+
+// 從 HH 子帶提取位元並還原係數
+BitBuffer extractRestoreHSInHH (ImageView<const std::int32_t> stegoCoeffs, int peakBinHH, Image<std::int32_t>& restoredCoeffs);
+
+// 串流提取 HH 子帶的位元組，sink 回傳 false 即停止 (不還原係數)
+void streamHSInHH (ImageView<const std::int32_t> stegoCoeffs, int peakBinHH, const ByteSink& sink);
+
+// 只還原係數
+Image<std::int32_t> restoreHSInHH (ImageView<const std::int32_t> stegoCoeffs, int peakBinHH);
+
+// 字串訊息 (含框架標頭) 版本，訊息過長無法框架化時回傳空影像；提取時框架無效回傳空字串 (係數仍會還原)
+Image<std::int32_t> embedMessageHSInHH (ImageView<const std::int32_t> iwtCoeffs, const std::string& message, int& peakBinHH);
+std::string extractMessageHSInHH (ImageView<const std::int32_t> stegoCoeffs, int peakBinHH, Image<std::int32_t>& restoredCoeffs, FrameStatus* status = nullptr);
+
+// --- 盲提取版本: 只需要隱寫影像 (像素)，不需要峰點或原始係數 ---
+// 1-level Haar 的每個 2x2 區塊只由自己的 LL/HL/LH/HH 決定，嵌入時逐一檢查修改後的區塊仍在 [0, 255]
+// (不需要鉗位，隱寫影像做正向 IWT 就能得到完全相同的係數)，會超出範圍的 HH 係數不使用並記入溢位表
+// HH 依列優先排列，最前面一段 [0, hsStart) 是保留區: 其中「LSB 改成 0 或 1 都不會溢位」的係數
+// 以 LSB 依序存放標頭 (峰點、平移方向、hsStart、溢位表) 與溢位表，原本的 LSB 放在 HS 負載最前面，
+// 提取後寫回；HS 只在 [hsStart, end) 進行。影像尺寸必須為偶數
+bool embedBlindHSInHH (ConstGrayView cover, const BitBuffer& bits, Image<std::uint8_t>& stego);
+
+// 取出所有承載位元 (容量超過負載的部分為 0) 並還原影像，保留區內容無效時回傳空 BitBuffer 與空影像
+BitBuffer extractRestoreBlindHSInHH (ConstGrayView stego, Image<std::uint8_t>& restored);
+
+// 字串訊息 (含框架標頭) 版本
+bool embedMessageBlindHSInHH (ConstGrayView cover, const std::string& message, Image<std::uint8_t>& stego);
+std::string extractMessageBlindHSInHH (ConstGrayView stego, Image<std::uint8_t>& restored, FrameStatus* status = nullptr);
+
+}  // namespace stego
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "stego/bitstream.hpp"
+#include "stego/frame.hpp"
+#include "stego/stream.hpp"
+
+namespace stego {
+
+// --- JPEG 量化係數域偽裝 (需要 libjpeg，stego_core 建置時會定義 STEGO_HAVE_JPEG) ---
+// 直接讀取 JPEG 檔的量化 DCT 係數，在亮度分量每個區塊 ZigZag 順序前 coeffsPerBlock 個 AC 係數
+// (與 Ch10_2 相同的 ZIGZAG_ID 位置) 的 LSB 嵌入位元，再重新熵編碼寫回
+// 不做 IDCT、不經過像素、也不會再量化一次，輸出大小與輸入接近
+// 值為 0 或 1 的係數不使用 (JSteg 規則)：修改後不會產生新的 0 或 1，
+// 提取端因此能選到相同的位置，零值連續長度也不變
+using JPEGBytes = std::vector<std::uint8_t>;
+
+// 可嵌入的位元數；不是有效的 JPEG 或資料提早結束 (截斷的檔案) 時回傳 0
+std::size_t capacityJPEG (const JPEGBytes& jpeg, int coeffsPerBlock);
+
+// 回傳嵌入後的 JPEG 檔內容，失敗 (同上) 時回傳空 vector
+JPEGBytes embedJPEG (const JPEGBytes& cover, const BitBuffer& bits, int coeffsPerBlock, std::size_t& bitsEmbedded);
+
+// 依序取出 numBits 個位元
+BitBuffer extractJPEG (const JPEGBytes& stego, int coeffsPerBlock, std::size_t numBits);
+
+// 串流提取：逐位元組交給 sink，sink 回傳 false 即停止
+// (libjpeg 的係數介面仍會先解出整張圖的熵編碼資料，停止的只是後面的走訪)
+void streamJPEG (const JPEGBytes& stego, int coeffsPerBlock, const ByteSink& sink);
+
+// 字串訊息 (加上框架標頭) 版本，容量不足或不是有效的 JPEG 時回傳 false
+bool embedMessageJPEG (const JPEGBytes& cover, JPEGBytes& stego, const std::string& msg, int coeffsPerBlock = 10);
+std::string extractMessageJPEG (const JPEGBytes& stego, int coeffsPerBlock = 10, FrameStatus* status = nullptr);
+
+}  // namespace stego
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "stego/dwt.hpp"
+
+namespace stego {
+
+// --- 放不進記憶體的大影像 (全切片掃描等) 的讀寫 ---
+
+// 以記憶體映射唯讀開啟的 8 位元灰階影像，逐列讀取時只會觸及需要的頁面
+// 支援無標頭 raw 檔與未壓縮、單通道 8 位元的 TIFF / BigTIFF (條帶或分塊排列)
+// 目前只實作 POSIX mmap，其他平台開啟一律失敗
+class MappedGrayImage {
+public:
+    MappedGrayImage () = default;
+    ~MappedGrayImage ();
+    MappedGrayImage (const MappedGrayImage&) = delete;
+    MappedGrayImage& operator= (const MappedGrayImage&) = delete;
+
+    // raw: 從 offset 開始的 rows x cols 個位元組 (列優先)
+    bool openRaw (const std::string& path, int rows, int cols, std::size_t offset = 0);
+    // TIFF: 只讀第一個 IFD；壓縮、多通道或非 8 位元的檔案回傳 false
+    bool openTIFF (const std::string& path);
+    void close ();
+
+    bool empty () const { return data_ == nullptr; }
+    int rows () const { return rows_; }
+    int cols () const { return cols_; }
+
+    // 把第 r 列複製到 out (cols 個像素)
+    // 由上往下讀取時，已經讀過的區塊頁面會陸續交還給系統，常駐記憶體只剩目前附近的區塊列
+    // (之後再讀前面的列也沒問題，只是要重新從檔案載入)
+    bool readRow (int r, std::uint8_t* out) const;
+
+    // 給 streamHaarDWT 使用的來源
+    GrayRowSource rowSource () const {
+        return [this](int r, std::uint8_t* out) { return readRow(r, out); };
+    }
+
+private:
+    bool map (const std::string& path);
+    void releaseBefore (int r) const;
+    void releasePages (std::uint64_t begin, std::uint64_t end) const;
+
+    const std::uint8_t* data_ = nullptr;
+    std::size_t size_ = 0;
+    int rows_ = 0, cols_ = 0;
+    // 影像由 blockRows x blockCols 的區塊組成，區塊依列優先排列、各自連續存放 (raw 與條帶時 blockCols = cols)
+    int blockRows_ = 0, blockCols_ = 0;
+    std::vector<std::uint64_t> blockOffsets_;
+    bool invert_ = false;  // TIFF PhotometricInterpretation = WhiteIsZero
+    mutable int releasedRows_ = 0;  // [0, releasedRows_) 列的頁面已經交還
+};
+
+// 把 streamHaarDWT 的輸出寫成每個子帶一個 float32 raw 檔: <prefix>_L<level>_<LL|HL|LH|HH>.f32
+// 每個檔案是 (rows >> level) x (cols >> level) 個 float (列優先、本機位元組順序)
+// LL 只建立最後一層的檔案；everyLevelLL 為 true 時每層都建立 (搭配 streamHaarDWT 的同名參數)
+class SubbandFileWriter {
+public:
+    SubbandFileWriter (const std::string& prefix, int levels, bool everyLevelLL = false);
+
+    bool ok () const { return ok_; }
+    static std::string fileName (const std::string& prefix, int level, Subband band);
+
+    SubbandRowSink sink ();
+
+private:
+    std::vector<std::ofstream> files_;  // (level - 1) * 4 + band
+    bool ok_ = true;
+};
+
+}  // namespace stego
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#include "stego/bitstream.hpp"
+#include "stego/frame.hpp"
+
+#include "stego/image.hpp"
+#include "stego/stream.hpp"
+
+namespace stego {
+
+// --- 空間域 LSB 偽裝 ---
+// 樣本依「列優先、通道交錯」順序走訪 (BGR 影像即 B, G, R, B, G, R, ...)
+// 每個樣本藏 k 個位元，先嵌入的位元放在 k 個位元中的較高位
+
+// 影像以 k 個 LSB 能容納的位元數
+std::size_t capacityLSB (ConstGrayView image, int k);
+
+// 從第 firstSample 個樣本開始，將 bits 嵌入 image 的最低 k 個位元
+// 回傳實際嵌入的位元數 (容量不足時小於 bits.size())
+std::size_t embedLSB (GrayView image, const BitBuffer& bits, int k, std::size_t firstSample = 0);
+
+// 從第 firstSample 個樣本開始，取出 numBits 個位元
+BitBuffer extractLSB (ConstGrayView image, std::size_t numBits, int k, std::size_t firstSample = 0);
+
+// 平行版本：負載依樣本切成多段，各段的位元起點由前綴和事先算出，輸出與上面的單執行緒版本完全相同
+// threads <= 0 時使用全域執行緒池的所有執行緒
+std::size_t embedLSBParallel (GrayView image, const BitBuffer& bits, int k, std::size_t firstSample = 0, int threads = 0);
+BitBuffer extractLSBParallel (ConstGrayView image, std::size_t numBits, int k, std::size_t firstSample = 0, int threads = 0);
+
+// 字串訊息 (加上框架標頭) 的 LSB 嵌入，容量不足時回傳 false
+// threads != 1 時使用 embedLSBParallel
+bool embedMessageLSB (ConstGrayView cover, Image<std::uint8_t>& stego, const std::string& msg, int k = 1, int threads = 1);
+
+// 串流提取：從第 firstSample 個樣本開始逐位元組交給 sink，sink 回傳 false 即停止
+void streamLSB (ConstGrayView stego, int k, const ByteSink& sink, std::size_t firstSample = 0);
+
+// 取出字串訊息，讀完框架記錄的長度即停止；框架無效時回傳空字串
+std::string extractMessageLSB (ConstGrayView stego, int k = 1, FrameStatus* status = nullptr);
+
+// --- 框架標頭 + LSB (Final/Demo 2) ---
+// 前 FRAME_HEADER_BITS 個像素以 1 bit LSB 存放框架標頭，其後每個像素藏 k 個位元
+// 容量不足時只嵌入放得下的部分，標頭記錄的是實際嵌入的長度與 CRC；該長度超過 2^32 - 1 個位元時回傳空影像
+
+// 固定 k 的嵌入，bitsEmbedded 回傳實際嵌入的負載位元數
+Image<std::uint8_t> embedFixedLSB (ConstGrayView cover, const BitBuffer& payload, int k, std::size_t& bitsEmbedded);
+
+// 標頭或 CRC 錯誤時回傳空的 BitBuffer
+BitBuffer extractFixedLSB (ConstGrayView stego, int k, FrameStatus* status = nullptr);
+
+// 適應性嵌入：依原始影像區塊變異數決定是否嵌入 (變異數 < varianceThreshold 的平滑區塊 k=0)
+Image<std::uint8_t> embedAdaptiveLSB (ConstGrayView cover, const BitBuffer& payload, int blockSize, double varianceThreshold, int k, std::size_t& bitsEmbedded);
+
+// 非盲提取：需要原始影像來重算區塊變異數
+BitBuffer extractAdaptiveLSB (ConstGrayView stego, ConstGrayView coverForVariance, int blockSize, double varianceThreshold, int k, FrameStatus* status = nullptr);
+
+// 區塊像素值的母體變異數 (與 cv::meanStdDev 相同定義)
+double blockVariance (ConstGrayView block);
+
+}  // namespace stego
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstring>
+
+#include "stego/image.hpp"
+
+namespace stego {
+
+// 計算兩張 8 位元影像之間的峰值信噪比 (dB)
+// 影像完全相同時回傳正無窮大；尺寸或通道數不符時回傳 0
+double calculatePSNR (ConstGrayView img1, ConstGrayView img2);
+
+// 比較兩個影像/矩陣是否完全相同 (支援任意元素型態，例如 uint8_t 與 int32_t)
+template <typename T>
+bool compareImages (ImageView<const T> img1, ImageView<const T> img2) {
+    if (img1.empty() || img2.empty()) return false;
+    if (img1.rows != img2.rows || img1.cols != img2.cols || img1.channels != img2.channels) return false;
+    const std::size_t rowBytes = static_cast<std::size_t>(img1.cols) * img1.channels * sizeof(T);
+    for (int r = 0; r < img1.rows; ++r) {
+        if (std::memcmp(img1.ptr(r), img2.ptr(r), rowBytes) != 0) return false;
+    }
+    return true;
+}
+
+template <typename T>
+bool compareImages (const Image<T>& img1, const Image<T>& img2) {
+    return compareImages<T>(img1.view(), img2.view());
+}
+
+}  // namespace stego
@@ -0,0 +1,41 @@
+#pragma once
+
+// cv::Mat 與 stego::ImageView / stego::Image 之間的轉接 (僅供需要 OpenCV 的示範程式使用)
+// 函式庫本身不依賴 OpenCV
+
+#include <opencv2/core.hpp>
+
+#include "stego/image.hpp"
+
+namespace stego {
+
+// cv::Mat -> 視圖 (不複製資料)
+template <typename T>
+ImageView<T> toView (cv::Mat& m) {
+    CV_Assert(m.depth() == cv::DataType<T>::depth);
+    return ImageView<T>(m.ptr<T>(), m.rows, m.cols, m.channels(), static_cast<std::ptrdiff_t>(m.step1()));
+}
+
+template <typename T>
+ImageView<const T> toView (const cv::Mat& m) {
+    CV_Assert(m.depth() == cv::DataType<T>::depth);
+    return ImageView<const T>(m.ptr<T>(), m.rows, m.cols, m.channels(), static_cast<std::ptrdiff_t>(m.step1()));
+}
+
+inline ConstGrayView toGrayView (const cv::Mat& m) { return toView<std::uint8_t>(m); }
+inline GrayView toGrayView (cv::Mat& m) { return toView<std::uint8_t>(m); }
+
+// 視圖 -> cv::Mat (深複製)
+template <typename T>
+cv::Mat toMat (ImageView<const T> v) {
+    if (v.empty()) return cv::Mat();
+    cv::Mat header(v.rows, v.cols, CV_MAKETYPE(cv::DataType<T>::depth, v.channels), const_cast<T*>(v.data), v.step * sizeof(T));
+    return header.clone();
+}
+
+template <typename T>
+cv::Mat toMat (const Image<T>& img) {
+    return toMat<T>(img.view());
+}
+
+}  // namespace stego
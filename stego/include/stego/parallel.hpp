@@ -0,0 +1,63 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace stego {
+
+// --- 固定大小的執行緒池 ---
+// 一次執行一批編號 0..count-1 的工作，呼叫端的執行緒也會一起分擔，等全部完成才返回
+// 工作中再次呼叫 parallelFor 會直接在目前執行緒依序執行 (避免巢狀等待造成死結)
+class ThreadPool {
+public:
+    // threads <= 0 時使用 std::thread::hardware_concurrency()
+    explicit ThreadPool (int threads = 0);
+    ~ThreadPool ();
+
+    ThreadPool (const ThreadPool&) = delete;
+    ThreadPool& operator= (const ThreadPool&) = delete;
+
+    // 參與運算的執行緒數 (包含呼叫端)
+    int size () const { return static_cast<int>(workers_.size()) + 1; }
+
+    // 執行 fn(0) .. fn(count - 1)；任一工作丟出例外時，等全部結束後在呼叫端重新丟出第一個例外
+    // maxThreads > 0 時這一批最多只有 maxThreads 個執行緒 (包含呼叫端) 領取工作
+    void parallelFor (std::size_t count, const std::function<void(std::size_t)>& fn, int maxThreads = 0);
+
+    // 整個程式共用的執行緒池
+    static ThreadPool& global ();
+
+private:
+    void workerLoop ();
+    void runTasks (std::size_t generation);
+
+    std::vector<std::thread> workers_;
+    std::mutex submitMutex_;  // 同一時間只允許一批工作
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable finished_;
+
+    const std::function<void(std::size_t)>* job_ = nullptr;
+    std::size_t count_ = 0;
+    std::size_t next_ = 0;
+    std::size_t pending_ = 0;  // 尚未完成的工作數
+    std::size_t generation_ = 0;
+    int limit_ = 0;   // 這一批允許的參與執行緒數
+    int joined_ = 0;  // 已加入這一批的執行緒數
+    std::exception_ptr error_;
+    bool stop_ = false;
+};
+
+// 以全域執行緒池執行 fn(0) .. fn(count - 1)，最多使用 threads 個執行緒 (threads <= 0 為整個池)；
+// threads == 1 或 count <= 1 時直接依序執行
+void parallelFor (std::size_t count, const std::function<void(std::size_t)>& fn, int threads = 0);
+
+// threads <= 0 時回傳全域執行緒池的大小
+int resolveThreads (int threads);
+
+}  // namespace stego
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "stego/bitstream.hpp"
+#include "stego/frame.hpp"
+#include "stego/image.hpp"
+
+namespace stego {
+
+// --- 預測誤差擴張 (Prediction-Error Expansion) RDH ---
+// e = x - pred；-T <= e < T 的像素擴張為 2e + b 嵌入 1 位元，其餘的誤差往外平移 T
+// 預測誤差集中在 0 附近，容量遠大於像素值直方圖平移
+//
+// Rhombus: 以上下左右四個鄰點的平均預測，影像依棋盤格分兩次處理 —
+//   先處理 (r + c) 為偶數的像素 (鄰點都是另一色，尚未修改)，再以修改後的偶數像素預測奇數像素；
+//   同一次處理中的像素彼此獨立，可依列切段平行嵌入與提取
+// MED: 以左、上、左上三個鄰點的中值邊緣偵測 (JPEG-LS) 預測，依列優先單次處理；
+//   左上鄰點與目前像素同色，無法套用棋盤格，因此提取只能依序進行 (嵌入仍可平行)
+enum class PEEPredictor : std::uint8_t {
+    Rhombus = 0,
+    MED = 1,
+};
+
+// 提取與還原所需的資訊
+struct PEEKey {
+    PEEPredictor predictor = PEEPredictor::Rhombus;
+    int threshold = 1;
+    std::size_t overflowCount = 0;
+    std::vector<std::uint8_t> overflowMap;  // 修改後會超出 [0, 255] 而未使用的像素 (差分 + LEB128)
+};
+
+// 門檻 T 從 1 開始往上試到 maxThreshold，使用第一個容量足夠的 T (失真最小)
+// 容量超過負載時其餘擴張像素嵌入 0；容量不足時回傳 false
+bool embedPEE (ConstGrayView cover, const BitBuffer& bits, Image<std::uint8_t>& stego, PEEKey& key,
+               PEEPredictor predictor = PEEPredictor::Rhombus, int maxThreshold = 8, int threads = 0);
+
+// 取出所有擴張像素的位元並還原影像
+BitBuffer extractAndRestorePEE (ConstGrayView stego, const PEEKey& key, Image<std::uint8_t>& restored, int threads = 0);
+
+// 字串訊息 (含框架標頭) 版本
+bool embedMessagePEE (ConstGrayView cover, const std::string& message, Image<std::uint8_t>& stego, PEEKey& key,
+                      PEEPredictor predictor = PEEPredictor::Rhombus, int maxThreshold = 8, int threads = 1);
+std::string extractMessagePEE (ConstGrayView stego, const PEEKey& key, Image<std::uint8_t>& restored, FrameStatus* status = nullptr, int threads = 1);
+
+}  // namespace stego
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "stego/image.hpp"
+
+namespace stego {
+
+// --- GF(2^8) 上的 (k,n) Shamir 秘密分享 ---
+// 體的既約多項式為 x^8 + x^4 + x^3 + x^2 + 1 (0x11d)，生成元為 2；加法即 XOR
+// 每個位元組各自是一個 k - 1 次多項式的常數項，其餘係數為隨機位元組，第 i 張分享在 x = i 取值 (i = 1..n)
+// 乘上固定常數以兩個 16 項的半位元組表查表 (支援 AVX2 的 CPU 以 PSHUFB 一次處理 32 個位元組)，
+// 因此整個緩衝區 (影像、金鑰) 一次分享，而不是逐個整數
+std::uint8_t gf256Mul (std::uint8_t a, std::uint8_t b);
+std::uint8_t gf256Inv (std::uint8_t a);  // a != 0
+
+struct ShamirShare {
+    std::uint8_t x = 0;               // 分享的 x 座標 (1..n)
+    std::vector<std::uint8_t> data;   // 與秘密等長，data[j] = P_j(x)
+};
+
+// 分享 size 個位元組的秘密；2 <= k <= n <= 255，否則回傳空 vector
+// 亂數由 seed 與區塊編號決定 (SplitMix64，不是密碼學等級的亂數產生器，seed 應取自 random_device)，結果與執行緒數無關
+std::vector<ShamirShare> shamirSplit (const void* secret, std::size_t size, int k, int n, std::uint64_t seed, int threads = 0);
+
+// 在 x = 0 的拉格朗日權重 L_i(0) = prod_{j != i} x_j / (x_j - x_i)；x 有 0 或重複時回傳空 vector
+std::vector<std::uint8_t> gf256LagrangeAtZero (const std::vector<std::uint8_t>& xs);
+
+// 以給定的分享還原秘密 (至少要有 k 張，全部都會用到)：權重只對這組分享計算一次，
+// 之後每個位元組都是 sum L_i(0) * y_i；x 重複、為 0 或長度不一時回傳空 vector
+std::vector<std::uint8_t> shamirCombine (const std::vector<ShamirShare>& shares, int threads = 0);
+
+// --- 質數體 GF(2^31 - 1) 上的批次拉格朗日還原 ---
+// Ch09_1 的 mod = INT_MAX = 2^31 - 1 是梅森質數，乘積可用 (v & p) + (v >> 31) 化簡，不需要除法
+// 同一組 x 座標還原大量秘密時，權重 L_i(0) 只在建構時算一次：m 個分母以 Montgomery 批次求反元素
+// (字首乘積 + 一次快速冪)，之後每個秘密只是長度 m 的內積，AVX2 一次處理 4 個秘密
+constexpr std::uint32_t MERSENNE_31 = 2147483647u;
+
+class LagrangeReconstructor {
+public:
+    // xs 為分享的 x 座標 (1 <= x < 2^31 - 1，不可重複)，否則 valid() 為 false
+    explicit LagrangeReconstructor (const std::vector<std::uint32_t>& xs);
+
+    bool valid () const { return !weights_.empty(); }
+    int size () const { return static_cast<int>(weights_.size()); }
+    const std::vector<std::uint32_t>& weights () const { return weights_; }
+
+    // 單一秘密：ys[i] 為第 i 張分享的 y (< 2^31 - 1)
+    std::uint32_t reconstruct (const std::uint32_t* ys) const;
+
+    // count 個秘密：ys[i][j] 為第 i 張分享對第 j 個秘密的 y，out[j] 為還原的秘密；依秘密切段平行處理
+    void reconstruct (const std::uint32_t* const* ys, std::size_t count, std::uint32_t* out, int threads = 0) const;
+
+private:
+    std::vector<std::uint32_t> weights_;
+};
+
+// --- 影像秘密分享 (Thien-Lin) ---
+// 每 k 個連續像素當作一個 k - 1 次多項式的全部係數 (不是只放在常數項)，第 i 張影子影像存 q(i)，
+// 因此每張影子影像只有原圖的 1/k 寬；任 k 張影子以反 Vandermonde 矩陣 (拉格朗日基底多項式的係數，
+// 分母以批次反元素求出) 還原每組係數。係數就是像素本身，秘密影像應先以金鑰打亂或加密再分享
+enum class SharingField : std::uint8_t {
+    GF251 = 0,  // 質數體 251：像素 >= 250 拆成 250 與 (像素 - 250) 兩個值，無損但該列會變長
+    GF256 = 1,  // GF(2^8)：所有像素直接是體的元素，影子寬度固定為 ceil(cols / k)
+};
+
+struct ShadowImage {
+    std::uint8_t x = 0;           // 影子的 x 座標 (1..n)
+    Image<std::uint8_t> image;    // rows x width，GF251 的 width 取最長那一列 (較短的列補 0)
+};
+
+// 2 <= k <= n (GF251 n <= 250，GF256 n <= 255)，否則回傳空 vector；依列切段平行處理，結果與執行緒數無關
+std::vector<ShadowImage> splitSecretImage (ConstGrayView secret, int k, int n, SharingField field = SharingField::GF251, int threads = 0);
+
+// 以前 k 張影子還原秘密影像，dst 的尺寸即秘密影像的尺寸；影子不足、x 重複或尺寸不符時回傳 false
+bool combineSecretImage (const std::vector<ShadowImage>& shadows, int k, SharingField field, GrayView dst, int threads = 0);
+
+}  // namespace stego
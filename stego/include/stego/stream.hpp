@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace stego {
+
+// --- 串流提取 ---
+// 提取器把取出的位元組逐一交給 ByteSink，sink 回傳 false 後提取器立即停止讀取像素
+// 因此短訊息的提取成本只和負載長度有關，與封面影像大小無關
+using ByteSink = std::function<bool(std::uint8_t)>;
+
+// 把逐段取出的位元 (MSB-first) 組成位元組並送給 sink
+class ByteAssembler {
+public:
+    explicit ByteAssembler (const ByteSink& sink) : sink_(sink) {}
+
+    bool stopped () const { return stopped_; }
+    bool aligned () const { return bits_ == 0; }
+
+    // 放入 value 的低 n (0..24) 個位元；sink 要求停止後回傳 false
+    bool put (std::uint32_t value, int n) {
+        if (stopped_) return false;
+        acc_ = (acc_ << n) | (value & ((1u << n) - 1));
+        bits_ += n;
+        while (bits_ >= 8) {
+            bits_ -= 8;
+            std::uint8_t byte = static_cast<std::uint8_t>(acc_ >> bits_);
+            acc_ &= (1u << bits_) - 1;
+            if (!sink_(byte)) {
+                stopped_ = true;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // 依序送出整段位元組
+    bool putBytes (const std::uint8_t* data, std::size_t n) {
+        for (std::size_t i = 0; i < n; ++i) {
+            if (!put(data[i], 8)) return false;
+        }
+        return true;
+    }
+
+private:
+    const ByteSink& sink_;
+    std::uint64_t acc_ = 0;
+    int bits_ = 0;
+    bool stopped_ = false;
+};
+
+}  // namespace stego
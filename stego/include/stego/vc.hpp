@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "stego/image.hpp"
+
+namespace stego {
+
+// --- 視覺密碼 (Visual Cryptography) 分享圖 ---
+// 每個子像素 1 位元 (1 = 黑，0 = 透明/白)，每列以 64 位元字組存放：
+// 第 c 個子像素位於 row(r)[c / 64] 的第 c % 64 位元，列尾多出的位元固定為 0
+// 疊合投影片等同黑色位元的 OR (0/255 影像則是 AND)，一次處理 64 個子像素
+class ShareBitmap {
+public:
+    ShareBitmap () = default;
+    ShareBitmap (int rows, int cols)
+        : rows_(rows), cols_(cols), wordsPerRow_((static_cast<std::size_t>(cols) + 63) / 64), words_(rows * wordsPerRow_, 0) {}
+
+    bool empty () const { return words_.empty(); }
+    int rows () const { return rows_; }
+    int cols () const { return cols_; }
+    std::size_t wordsPerRow () const { return wordsPerRow_; }
+
+    std::uint64_t* row (int r) { return words_.data() + r * wordsPerRow_; }
+    const std::uint64_t* row (int r) const { return words_.data() + r * wordsPerRow_; }
+    bool black (int r, int c) const { return (row(r)[c >> 6] >> (c & 63)) & 1; }
+
+private:
+    int rows_ = 0;
+    int cols_ = 0;
+    std::size_t wordsPerRow_ = 0;
+    std::vector<std::uint64_t> words_;
+};
+
+// 每個秘密像素擴張為 2x2 子像素 (2 黑 2 白，共 6 種圖樣，A 為隨機圖樣、A' 為其互補)
+// 白點：所有分享圖都是 A；黑點：分享圖分別拿到 A 或 A'，拿到 A 與 A' 的兩張疊合後 2x2 全黑
+// 單張分享圖上白點與黑點的圖樣分布相同，看不出秘密
+enum class VCScheme : std::uint8_t {
+    TwoOfTwo = 0,   // (2,2)，Additional/Q3：黑點為 (A, A')
+    TwoOfFour = 1,  // (2,4)，Final/Demo 1：黑點隨機取 (A,A,A',A')、(A,A',A,A')、(A,A',A',A) 其中之一
+};
+
+// 秘密影像 (>= 128 為白) 產生分享圖，各張大小為 (2 * rows) x (2 * cols)
+// 每個像素取 1 個隨機位元組查表得到各分享圖的 2x2 圖樣，每 32 個像素組成一個 64 位元字組一次寫入
+// 亂數由 seed 與列號決定 (SplitMix64)，結果與執行緒數無關；失敗時回傳空 vector
+std::vector<ShareBitmap> generateShares (ConstGrayView secret, VCScheme scheme, std::uint64_t seed, int threads = 0);
+
+// 疊合兩張分享圖 (逐字組 OR)；尺寸不同時回傳空的 ShareBitmap
+ShareBitmap stackShares (const ShareBitmap& a, const ShareBitmap& b);
+
+// 展開成 0/255 影像 (黑 0、白 255)，out 尺寸必須與分享圖相同
+bool unpackShare (const ShareBitmap& share, GrayView out);
+
+// --- 一般 (k,n) 視覺密碼 ---
+// 基底矩陣 S0 (白)、S1 (黑) 為 n 列 m 行的 0/1 矩陣，以「各行的權重 (黑色子像素數)」描述：
+// 權重 w 的全部 C(n, w) 種行向量各放入 f(w) 次 (f > 0 進 S0，f < 0 進 S1)。f 滿足
+//   任取 q < k 列時兩者的行向量分布相同 (看不出秘密)；任取 q >= k 列時 S0 疊合後的白色子像素較多
+// 條件是 k 個線性方程式，程式列舉 k + 1 個權重的組合求整數解，選相對對比 (白色子像素差 / m) 最高者，
+// 不一定是 m = n 的經典方案：例如 (2,4) 選到 2x3 的區塊 (白/黑點疊合後 3/5 個黑子像素)；(n,n) 為 Naor-Shamir 的 2^(n-1)
+// m 以全黑的行補到 blockRows x blockCols (不影響安全性與對比)，最多 64 個子像素
+struct VCBasis {
+    int k = 0, n = 0;
+    int blockRows = 0, blockCols = 0;  // 每個秘密像素擴張成 blockRows x blockCols 個子像素
+    int whiteBlack = 0, blackBlack = 0;  // 任 k 張疊合後，白點、黑點區塊內的黑色子像素數
+    std::vector<std::uint32_t> white, black;  // 各行 (第 i 位元為第 i 張分享圖的子像素)，依區塊內列優先順序
+
+    int subpixels () const { return blockRows * blockCols; }
+};
+
+// 取得 (k,n) 的基底矩陣 (第一次使用時計算並快取)；2 <= k <= n <= 16 且找得到 64 個子像素以內的解，否則回傳 nullptr
+const VCBasis* vcBasis (int k, int n);
+
+// 以 (k,n) 基底矩陣一次掃描秘密影像產生 n 張分享圖，各張大小為 (blockRows * rows) x (blockCols * cols)
+// 每個像素對基底矩陣的行做均勻隨機排列：m <= 6 時直接從全部 m! 種排列後的圖樣查表，否則即時洗牌
+// vcBasis() 回傳的基底，其排列表與基底一起快取；自行組成的 VCBasis 則每次呼叫重新建立
+std::vector<ShareBitmap> generateShares (ConstGrayView secret, const VCBasis& basis, std::uint64_t seed, int threads = 0);
+
+// 疊合 members 指定的分享圖 (逐字組 OR)；編號超出範圍或尺寸不同時回傳空的 ShareBitmap
+ShareBitmap stackShares (const std::vector<ShareBitmap>& shares, const std::vector<int>& members);
+
+// 驗證：任 k 張疊合後每個區塊的黑色子像素數都符合 whiteBlack / blackBlack (逐一檢查全部 C(n, k) 種組合)
+bool verifyShares (const std::vector<ShareBitmap>& shares, ConstGrayView secret, const VCBasis& basis);
+
+}  // namespace stego
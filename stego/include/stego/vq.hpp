@@ -0,0 +1,36 @@
+#pragma once
+
+#include <ostream>
+#include <vector>
+
+#include "stego/image.hpp"
+
+namespace stego {
+
+// --- 向量量化 (VQ) ---
+using VQVector = std::vector<double>;
+
+// 將影像切成 blockSize x blockSize 區塊並攤平成向量 (尺寸無法整除時裁切右側/下側)
+std::vector<VQVector> extractBlockVectors (ConstGrayView image, int blockSize);
+
+// 兩向量之間的平方歐氏距離
+double squaredDistance (const VQVector& a, const VQVector& b);
+
+// 計算一組向量的質心 (平均向量)
+VQVector calculateCentroid (const std::vector<VQVector>& vectors);
+
+// 找出距離 v 最近的碼向量索引，codebook 為空時回傳 -1
+int nearestCodeword (const VQVector& v, const std::vector<VQVector>& codebook);
+
+// 編碼：每個向量以最近碼向量的索引表示
+std::vector<int> encodeVQ (const std::vector<VQVector>& data, const std::vector<VQVector>& codebook);
+
+// 解碼：索引轉回碼向量，無效索引回傳空向量
+std::vector<VQVector> decodeVQ (const std::vector<int>& indices, const std::vector<VQVector>& codebook);
+
+// LBG 演算法：由平均向量開始反覆分裂並以 K-means 優化，直到碼書大小達到 targetCodebookSize
+// 碼書大小不超過訓練向量數；訓練資料為空或 targetCodebookSize < 1 時回傳空碼書
+// log 不為 nullptr 時輸出訓練過程
+std::vector<VQVector> trainLBG (const std::vector<VQVector>& trainingVectors, int targetCodebookSize, double epsilon, int maxIterations, double perturbation, std::ostream* log = nullptr);
+
+}  // namespace stego
@@ -0,0 +1,48 @@
+#include "stego/bits.hpp"
+
+#include <cstring>
+
+namespace stego {
+
+BitBuffer stringToBits (const std::string& s) {
+    // 打包格式與字串的位元組順序相同，直接複製
+    return BitBuffer::fromBytes(s.data(), s.size());
+}
+
+std::string bitsToString (const BitBuffer& bits) {
+    const std::size_t n = bits.size() >> 3;
+    const void* end = std::memchr(bits.data(), 0, n);  // 尋找結束符
+    return std::string(reinterpret_cast<const char*>(bits.data()),
+                       end ? static_cast<const std::uint8_t*>(end) - bits.data() : n);
+}
+
+std::string bitsToRawString (const BitBuffer& bits) {
+    return std::string(reinterpret_cast<const char*>(bits.data()), bits.size() >> 3);
+}
+
+BitBuffer binaryStringToBits (const std::string& s) {
+    BitWriter w(s.length());
+    for (char c : s) w.put(c == '1');
+    return w.take();
+}
+
+std::string bitsToBinaryString (const BitBuffer& bits) {
+    std::string s(bits.size(), '0');
+    for (std::size_t i = 0; i < s.size(); ++i) {
+        if (bits[i]) s[i] = '1';
+    }
+    return s;
+}
+
+BitBuffer intToBits (std::uint32_t n, int numBits) {
+    BitWriter w(numBits);
+    w.write(n, numBits);
+    return w.take();
+}
+
+std::uint32_t bitsToInt (const BitBuffer& bits, int numBits) {
+    // 超出 bits 範圍的位元視為 0
+    return static_cast<std::uint32_t>(bits.read(0, numBits));
+}
+
+}  // namespace stego
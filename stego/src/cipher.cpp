@@ -0,0 +1,25 @@
+#include "stego/cipher.hpp"
+
+#include <random>
+
+namespace stego {
+
+Image<std::uint8_t> encryptDecryptStream (ConstGrayView input, unsigned int key) {
+    Image<std::uint8_t> output(input.rows, input.cols, input.channels);
+    const int rowLen = input.cols * input.channels;
+
+    // 使用密鑰初始化 Mersenne Twister 引擎，產生 0-255 的隨機位元組
+    std::mt19937 rng(key);
+    std::uniform_int_distribution<unsigned int> dist(0, 255);
+
+    for (int r = 0; r < input.rows; ++r) {
+        const std::uint8_t* in = input.ptr(r);
+        std::uint8_t* out = output.ptr(r);
+        for (int c = 0; c < rowLen; ++c) {
+            out[c] = in[c] ^ static_cast<std::uint8_t>(dist(rng));
+        }
+    }
+    return output;
+}
+
+}  // namespace stego
@@ -0,0 +1,224 @@
+#include "stego/dct.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "stego/parallel.hpp"
+
+namespace stego {
+
+const int ZIGZAG_ID[20][2] = {
+    {0, 1}, {1, 0}, {2, 0}, {1, 1}, {0, 2}, {0, 3}, {1, 2}, {2, 1}, {3, 0}, {4, 0},  // 前 10 個
+    {3, 1}, {2, 2}, {1, 3}, {0, 4}, {0, 5}, {1, 4}, {2, 3}, {3, 2}, {4, 1}, {5, 0}   // 第 11 到 20 個
+};
+
+Image<float> padReplicateToFloat (ConstGrayView src, int rows, int cols) {
+    Image<float> out(rows, cols);
+    for (int r = 0; r < rows; ++r) {
+        const std::uint8_t* in = src.ptr(std::min(r, src.rows - 1));
+        float* o = out.ptr(r);
+        for (int c = 0; c < cols; ++c) o[c] = in[std::min(c, src.cols - 1)];
+    }
+    return out;
+}
+
+Image<std::uint8_t> floatToU8 (ImageView<const float> src) {
+    Image<std::uint8_t> out(src.rows, src.cols, src.channels);
+    const int rowLen = src.cols * src.channels;
+    for (int r = 0; r < src.rows; ++r) {
+        const float* in = src.ptr(r);
+        std::uint8_t* o = out.ptr(r);
+        for (int c = 0; c < rowLen; ++c) {
+            long v = std::lrint(in[c]);
+            o[c] = static_cast<std::uint8_t>(std::clamp(v, 0L, 255L));
+        }
+    }
+    return out;
+}
+
+namespace {
+
+// 攜帶負載的區塊依序排在前 totalBlocks 個位置 (列優先)，因此只需處理前幾條 8 列區塊帶
+// f(strip, blocks) 處理第 strip 條帶的前 blocks 個區塊，各條帶互不重疊，可平行執行
+template <typename F>
+void forEachPayloadStrip (std::size_t totalBlocks, int blocksPerRow, int threads, F&& f) {
+    if (totalBlocks == 0 || blocksPerRow <= 0) return;
+    const std::size_t strips = (totalBlocks + blocksPerRow - 1) / blocksPerRow;
+    parallelFor(strips, [&](std::size_t s) {
+        f(s, static_cast<int>(std::min<std::size_t>(blocksPerRow, totalBlocks - s * blocksPerRow)));
+    }, threads);
+}
+
+}  // namespace
+
+Image<float> embedDCTZigZag (ConstGrayView cover, const BitBuffer& bits, int coeffsPerBlock, std::size_t& bitsEmbedded, int threads) {
+    // 補邊後的維度 n, m (向上取整到 8 的倍數)
+    const int n = (cover.rows + 7) & ~7;
+    const int m = (cover.cols + 7) & ~7;
+    const int used = std::min(coeffsPerBlock, 20);
+    const int blocksPerRow = m / DCT_BLOCK;
+
+    // 沒有攜帶位元的區塊只做補邊複製，不經過 DCT/IDCT
+    Image<float> stego = padReplicateToFloat(cover, n, m);
+    if (used <= 0) {
+        bitsEmbedded = 0;
+        return stego;
+    }
+    const std::size_t capacity = static_cast<std::size_t>(n / DCT_BLOCK) * blocksPerRow * used;
+    const std::size_t N = std::min(bits.size(), capacity);
+
+    forEachPayloadStrip((N + used - 1) / used, blocksPerRow, threads, [&](std::size_t s, int blocks) {
+        float* strip = stego.ptr(static_cast<int>(s) * DCT_BLOCK);
+        std::size_t id = s * blocksPerRow * used;
+        // 整條帶原地轉成係數，修改後再轉回
+        forwardDCTStrip(strip, m, strip, m, blocks);
+        for (int b = 0; b < blocks; ++b) {
+            float* coef = strip + b * DCT_BLOCK;
+            for (int k = 0; k < used && id < N; ++k) {
+                float& c = coef[ZIGZAG_ID[k][0] * m + ZIGZAG_ID[k][1]];
+                // 四捨五入到整數後修改 LSB
+                int ci = static_cast<int>(std::round(c));
+                c = static_cast<float>((ci & ~1) | bits[id++]);
+            }
+        }
+        inverseDCTStrip(strip, m, strip, m, blocks);
+    });
+    bitsEmbedded = N;
+    return stego;
+}
+
+namespace {
+
+// 一次轉換的區塊數；串流提取在 sink 停止後最多多轉換一批
+constexpr int STRIP_BLOCKS = 16;
+
+// 依區塊順序取出係數 LSB，f(bit) 回傳 false 時停止
+template <typename F>
+void forEachZigZagBit (ImageView<const float> stego, int coeffsPerBlock, F&& f) {
+    const int used = std::min(coeffsPerBlock, 20);
+    if (used <= 0) return;
+    float coef[DCT_BLOCK * DCT_BLOCK * STRIP_BLOCKS];
+    const int stride = DCT_BLOCK * STRIP_BLOCKS;
+    for (int i = 0; i + DCT_BLOCK <= stego.rows; i += DCT_BLOCK) {
+        for (int j = 0; j + DCT_BLOCK <= stego.cols; j += stride) {
+            const int blocks = std::min(STRIP_BLOCKS, (stego.cols - j) / DCT_BLOCK);
+            forwardDCTStrip(stego.ptr(i) + j, stego.step, coef, stride, blocks);
+            for (int b = 0; b < blocks; ++b) {
+                for (int k = 0; k < used; ++k) {
+                    int ci = static_cast<int>(std::round(coef[ZIGZAG_ID[k][0] * stride + b * DCT_BLOCK + ZIGZAG_ID[k][1]]));
+                    if (!f((ci & 1) != 0)) return;
+                }
+            }
+        }
+    }
+}
+
+}  // namespace
+
+BitBuffer extractDCTZigZag (ImageView<const float> stego, int coeffsPerBlock, std::size_t numBits) {
+    BitWriter writer(numBits);
+    if (numBits == 0) return writer.take();
+    forEachZigZagBit(stego, coeffsPerBlock, [&](bool b) {
+        writer.put(b);
+        return writer.size() < numBits;
+    });
+    return writer.take();
+}
+
+Image<float> embedMessageDCTZigZag (ConstGrayView cover, const std::string& msg, int coeffsPerBlock, int threads) {
+    BitBuffer bits = frameMessage(msg, FrameAlgorithm::DCTZigZag, static_cast<std::uint16_t>(coeffsPerBlock));
+    if (bits.empty()) return Image<float>();  // 訊息過長
+    std::size_t bitsEmbedded = 0;
+    return embedDCTZigZag(cover, bits, coeffsPerBlock, bitsEmbedded, threads);
+}
+
+void streamDCTZigZag (ImageView<const float> stego, int coeffsPerBlock, const ByteSink& sink) {
+    ByteAssembler out(sink);
+    // 區塊在需要時才做 DCT，sink 停止後剩下的區塊不會被轉換
+    forEachZigZagBit(stego, coeffsPerBlock, [&](bool b) { return out.put(b, 1); });
+}
+
+std::string extractMessageDCTZigZag (ImageView<const float> stego, int coeffsPerBlock, FrameStatus* status) {
+    const std::size_t capacity = static_cast<std::size_t>(stego.rows / DCT_BLOCK) * (stego.cols / DCT_BLOCK) * std::clamp(coeffsPerBlock, 0, 20);
+    FrameReader reader(FrameAlgorithm::DCTZigZag, static_cast<std::uint16_t>(coeffsPerBlock), capacity > FRAME_HEADER_BITS ? capacity - FRAME_HEADER_BITS : 0);
+    streamDCTZigZag(stego, coeffsPerBlock, reader.sink());
+    return reader.takeMessage(status);
+}
+
+namespace {
+
+// 把第 r 列起 8 列、前 width 個像素轉成浮點數 (MidTerm/Q2 不補邊，只處理完整區塊)
+void loadStrip (ConstGrayView src, int r, int width, float* dst) {
+    for (int y = 0; y < DCT_BLOCK; ++y) {
+        const std::uint8_t* in = src.ptr(r + y);
+        float* o = dst + y * width;
+        for (int x = 0; x < width; ++x) o[x] = in[x];
+    }
+}
+
+}  // namespace
+
+Image<std::uint8_t> embedDCTParity (ConstGrayView cover, const BitBuffer& bits, int u, int v, float step, std::size_t& bitsEmbedded, int threads) {
+    // 輸出先複製整張封面，只有攜帶位元的區塊會被轉換並寫回
+    Image<std::uint8_t> out(cover.rows, cover.cols);
+    for (int r = 0; r < cover.rows; ++r) std::copy(cover.ptr(r), cover.ptr(r) + cover.cols, out.ptr(r));
+
+    const int blocksPerRow = cover.cols / DCT_BLOCK;
+    const std::size_t N = std::min(bits.size(), static_cast<std::size_t>(cover.rows / DCT_BLOCK) * blocksPerRow);
+
+    forEachPayloadStrip(N, blocksPerRow, threads, [&](std::size_t s, int blocks) {
+        const int r = static_cast<int>(s) * DCT_BLOCK;
+        const int width = blocks * DCT_BLOCK;
+        std::vector<float> strip(static_cast<std::size_t>(DCT_BLOCK) * width);
+        loadStrip(cover, r, width, strip.data());
+        forwardDCTStrip(strip.data(), width, strip.data(), width, blocks);
+
+        std::size_t id = s * blocksPerRow;
+        for (int b = 0; b < blocks; ++b, ++id) {
+            float& coeff = strip[u * width + b * DCT_BLOCK + v];
+            int bit = bits[id];
+            if ((std::abs(static_cast<int>(std::round(coeff))) & 1) != bit) {
+                // 奇偶性不符：先嘗試加減 step，都無效時強制設為絕對值較大的整數
+                if (std::abs(static_cast<int>(std::round(coeff + step))) % 2 == bit) {
+                    coeff += step;
+                } else if (std::abs(static_cast<int>(std::round(coeff - step))) % 2 == bit) {
+                    coeff -= step;
+                } else {
+                    coeff = bit ? 5.0f : -6.0f;
+                }
+            }
+        }
+
+        inverseDCTStrip(strip.data(), width, strip.data(), width, blocks);
+        for (int y = 0; y < DCT_BLOCK; ++y) {
+            const float* in = strip.data() + y * width;
+            std::uint8_t* o = out.ptr(r + y);
+            for (int x = 0; x < width; ++x) o[x] = static_cast<std::uint8_t>(std::clamp(std::lrint(in[x]), 0L, 255L));
+        }
+    });
+    bitsEmbedded = N;
+    return out;
+}
+
+BitBuffer extractDCTParity (ConstGrayView stego, std::size_t numBits, int u, int v, int threads) {
+    const int blocksPerRow = stego.cols / DCT_BLOCK;
+    const std::size_t N = std::min(numBits, static_cast<std::size_t>(stego.rows / DCT_BLOCK) * blocksPerRow);
+
+    // 各條帶先寫入自己的位置，最後再依序打包
+    std::vector<std::uint8_t> flags(N);
+    forEachPayloadStrip(N, blocksPerRow, threads, [&](std::size_t s, int blocks) {
+        const int width = blocks * DCT_BLOCK;
+        std::vector<float> strip(static_cast<std::size_t>(DCT_BLOCK) * width);
+        loadStrip(stego, static_cast<int>(s) * DCT_BLOCK, width, strip.data());
+        forwardDCTStrip(strip.data(), width, strip.data(), width, blocks);
+        std::uint8_t* f = flags.data() + s * blocksPerRow;
+        for (int b = 0; b < blocks; ++b) f[b] = std::abs(static_cast<int>(std::round(strip[u * width + b * DCT_BLOCK + v]))) & 1;
+    });
+
+    BitWriter writer(N);
+    for (std::uint8_t f : flags) writer.put(f != 0);
+    return writer.take();
+}
+
+}  // namespace stego
@@ -0,0 +1,251 @@
+#include "stego/dct.hpp"
+
+#include <cmath>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define STEGO_DCT_X86 1
+#endif
+
+namespace stego {
+
+namespace {
+
+// --- AAN (Arai-Agui-Nakajima) 8 點 DCT ---
+// 與 IJG jfdctflt / jidctflt 相同的分解，每個一維轉換只需 5 (正向) 或 5 (反向) 個乘法
+// 正規化 (對應 cv::dct 的正交 DCT) 合併成轉換前後的一次逐元素乘法
+// 純量與 AVX 版本使用同一個模板，運算順序完全相同，因此兩者結果逐位元一致
+// (不要開啟 FMA，否則兩條路徑的捨入會不同)
+
+#define STEGO_INLINE inline __attribute__((always_inline))
+
+template <typename V>
+STEGO_INLINE void fdct8 (V& d0, V& d1, V& d2, V& d3, V& d4, V& d5, V& d6, V& d7) {
+    V tmp0 = d0 + d7, tmp7 = d0 - d7;
+    V tmp1 = d1 + d6, tmp6 = d1 - d6;
+    V tmp2 = d2 + d5, tmp5 = d2 - d5;
+    V tmp3 = d3 + d4, tmp4 = d3 - d4;
+
+    // 偶數部分
+    V tmp10 = tmp0 + tmp3, tmp13 = tmp0 - tmp3;
+    V tmp11 = tmp1 + tmp2, tmp12 = tmp1 - tmp2;
+    d0 = tmp10 + tmp11;
+    d4 = tmp10 - tmp11;
+    V z1 = (tmp12 + tmp13) * 0.707106781f;
+    d2 = tmp13 + z1;
+    d6 = tmp13 - z1;
+
+    // 奇數部分
+    tmp10 = tmp4 + tmp5;
+    tmp11 = tmp5 + tmp6;
+    tmp12 = tmp6 + tmp7;
+    V z5 = (tmp10 - tmp12) * 0.382683433f;
+    V z2 = tmp10 * 0.541196100f + z5;
+    V z4 = tmp12 * 1.306562965f + z5;
+    V z3 = tmp11 * 0.707106781f;
+    V z11 = tmp7 + z3, z13 = tmp7 - z3;
+    d5 = z13 + z2;
+    d3 = z13 - z2;
+    d1 = z11 + z4;
+    d7 = z11 - z4;
+}
+
+template <typename V>
+STEGO_INLINE void idct8 (V& d0, V& d1, V& d2, V& d3, V& d4, V& d5, V& d6, V& d7) {
+    // 偶數部分
+    V tmp10 = d0 + d4, tmp11 = d0 - d4;
+    V tmp13 = d2 + d6;
+    V tmp12 = (d2 - d6) * 1.414213562f - tmp13;
+    V tmp0 = tmp10 + tmp13, tmp3 = tmp10 - tmp13;
+    V tmp1 = tmp11 + tmp12, tmp2 = tmp11 - tmp12;
+
+    // 奇數部分
+    V z13 = d5 + d3, z10 = d5 - d3;
+    V z11 = d1 + d7, z12 = d1 - d7;
+    V tmp7 = z11 + z13;
+    tmp11 = (z11 - z13) * 1.414213562f;
+    V z5 = (z10 + z12) * 1.847759065f;
+    tmp10 = z5 - z12 * 1.082392200f;
+    tmp12 = z5 - z10 * 2.613125930f;
+    V tmp6 = tmp12 - tmp7;
+    V tmp5 = tmp11 - tmp6;
+    V tmp4 = tmp10 - tmp5;
+
+    d0 = tmp0 + tmp7;
+    d7 = tmp0 - tmp7;
+    d1 = tmp1 + tmp6;
+    d6 = tmp1 - tmp6;
+    d2 = tmp2 + tmp5;
+    d5 = tmp2 - tmp5;
+    d3 = tmp3 + tmp4;
+    d4 = tmp3 - tmp4;
+}
+
+// 正規化係數: 正向輸出乘 fwd，反向輸入乘 inv (列優先 8x8)
+struct AANScale {
+    alignas(32) float fwd[DCT_BLOCK * DCT_BLOCK];
+    alignas(32) float inv[DCT_BLOCK * DCT_BLOCK];
+    AANScale () {
+        const double pi = std::acos(-1.0);
+        double a[DCT_BLOCK];
+        for (int k = 0; k < DCT_BLOCK; ++k) a[k] = k == 0 ? 1.0 : std::cos(k * pi / 16.0) * std::sqrt(2.0);
+        for (int u = 0; u < DCT_BLOCK; ++u) {
+            for (int v = 0; v < DCT_BLOCK; ++v) {
+                fwd[u * DCT_BLOCK + v] = static_cast<float>(1.0 / (8.0 * a[u] * a[v]));
+                inv[u * DCT_BLOCK + v] = static_cast<float>(a[u] * a[v] / 8.0);
+            }
+        }
+    }
+};
+
+const AANScale& scale () {
+    static const AANScale s;
+    return s;
+}
+
+// --- 純量版本: 先對每一行做一維轉換，再對每一列 ---
+void forwardBlockScalar (const float* src, std::ptrdiff_t srcStep, float* dst, std::ptrdiff_t dstStep, const float* fwd) {
+    float t[DCT_BLOCK][DCT_BLOCK];
+    for (int y = 0; y < DCT_BLOCK; ++y) std::memcpy(t[y], src + y * srcStep, sizeof(t[y]));
+    for (int x = 0; x < DCT_BLOCK; ++x) fdct8(t[0][x], t[1][x], t[2][x], t[3][x], t[4][x], t[5][x], t[6][x], t[7][x]);
+    for (int y = 0; y < DCT_BLOCK; ++y) fdct8(t[y][0], t[y][1], t[y][2], t[y][3], t[y][4], t[y][5], t[y][6], t[y][7]);
+    for (int y = 0; y < DCT_BLOCK; ++y) {
+        for (int x = 0; x < DCT_BLOCK; ++x) dst[y * dstStep + x] = t[y][x] * fwd[y * DCT_BLOCK + x];
+    }
+}
+
+void inverseBlockScalar (const float* src, std::ptrdiff_t srcStep, float* dst, std::ptrdiff_t dstStep, const float* inv) {
+    float t[DCT_BLOCK][DCT_BLOCK];
+    for (int y = 0; y < DCT_BLOCK; ++y) {
+        for (int x = 0; x < DCT_BLOCK; ++x) t[y][x] = src[y * srcStep + x] * inv[y * DCT_BLOCK + x];
+    }
+    for (int x = 0; x < DCT_BLOCK; ++x) idct8(t[0][x], t[1][x], t[2][x], t[3][x], t[4][x], t[5][x], t[6][x], t[7][x]);
+    for (int y = 0; y < DCT_BLOCK; ++y) idct8(t[y][0], t[y][1], t[y][2], t[y][3], t[y][4], t[y][5], t[y][6], t[y][7]);
+    for (int y = 0; y < DCT_BLOCK; ++y) std::memcpy(dst + y * dstStep, t[y], sizeof(t[y]));
+}
+
+void forwardStripScalar (const float* src, std::ptrdiff_t srcStep, float* dst, std::ptrdiff_t dstStep, int blocks) {
+    const float* fwd = scale().fwd;
+    for (int b = 0; b < blocks; ++b) forwardBlockScalar(src + b * DCT_BLOCK, srcStep, dst + b * DCT_BLOCK, dstStep, fwd);
+}
+
+void inverseStripScalar (const float* src, std::ptrdiff_t srcStep, float* dst, std::ptrdiff_t dstStep, int blocks) {
+    const float* inv = scale().inv;
+    for (int b = 0; b < blocks; ++b) inverseBlockScalar(src + b * DCT_BLOCK, srcStep, dst + b * DCT_BLOCK, dstStep, inv);
+}
+
+#ifdef STEGO_DCT_X86
+
+// --- AVX 版本: 8 列各佔一個暫存器，一維轉換在暫存器之間逐元素進行 (即對每一行轉換)，轉置後再做一次 ---
+__attribute__((target("avx"))) STEGO_INLINE void transpose8 (__m256& r0, __m256& r1, __m256& r2, __m256& r3, __m256& r4, __m256& r5, __m256& r6, __m256& r7) {
+    __m256 t0 = _mm256_unpacklo_ps(r0, r1), t1 = _mm256_unpackhi_ps(r0, r1);
+    __m256 t2 = _mm256_unpacklo_ps(r2, r3), t3 = _mm256_unpackhi_ps(r2, r3);
+    __m256 t4 = _mm256_unpacklo_ps(r4, r5), t5 = _mm256_unpackhi_ps(r4, r5);
+    __m256 t6 = _mm256_unpacklo_ps(r6, r7), t7 = _mm256_unpackhi_ps(r6, r7);
+    __m256 s0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0)), s1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+    __m256 s2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0)), s3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+    __m256 s4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0)), s5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+    __m256 s6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0)), s7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+    r0 = _mm256_permute2f128_ps(s0, s4, 0x20);
+    r1 = _mm256_permute2f128_ps(s1, s5, 0x20);
+    r2 = _mm256_permute2f128_ps(s2, s6, 0x20);
+    r3 = _mm256_permute2f128_ps(s3, s7, 0x20);
+    r4 = _mm256_permute2f128_ps(s0, s4, 0x31);
+    r5 = _mm256_permute2f128_ps(s1, s5, 0x31);
+    r6 = _mm256_permute2f128_ps(s2, s6, 0x31);
+    r7 = _mm256_permute2f128_ps(s3, s7, 0x31);
+}
+
+__attribute__((target("avx"))) void forwardStripAVX (const float* src, std::ptrdiff_t srcStep, float* dst, std::ptrdiff_t dstStep, int blocks) {
+    const float* fwd = scale().fwd;
+    for (int b = 0; b < blocks; ++b, src += DCT_BLOCK, dst += DCT_BLOCK) {
+        __m256 r0 = _mm256_loadu_ps(src), r1 = _mm256_loadu_ps(src + srcStep);
+        __m256 r2 = _mm256_loadu_ps(src + 2 * srcStep), r3 = _mm256_loadu_ps(src + 3 * srcStep);
+        __m256 r4 = _mm256_loadu_ps(src + 4 * srcStep), r5 = _mm256_loadu_ps(src + 5 * srcStep);
+        __m256 r6 = _mm256_loadu_ps(src + 6 * srcStep), r7 = _mm256_loadu_ps(src + 7 * srcStep);
+        fdct8(r0, r1, r2, r3, r4, r5, r6, r7);
+        transpose8(r0, r1, r2, r3, r4, r5, r6, r7);
+        fdct8(r0, r1, r2, r3, r4, r5, r6, r7);
+        transpose8(r0, r1, r2, r3, r4, r5, r6, r7);
+        _mm256_storeu_ps(dst, r0 * _mm256_load_ps(fwd));
+        _mm256_storeu_ps(dst + dstStep, r1 * _mm256_load_ps(fwd + 8));
+        _mm256_storeu_ps(dst + 2 * dstStep, r2 * _mm256_load_ps(fwd + 16));
+        _mm256_storeu_ps(dst + 3 * dstStep, r3 * _mm256_load_ps(fwd + 24));
+        _mm256_storeu_ps(dst + 4 * dstStep, r4 * _mm256_load_ps(fwd + 32));
+        _mm256_storeu_ps(dst + 5 * dstStep, r5 * _mm256_load_ps(fwd + 40));
+        _mm256_storeu_ps(dst + 6 * dstStep, r6 * _mm256_load_ps(fwd + 48));
+        _mm256_storeu_ps(dst + 7 * dstStep, r7 * _mm256_load_ps(fwd + 56));
+    }
+}
+
+__attribute__((target("avx"))) void inverseStripAVX (const float* src, std::ptrdiff_t srcStep, float* dst, std::ptrdiff_t dstStep, int blocks) {
+    const float* inv = scale().inv;
+    for (int b = 0; b < blocks; ++b, src += DCT_BLOCK, dst += DCT_BLOCK) {
+        __m256 r0 = _mm256_loadu_ps(src) * _mm256_load_ps(inv);
+        __m256 r1 = _mm256_loadu_ps(src + srcStep) * _mm256_load_ps(inv + 8);
+        __m256 r2 = _mm256_loadu_ps(src + 2 * srcStep) * _mm256_load_ps(inv + 16);
+        __m256 r3 = _mm256_loadu_ps(src + 3 * srcStep) * _mm256_load_ps(inv + 24);
+        __m256 r4 = _mm256_loadu_ps(src + 4 * srcStep) * _mm256_load_ps(inv + 32);
+        __m256 r5 = _mm256_loadu_ps(src + 5 * srcStep) * _mm256_load_ps(inv + 40);
+        __m256 r6 = _mm256_loadu_ps(src + 6 * srcStep) * _mm256_load_ps(inv + 48);
+        __m256 r7 = _mm256_loadu_ps(src + 7 * srcStep) * _mm256_load_ps(inv + 56);
+        idct8(r0, r1, r2, r3, r4, r5, r6, r7);
+        transpose8(r0, r1, r2, r3, r4, r5, r6, r7);
+        idct8(r0, r1, r2, r3, r4, r5, r6, r7);
+        transpose8(r0, r1, r2, r3, r4, r5, r6, r7);
+        _mm256_storeu_ps(dst, r0);
+        _mm256_storeu_ps(dst + dstStep, r1);
+        _mm256_storeu_ps(dst + 2 * dstStep, r2);
+        _mm256_storeu_ps(dst + 3 * dstStep, r3);
+        _mm256_storeu_ps(dst + 4 * dstStep, r4);
+        _mm256_storeu_ps(dst + 5 * dstStep, r5);
+        _mm256_storeu_ps(dst + 6 * dstStep, r6);
+        _mm256_storeu_ps(dst + 7 * dstStep, r7);
+    }
+}
+
+#endif  // STEGO_DCT_X86
+
+using StripFn = void (*)(const float*, std::ptrdiff_t, float*, std::ptrdiff_t, int);
+
+struct StripKernels {
+    StripFn forward = forwardStripScalar;
+    StripFn inverse = inverseStripScalar;
+};
+
+const StripKernels& kernels () {
+    static const StripKernels k = [] {
+        StripKernels s;
+#ifdef STEGO_DCT_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx")) {
+            s.forward = forwardStripAVX;
+            s.inverse = inverseStripAVX;
+        }
+#endif
+        scale();  // 先建立正規化表，避免多執行緒第一次呼叫時競爭
+        return s;
+    }();
+    return k;
+}
+
+}  // namespace
+
+void forwardDCTStrip (const float* src, std::ptrdiff_t srcStep, float* dst, std::ptrdiff_t dstStep, int blocks) {
+    kernels().forward(src, srcStep, dst, dstStep, blocks);
+}
+
+void inverseDCTStrip (const float* src, std::ptrdiff_t srcStep, float* dst, std::ptrdiff_t dstStep, int blocks) {
+    kernels().inverse(src, srcStep, dst, dstStep, blocks);
+}
+
+void forwardDCT8x8 (const float* src, std::ptrdiff_t srcStep, float* dst, std::ptrdiff_t dstStep) {
+    kernels().forward(src, srcStep, dst, dstStep, 1);
+}
+
+void inverseDCT8x8 (const float* src, std::ptrdiff_t srcStep, float* dst, std::ptrdiff_t dstStep) {
+    kernels().inverse(src, srcStep, dst, dstStep, 1);
+}
+
+}  // namespace stego
@@ -0,0 +1,251 @@
+#include "stego/dwt.hpp"
+
+#include <algorithm>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define STEGO_DWT_X86 1
+#endif
+
+#include "dwt_kernels.hpp"
+
+namespace stego {
+
+namespace {
+
+// 一層轉換的輸入/輸出列指標；half 為子帶寬度
+// forward: 兩列 in0/in1 (各 2 * half 個樣本) -> 四個子帶列 ll/hl/lh/hh
+// inverse: 四個子帶列 -> 兩列 out0/out1
+using ForwardPairFn = void (*)(const float* in0, const float* in1, int half, float* ll, float* hl, float* lh, float* hh, float s);
+using InversePairFn = void (*)(const float* ll, const float* hl, const float* lh, const float* hh, int half, float* out0, float* out1, float s);
+
+// 正向: L = (a + b) * s, H = (a - b) * s，先列後行；反向: a = (L + H) * s, b = (L - H) * s，先行後列
+void forwardPairScalar (const float* in0, const float* in1, int half, float* ll, float* hl, float* lh, float* hh, float s) {
+    for (int j = 0; j < half; ++j) {
+        const float a0 = in0[2 * j], b0 = in0[2 * j + 1];
+        const float a1 = in1[2 * j], b1 = in1[2 * j + 1];
+        const float l0 = (a0 + b0) * s, h0 = (a0 - b0) * s;
+        const float l1 = (a1 + b1) * s, h1 = (a1 - b1) * s;
+        ll[j] = (l0 + l1) * s;
+        lh[j] = (l0 - l1) * s;
+        hl[j] = (h0 + h1) * s;
+        hh[j] = (h0 - h1) * s;
+    }
+}
+
+void inversePairScalar (const float* ll, const float* hl, const float* lh, const float* hh, int half, float* out0, float* out1, float s) {
+    for (int j = 0; j < half; ++j) {
+        const float l0 = (ll[j] + lh[j]) * s, l1 = (ll[j] - lh[j]) * s;
+        const float h0 = (hl[j] + hh[j]) * s, h1 = (hl[j] - hh[j]) * s;
+        out0[2 * j] = (l0 + h0) * s;
+        out0[2 * j + 1] = (l0 - h0) * s;
+        out1[2 * j] = (l1 + h1) * s;
+        out1[2 * j + 1] = (l1 - h1) * s;
+    }
+}
+
+#ifdef STEGO_DWT_X86
+
+// 16 個連續樣本拆成偶數位置與奇數位置各 8 個
+__attribute__((target("avx2"))) inline void deinterleave (const float* p, __m256& even, __m256& odd) {
+    const __m256 lo = _mm256_loadu_ps(p), hi = _mm256_loadu_ps(p + 8);
+    even = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(_mm256_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0))), _MM_SHUFFLE(3, 1, 2, 0)));
+    odd = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(_mm256_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 1, 3, 1))), _MM_SHUFFLE(3, 1, 2, 0)));
+}
+
+// deinterleave 的反向: 交錯寫出 even[0], odd[0], even[1], ...
+__attribute__((target("avx2"))) inline void interleave (float* p, __m256 even, __m256 odd) {
+    const __m256 lo = _mm256_unpacklo_ps(even, odd), hi = _mm256_unpackhi_ps(even, odd);
+    _mm256_storeu_ps(p, _mm256_permute2f128_ps(lo, hi, 0x20));
+    _mm256_storeu_ps(p + 8, _mm256_permute2f128_ps(lo, hi, 0x31));
+}
+
+__attribute__((target("avx2"))) void forwardPairAVX2 (const float* in0, const float* in1, int half, float* ll, float* hl, float* lh, float* hh, float s) {
+    const __m256 vs = _mm256_set1_ps(s);
+    int j = 0;
+    for (; j + 8 <= half; j += 8) {
+        __m256 a0, b0, a1, b1;
+        deinterleave(in0 + 2 * j, a0, b0);
+        deinterleave(in1 + 2 * j, a1, b1);
+        const __m256 l0 = _mm256_mul_ps(_mm256_add_ps(a0, b0), vs), h0 = _mm256_mul_ps(_mm256_sub_ps(a0, b0), vs);
+        const __m256 l1 = _mm256_mul_ps(_mm256_add_ps(a1, b1), vs), h1 = _mm256_mul_ps(_mm256_sub_ps(a1, b1), vs);
+        _mm256_storeu_ps(ll + j, _mm256_mul_ps(_mm256_add_ps(l0, l1), vs));
+        _mm256_storeu_ps(lh + j, _mm256_mul_ps(_mm256_sub_ps(l0, l1), vs));
+        _mm256_storeu_ps(hl + j, _mm256_mul_ps(_mm256_add_ps(h0, h1), vs));
+        _mm256_storeu_ps(hh + j, _mm256_mul_ps(_mm256_sub_ps(h0, h1), vs));
+    }
+    forwardPairScalar(in0 + 2 * j, in1 + 2 * j, half - j, ll + j, hl + j, lh + j, hh + j, s);
+}
+
+__attribute__((target("avx2"))) void inversePairAVX2 (const float* ll, const float* hl, const float* lh, const float* hh, int half, float* out0, float* out1, float s) {
+    const __m256 vs = _mm256_set1_ps(s);
+    int j = 0;
+    for (; j + 8 <= half; j += 8) {
+        const __m256 vll = _mm256_loadu_ps(ll + j), vlh = _mm256_loadu_ps(lh + j);
+        const __m256 vhl = _mm256_loadu_ps(hl + j), vhh = _mm256_loadu_ps(hh + j);
+        const __m256 l0 = _mm256_mul_ps(_mm256_add_ps(vll, vlh), vs), l1 = _mm256_mul_ps(_mm256_sub_ps(vll, vlh), vs);
+        const __m256 h0 = _mm256_mul_ps(_mm256_add_ps(vhl, vhh), vs), h1 = _mm256_mul_ps(_mm256_sub_ps(vhl, vhh), vs);
+        interleave(out0 + 2 * j, _mm256_mul_ps(_mm256_add_ps(l0, h0), vs), _mm256_mul_ps(_mm256_sub_ps(l0, h0), vs));
+        interleave(out1 + 2 * j, _mm256_mul_ps(_mm256_add_ps(l1, h1), vs), _mm256_mul_ps(_mm256_sub_ps(l1, h1), vs));
+    }
+    inversePairScalar(ll + j, hl + j, lh + j, hh + j, half - j, out0 + 2 * j, out1 + 2 * j, s);
+}
+
+#endif  // STEGO_DWT_X86
+
+struct PairKernels {
+    ForwardPairFn forward = forwardPairScalar;
+    InversePairFn inverse = inversePairScalar;
+};
+
+const PairKernels& kernels () {
+    static const PairKernels k = [] {
+        PairKernels p;
+#ifdef STEGO_DWT_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            p.forward = forwardPairAVX2;
+            p.inverse = inversePairAVX2;
+        }
+#endif
+        return p;
+    }();
+    return k;
+}
+
+float forwardScale (HaarScaling scaling) { return scaling == HaarScaling::Average ? 0.5f : 0.70710678f; }
+float inverseScale (HaarScaling scaling) { return scaling == HaarScaling::Average ? 1.0f : 0.70710678f; }
+
+bool validLevels (ImageView<const float> src, ImageView<const float> dst, int levels) {
+    if (src.empty() || src.channels != 1 || dst.channels != 1 || src.rows != dst.rows || src.cols != dst.cols) return false;
+    if (levels < 1 || levels > 30) return false;
+    const int mask = (1 << levels) - 1;
+    return (src.rows & mask) == 0 && (src.cols & mask) == 0;
+}
+
+// 兩塊交替使用的 LL 暫存 (1/4 與 1/16 大小)，level 從 1 起算
+struct LLBuffers {
+    std::vector<float> a, b;
+
+    LLBuffers (int rows, int cols, int levels) {
+        if (levels > 1) a.resize(static_cast<std::size_t>(rows / 2) * (cols / 2));
+        if (levels > 2) b.resize(static_cast<std::size_t>(rows / 4) * (cols / 4));
+    }
+
+    // 第 level 層 LL 的存放位置 (最後一層直接寫在 dst)
+    ImageView<float> at (ImageView<float> dst, int level, int levels) {
+        const int rows = dst.rows >> level, cols = dst.cols >> level;
+        if (level == levels) return dst.roi(0, 0, cols, rows);
+        return ImageView<float>((level % 2 ? a : b).data(), rows, cols);
+    }
+};
+
+}  // namespace
+
+namespace detail {
+
+void forwardHaarRowPair (const float* in0, const float* in1, int half, float* ll, float* hl, float* lh, float* hh, HaarScaling scaling) {
+    kernels().forward(in0, in1, half, ll, hl, lh, hh, forwardScale(scaling));
+}
+
+}  // namespace detail
+
+bool forwardHaarDWT (ImageView<const float> src, ImageView<float> dst, int levels, HaarScaling scaling) {
+    if (!validLevels(src, dst, levels)) return false;
+    const ForwardPairFn pair = kernels().forward;
+    const float s = forwardScale(scaling);
+    LLBuffers buffers(src.rows, src.cols, levels);
+
+    ImageView<const float> in = src;
+    for (int level = 1; level <= levels; ++level) {
+        ImageView<float> ll = buffers.at(dst, level, levels);
+        ImageView<float> hl = subband(dst, level, Subband::HL);
+        ImageView<float> lh = subband(dst, level, Subband::LH);
+        ImageView<float> hh = subband(dst, level, Subband::HH);
+        for (int i = 0; i < ll.rows; ++i) pair(in.ptr(2 * i), in.ptr(2 * i + 1), ll.cols, ll.ptr(i), hl.ptr(i), lh.ptr(i), hh.ptr(i), s);
+        in = ll;
+    }
+    return true;
+}
+
+bool inverseHaarDWT (ImageView<const float> src, ImageView<float> dst, int levels, HaarScaling scaling) {
+    if (!validLevels(src, dst, levels)) return false;
+    const InversePairFn pair = kernels().inverse;
+    const float s = inverseScale(scaling);
+    LLBuffers buffers(src.rows, src.cols, levels);
+
+    // 最深一層的 LL 在 src；每一層的輸出是上一層的 LL (第 1 層輸出到 dst)
+    ImageView<const float> ll = subband(src, levels, Subband::LL);
+    for (int level = levels; level >= 1; --level) {
+        ImageView<float> out = level == 1 ? dst : buffers.at(dst, level - 1, levels);
+        ImageView<const float> hl = subband(src, level, Subband::HL);
+        ImageView<const float> lh = subband(src, level, Subband::LH);
+        ImageView<const float> hh = subband(src, level, Subband::HH);
+        for (int i = 0; i < ll.rows; ++i) pair(ll.ptr(i), hl.ptr(i), lh.ptr(i), hh.ptr(i), ll.cols, out.ptr(2 * i), out.ptr(2 * i + 1), s);
+        ll = out;
+    }
+    return true;
+}
+
+
+bool streamHaarDWT (int rows, int cols, const GrayRowSource& source, const SubbandRowSink& sink, int levels, HaarScaling scaling, bool everyLevelLL) {
+    if (levels < 1 || levels > 30) return false;
+    const int mask = (1 << levels) - 1;
+    const int sourceCols = cols;  // 來源每次寫出完整的一列
+    rows &= ~mask;  // 只處理能被 2^levels 整除的部分
+    cols &= ~mask;
+    if (rows <= 0 || cols <= 0) return false;
+
+    // 每層保留一列等待配對 (pending)，以及一組四個子帶的輸出列
+    struct Level {
+        int width = 0;
+        int row = 0;  // 下一個輸出列的編號
+        bool hasPending = false;
+        std::vector<float> pending, ll, hl, lh, hh;
+    };
+    std::vector<Level> state(levels);
+    for (int k = 0; k < levels; ++k) {
+        Level& s = state[k];
+        s.width = cols >> k;
+        s.pending.resize(s.width);
+        s.ll.resize(s.width / 2);
+        s.hl.resize(s.width / 2);
+        s.lh.resize(s.width / 2);
+        s.hh.resize(s.width / 2);
+    }
+
+    // 第 k 層 (0 起算) 收到一列輸入；湊成一對就輸出第 k + 1 層的子帶列，LL 再往下一層送
+    auto push = [&](int k, const float* row) {
+        for (;;) {
+            Level& s = state[k];
+            if (!s.hasPending) {
+                std::copy(row, row + s.width, s.pending.begin());
+                s.hasPending = true;
+                return true;
+            }
+            s.hasPending = false;
+            const int half = s.width / 2, level = k + 1, r = s.row++;
+            detail::forwardHaarRowPair(s.pending.data(), row, half, s.ll.data(), s.hl.data(), s.lh.data(), s.hh.data(), scaling);
+            if (!sink(level, Subband::HL, r, s.hl.data(), half) || !sink(level, Subband::LH, r, s.lh.data(), half) ||
+                !sink(level, Subband::HH, r, s.hh.data(), half)) {
+                return false;
+            }
+            if (level == levels) return sink(level, Subband::LL, r, s.ll.data(), half);
+            if (everyLevelLL && !sink(level, Subband::LL, r, s.ll.data(), half)) return false;
+            row = s.ll.data();
+            ++k;
+        }
+    };
+
+    std::vector<std::uint8_t> pixels(sourceCols);
+    std::vector<float> input(cols);
+    for (int r = 0; r < rows; ++r) {
+        if (!source(r, pixels.data())) return false;
+        std::copy(pixels.begin(), pixels.begin() + cols, input.begin());
+        if (!push(0, input.data())) return false;
+    }
+    return true;
+}
+
+}  // namespace stego
@@ -0,0 +1,14 @@
+#pragma once
+
+#include "stego/dwt.hpp"
+
+namespace stego {
+namespace detail {
+
+// --- Haar DWT 列對核心 ---
+// 兩列 in0/in1 (各 2 * half 個樣本) 轉成四個子帶列 ll/hl/lh/hh (各 half 個係數)
+// 依 CPU 選擇 AVX2 或純量版本，結果逐位元相同；forwardHaarDWT 與 streamHaarDWT 共用
+void forwardHaarRowPair (const float* in0, const float* in1, int half, float* ll, float* hl, float* lh, float* hh, HaarScaling scaling);
+
+}  // namespace detail
+}  // namespace stego
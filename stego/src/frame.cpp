@@ -0,0 +1,170 @@
+#include "stego/frame.hpp"
+
+#include <cstring>
+#include <limits>
+
+#include "stego/bits.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define STEGO_CRC_X86 1
+#endif
+
+namespace stego {
+
+namespace {
+
+// 反射形式的 Castagnoli 多項式
+constexpr std::uint32_t CRC32C_POLY = 0x82F63B78u;
+
+struct CrcTable {
+    std::uint32_t t[256] = {};
+    constexpr CrcTable () {
+        for (std::uint32_t i = 0; i < 256; ++i) {
+            std::uint32_t c = i;
+            for (int k = 0; k < 8; ++k) c = (c >> 1) ^ ((c & 1) ? CRC32C_POLY : 0);
+            t[i] = c;
+        }
+    }
+};
+
+constexpr CrcTable CRC_TABLE{};
+
+std::uint32_t crc32cTable (const std::uint8_t* p, std::size_t n, std::uint32_t crc) {
+    for (std::size_t i = 0; i < n; ++i) crc = CRC_TABLE.t[(crc ^ p[i]) & 0xFF] ^ (crc >> 8);
+    return crc;
+}
+
+#ifdef STEGO_CRC_X86
+__attribute__((target("sse4.2"))) std::uint32_t crc32cHW (const std::uint8_t* p, std::size_t n, std::uint32_t crc) {
+    std::size_t i = 0;
+#if defined(__x86_64__)
+    std::uint64_t c = crc;
+    for (; i + 8 <= n; i += 8) {
+        std::uint64_t v;
+        std::memcpy(&v, p + i, 8);
+        c = _mm_crc32_u64(c, v);
+    }
+    crc = static_cast<std::uint32_t>(c);
+#endif
+    for (; i < n; ++i) crc = _mm_crc32_u8(crc, p[i]);
+    return crc;
+}
+#endif
+
+using CrcFn = std::uint32_t (*)(const std::uint8_t*, std::size_t, std::uint32_t);
+
+CrcFn crcImpl () {
+    static const CrcFn fn = [] {
+#ifdef STEGO_CRC_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("sse4.2")) return &crc32cHW;
+#endif
+        return &crc32cTable;
+    }();
+    return fn;
+}
+
+void putBE16 (std::uint8_t* p, std::uint16_t v) {
+    p[0] = static_cast<std::uint8_t>(v >> 8);
+    p[1] = static_cast<std::uint8_t>(v);
+}
+
+void putBE32 (std::uint8_t* p, std::uint32_t v) {
+    for (int i = 0; i < 4; ++i) p[i] = static_cast<std::uint8_t>(v >> (24 - 8 * i));
+}
+
+std::uint32_t getBE32 (const std::uint8_t* p) {
+    return (std::uint32_t(p[0]) << 24) | (std::uint32_t(p[1]) << 16) | (std::uint32_t(p[2]) << 8) | p[3];
+}
+
+}  // namespace
+
+std::uint32_t crc32c (const void* data, std::size_t size, std::uint32_t crc) {
+    return ~crcImpl()(static_cast<const std::uint8_t*>(data), size, ~crc);
+}
+
+BitBuffer frameHeader (const BitBuffer& payload, FrameAlgorithm algorithm, std::uint16_t param) {
+    // 長度欄位只有 32 位元，超過就無法正確記錄
+    if (payload.size() > std::numeric_limits<std::uint32_t>::max()) return BitBuffer();
+    std::uint8_t h[FRAME_HEADER_BYTES];
+    putBE32(h, FRAME_MAGIC);
+    h[4] = FRAME_VERSION;
+    h[5] = static_cast<std::uint8_t>(algorithm);
+    putBE16(h + 6, param);
+    putBE32(h + 8, static_cast<std::uint32_t>(payload.size()));
+    putBE32(h + 12, crc32c(payload.data(), payload.byteSize()));
+    return BitBuffer::fromBytes(h, sizeof(h));
+}
+
+BitBuffer frame (const BitBuffer& payload, FrameAlgorithm algorithm, std::uint16_t param) {
+    BitBuffer header = frameHeader(payload, algorithm, param);
+    if (header.empty()) return header;
+    BitWriter w(FRAME_HEADER_BITS + payload.size());
+    w.writeBits(header);
+    w.writeBits(payload);
+    return w.take();
+}
+
+BitBuffer frameMessage (const std::string& message, FrameAlgorithm algorithm, std::uint16_t param) {
+    return frame(stringToBits(message), algorithm, param);
+}
+
+FrameStatus parseFrameHeader (const std::uint8_t* header, FrameAlgorithm algorithm, std::uint16_t param, std::size_t maxPayloadBits, FrameHeader& out) {
+    if (getBE32(header) != FRAME_MAGIC) return FrameStatus::BadMagic;
+    if (header[4] != FRAME_VERSION) return FrameStatus::BadVersion;
+    out.algorithm = static_cast<FrameAlgorithm>(header[5]);
+    out.param = static_cast<std::uint16_t>((header[6] << 8) | header[7]);
+    out.payloadBits = getBE32(header + 8);
+    out.crc = getBE32(header + 12);
+    if (out.algorithm != algorithm || out.param != param) return FrameStatus::BadParameters;
+    if (out.payloadBits > maxPayloadBits) return FrameStatus::TooLong;
+    return FrameStatus::Ok;
+}
+
+FrameStatus verifyFramePayload (const FrameHeader& header, const BitBuffer& payload) {
+    if (payload.size() != header.payloadBits) return FrameStatus::Incomplete;
+    return crc32c(payload.data(), payload.byteSize()) == header.crc ? FrameStatus::Ok : FrameStatus::BadChecksum;
+}
+
+FrameReader::FrameReader (FrameAlgorithm algorithm, std::uint16_t param, std::size_t maxPayloadBits)
+    : algorithm_(algorithm), param_(param), maxPayloadBits_(maxPayloadBits) {}
+
+bool FrameReader::push (std::uint8_t byte) {
+    if (status_ != FrameStatus::Incomplete) return false;
+
+    if (received_ < FRAME_HEADER_BYTES) {
+        headerBytes_[received_++] = byte;
+        // magic 收齊就先檢查，錯誤的載體不必再讀
+        if (received_ == 4 && getBE32(headerBytes_) != FRAME_MAGIC) {
+            status_ = FrameStatus::BadMagic;
+            return false;
+        }
+        if (received_ < FRAME_HEADER_BYTES) return true;
+
+        FrameStatus s = parseFrameHeader(headerBytes_, algorithm_, param_, maxPayloadBits_, header_);
+        if (s != FrameStatus::Ok) {
+            status_ = s;
+            return false;
+        }
+        payloadBytes_ = (header_.payloadBits + 7) / 8;
+        writer_ = BitWriter(header_.payloadBits);  // 長度已知，事先配置
+        if (payloadBytes_ > 0) return true;
+    } else {
+        writer_.write(byte, 8);
+        ++received_;
+        if (received_ - FRAME_HEADER_BYTES < payloadBytes_) return true;
+    }
+
+    payload_ = writer_.take();
+    payload_.resize(header_.payloadBits);  // 清除最後一個位元組多讀的位元
+    status_ = verifyFramePayload(header_, payload_);
+    return false;
+}
+
+std::string FrameReader::takeMessage (FrameStatus* status) {
+    if (status) *status = status_;
+    return status_ == FrameStatus::Ok ? bitsToRawString(take()) : std::string();
+}
+
+}  // namespace stego
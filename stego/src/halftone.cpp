@@ -0,0 +1,365 @@
+#include "stego/halftone.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <iterator>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define STEGO_HALFTONE_X86 1
+#endif
+
+#include "stego/parallel.hpp"
+
+namespace stego {
+
+namespace {
+
+constexpr int PROGRESS_CHUNK = 64;                   // 每處理這麼多像素才公布一次進度，減少快取行在核心間來回
+constexpr std::size_t MIN_PARALLEL_PIXELS = 1 << 16;  // 太小的影像不值得切換執行緒
+
+// 各列的進度各自佔一條快取行，避免相鄰列互相干擾
+struct alignas(64) RowProgress {
+    std::atomic<int> done{0};
+};
+
+// 擴散第 r 列的像素 [begin, end)；cur 為本列誤差累加值，next 為下一列 (最後一列時為 nullptr)
+void diffuseSpan (float* cur, float* next, std::uint8_t* out, int cols, int begin, int end) {
+    for (int j = begin; j < end; ++j) {
+        const float oldPixel = cur[j];
+        const float newPixel = oldPixel > 127 ? 255.0f : 0.0f;
+        out[j] = static_cast<std::uint8_t>(newPixel);
+        const float quantError = oldPixel - newPixel;
+
+        if (j + 1 < cols) cur[j + 1] += quantError * 7.0f / 16.0f;
+        if (next) {
+            if (j > 0) next[j - 1] += quantError * 3.0f / 16.0f;
+            next[j] += quantError * 5.0f / 16.0f;
+            if (j + 1 < cols) next[j + 1] += quantError * 1.0f / 16.0f;
+        }
+    }
+}
+
+// --- 定點誤差擴散 ---
+struct Tap {
+    int dy, dx, weight;  // 相對於目前像素的位置 (dx 以掃描方向為正) 與權重
+};
+
+struct FloydSteinbergFilter {
+    static constexpr int DIVISOR = 16;
+    static constexpr Tap TAPS[] = {{0, 1, 7}, {1, -1, 3}, {1, 0, 5}, {1, 1, 1}};
+};
+
+struct JarvisJudiceNinkeFilter {
+    static constexpr int DIVISOR = 48;
+    static constexpr Tap TAPS[] = {
+        {0, 1, 7}, {0, 2, 5},
+        {1, -2, 3}, {1, -1, 5}, {1, 0, 7}, {1, 1, 5}, {1, 2, 3},
+        {2, -2, 1}, {2, -1, 3}, {2, 0, 5}, {2, 1, 3}, {2, 2, 1},
+    };
+};
+
+struct StuckiFilter {
+    static constexpr int DIVISOR = 42;
+    static constexpr Tap TAPS[] = {
+        {0, 1, 8}, {0, 2, 4},
+        {1, -2, 2}, {1, -1, 4}, {1, 0, 8}, {1, 1, 4}, {1, 2, 2},
+        {2, -2, 1}, {2, -1, 2}, {2, 0, 4}, {2, 1, 2}, {2, 2, 1},
+    };
+};
+
+struct AtkinsonFilter {
+    static constexpr int DIVISOR = 8;
+    static constexpr Tap TAPS[] = {{0, 1, 1}, {0, 2, 1}, {1, -1, 1}, {1, 0, 1}, {1, 1, 1}, {2, 0, 1}};
+};
+
+constexpr int PAD = 2;  // 誤差列左右各留 2 格，濾波器超出邊界的部分直接寫進去丟掉，不需要邊界判斷
+
+template <typename Filter>
+constexpr int filterHeight () {
+    int h = 0;
+    for (const Tap& t : Filter::TAPS) h = std::max(h, t.dy);
+    return h + 1;
+}
+
+// 累加值 / DIVISOR 四捨五入：乘上 2^16 / DIVISOR 的定點倒數再右移 (分母為 2 的冪次時是精確的)
+template <typename Filter>
+inline int scaledError (int acc) {
+    constexpr int RECIPROCAL = ((1 << 16) + Filter::DIVISOR / 2) / Filter::DIVISOR;
+    return (acc * RECIPROCAL + (1 << 15)) >> 16;
+}
+
+// 把量化誤差 e 依濾波器擴散出去；DIR 為掃描方向 (1 或 -1)，各係數在編譯期展開
+template <typename Filter, int DIR, std::size_t... I>
+inline void spreadError (std::int16_t* const* rows, int x, int e, std::index_sequence<I...>) {
+    ((rows[Filter::TAPS[I].dy][x + DIR * Filter::TAPS[I].dx] += static_cast<std::int16_t>(e * Filter::TAPS[I].weight)), ...);
+}
+
+template <typename Filter, int DIR>
+void diffuseRow (const std::uint8_t* in, std::uint8_t* out, std::int16_t* const* rows, int cols) {
+    constexpr auto taps = std::make_index_sequence<std::size(Filter::TAPS)>();
+    const int first = DIR > 0 ? 0 : cols - 1;
+    for (int i = 0, x = first; i < cols; ++i, x += DIR) {
+        const int v = in[x] + scaledError<Filter>(rows[0][x]);
+        const int q = v > 127 ? 255 : 0;
+        out[x] = static_cast<std::uint8_t>(q);
+        spreadError<Filter, DIR>(rows, x, v - q, taps);
+    }
+}
+
+template <typename Filter>
+void diffuseImage (ConstGrayView src, GrayView dst, bool serpentine) {
+    constexpr int H = filterHeight<Filter>();
+    const int cols = src.cols;
+    const std::size_t width = static_cast<std::size_t>(cols) + 2 * PAD;
+    std::vector<std::int16_t> ring(width * H, 0);
+
+    std::int16_t* rows[H];
+    for (int r = 0; r < src.rows; ++r) {
+        // rows[k] 對應第 r + k 列的誤差累加值 (環狀使用 H 列)
+        for (int k = 0; k < H; ++k) rows[k] = ring.data() + ((r + k) % H) * width + PAD;
+        if (serpentine && (r & 1)) {
+            diffuseRow<Filter, -1>(src.ptr(r), dst.ptr(r), rows, cols);
+        } else {
+            diffuseRow<Filter, 1>(src.ptr(r), dst.ptr(r), rows, cols);
+        }
+        std::fill(rows[0] - PAD, rows[0] - PAD + width, 0);  // 這一列接著用於第 r + H 列
+    }
+}
+
+// --- 有序抖色 ---
+constexpr int TILE_WIDTH = 256;  // 門檻矩陣的每一列先水平平鋪成這個寬度，逐段比較時不必取餘數
+
+// 門檻矩陣：ranks 為 0 .. n*n-1 的排列，轉成 8 位元門檻後每列平鋪成 TILE_WIDTH
+struct ThresholdTable {
+    int size = 0;
+    std::vector<std::uint8_t> tiled;  // size 列，每列 TILE_WIDTH 個門檻
+
+    ThresholdTable (int n, const std::vector<int>& ranks) : size(n), tiled(static_cast<std::size_t>(n) * TILE_WIDTH) {
+        // 第 k 名的門檻為 (2k + 1) * 256 / (2 * n * n)，灰階 v 輸出白點的比例約為 v / 256
+        const int levels = n * n;
+        for (int y = 0; y < n; ++y) for (int x = 0; x < TILE_WIDTH; ++x) {
+            const int k = ranks[y * n + x % n];
+            tiled[static_cast<std::size_t>(y) * TILE_WIDTH + x] = static_cast<std::uint8_t>((2 * k + 1) * 256 / (2 * levels));
+        }
+    }
+};
+
+// 遞迴建立 Bayer 矩陣：M(2n) = [4M, 4M + 2; 4M + 3, 4M + 1]
+std::vector<int> bayerRanks (int n) {
+    std::vector<int> m = {0};
+    for (int size = 1; size < n; size *= 2) {
+        std::vector<int> next(4 * size * size);
+        for (int y = 0; y < size; ++y) for (int x = 0; x < size; ++x) {
+            const int v = 4 * m[y * size + x];
+            next[y * 2 * size + x] = v;
+            next[y * 2 * size + x + size] = v + 2;
+            next[(y + size) * 2 * size + x] = v + 3;
+            next[(y + size) * 2 * size + x + size] = v + 1;
+        }
+        m.swap(next);
+    }
+    return m;
+}
+
+// void-and-cluster (Ulichney 1993) 產生藍噪聲排列；能量為環面上的高斯加權，結果是固定的
+std::vector<int> blueNoiseRanks (int n) {
+    const int total = n * n;
+    constexpr double SIGMA = 1.5;
+    std::vector<double> kernel(total);
+    for (int dy = 0; dy < n; ++dy) for (int dx = 0; dx < n; ++dx) {
+        const int y = std::min(dy, n - dy), x = std::min(dx, n - dx);
+        kernel[dy * n + dx] = std::exp(-(x * x + y * y) / (2 * SIGMA * SIGMA));
+    }
+
+    std::vector<char> on(total, 0);
+    std::vector<double> energy(total, 0.0);
+    auto toggle = [&](int p, bool set) {
+        on[p] = set;
+        const double sign = set ? 1.0 : -1.0;
+        const int py = p / n, px = p % n;
+        for (int y = 0; y < n; ++y) for (int x = 0; x < n; ++x) {
+            energy[y * n + x] += sign * kernel[((y - py + n) % n) * n + (x - px + n) % n];
+        }
+    };
+    // 1 之中能量最高者 (最擠的點) 或 0 之中能量最低者 (最大的空隙)
+    auto tightestCluster = [&] {
+        int best = -1;
+        for (int p = 0; p < total; ++p) if (on[p] && (best < 0 || energy[p] > energy[best])) best = p;
+        return best;
+    };
+    auto largestVoid = [&] {
+        int best = -1;
+        for (int p = 0; p < total; ++p) if (!on[p] && (best < 0 || energy[p] < energy[best])) best = p;
+        return best;
+    };
+
+    // 初始圖樣：以固定種子的 LCG 撒下約 10% 的點，再反覆把最擠的點移到最大的空隙直到穩定
+    const int initial = std::max(1, total / 10);
+    std::uint32_t seed = 0x9E3779B9u;
+    for (int placed = 0; placed < initial;) {
+        seed = seed * 1664525u + 1013904223u;
+        const int p = static_cast<int>((seed >> 8) % static_cast<std::uint32_t>(total));
+        if (!on[p]) toggle(p, true), ++placed;
+    }
+    for (;;) {
+        const int cluster = tightestCluster();
+        toggle(cluster, false);
+        const int hole = largestVoid();
+        toggle(hole, true);
+        if (hole == cluster) break;
+    }
+    const std::vector<char> prototype = on;
+    const std::vector<double> prototypeEnergy = energy;
+
+    std::vector<int> ranks(total);
+    // 依序拿掉最擠的點，名次由 initial - 1 往下
+    for (int rank = initial - 1; rank >= 0; --rank) {
+        const int p = tightestCluster();
+        toggle(p, false);
+        ranks[p] = rank;
+    }
+    // 由初始圖樣依序填入最大的空隙 (超過一半後，0 之中能量最低者就是 0 最擠的位置)
+    on = prototype;
+    energy = prototypeEnergy;
+    for (int rank = initial; rank < total; ++rank) {
+        const int p = largestVoid();
+        toggle(p, true);
+        ranks[p] = rank;
+    }
+    return ranks;
+}
+
+const ThresholdTable& thresholdTable (ThresholdMatrix matrix) {
+    switch (matrix) {
+    case ThresholdMatrix::Bayer4: {
+        static const ThresholdTable table(4, bayerRanks(4));
+        return table;
+    }
+    case ThresholdMatrix::BlueNoise64: {
+        static const ThresholdTable table(64, blueNoiseRanks(64));
+        return table;
+    }
+    default: {
+        static const ThresholdTable table(8, bayerRanks(8));
+        return table;
+    }
+    }
+}
+
+using ThresholdSpanFn = void (*)(const std::uint8_t* in, const std::uint8_t* threshold, std::uint8_t* out, int n);
+
+void thresholdSpanScalar (const std::uint8_t* in, const std::uint8_t* threshold, std::uint8_t* out, int n) {
+    for (int i = 0; i < n; ++i) out[i] = in[i] > threshold[i] ? 255 : 0;
+}
+
+#ifdef STEGO_HALFTONE_X86
+
+// 無號比較 in > t 等同 max(in, t) != t
+__attribute__((target("avx2"))) void thresholdSpanAVX2 (const std::uint8_t* in, const std::uint8_t* threshold, std::uint8_t* out, int n) {
+    const __m256i ones = _mm256_set1_epi8(-1);
+    int i = 0;
+    for (; i + 32 <= n; i += 32) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+        const __m256i t = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(threshold + i));
+        const __m256i notGreater = _mm256_cmpeq_epi8(_mm256_max_epu8(v, t), t);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_xor_si256(notGreater, ones));
+    }
+    thresholdSpanScalar(in + i, threshold + i, out + i, n - i);
+}
+
+#endif  // STEGO_HALFTONE_X86
+
+ThresholdSpanFn thresholdSpan () {
+    static const ThresholdSpanFn fn = [] {
+#ifdef STEGO_HALFTONE_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) return thresholdSpanAVX2;
+#endif
+        return thresholdSpanScalar;
+    }();
+    return fn;
+}
+
+}  // namespace
+
+bool floydSteinberg (ConstGrayView src, GrayView dst, int threads) {
+    if (src.empty() || src.channels != 1 || dst.channels != 1 || dst.rows != src.rows || dst.cols != src.cols) return false;
+
+    const int rows = src.rows, cols = src.cols;
+    Image<float> error(rows, cols);
+    for (int r = 0; r < rows; ++r) std::copy(src.ptr(r), src.ptr(r) + cols, error.view().ptr(r));
+    auto nextRow = [&](int r) { return r + 1 < rows ? error.view().ptr(r + 1) : nullptr; };
+
+    const int workers = std::min(resolveThreads(threads), rows);
+    if (workers <= 1 || src.total() < MIN_PARALLEL_PIXELS) {
+        for (int r = 0; r < rows; ++r) diffuseSpan(error.view().ptr(r), nextRow(r), dst.ptr(r), cols, 0, cols);
+        return true;
+    }
+
+    // 列依遞增順序認領，等待的上一列一定已被某個執行中的工作認領，不會死結
+    // (執行緒池不足或巢狀呼叫時，同一個執行緒會依序處理各列)
+    std::vector<RowProgress> progress(rows);
+    std::atomic<int> claimed{0};
+    parallelFor(static_cast<std::size_t>(workers), [&](std::size_t) {
+        for (int r; (r = claimed.fetch_add(1, std::memory_order_relaxed)) < rows;) {
+            float* cur = error.view().ptr(r);
+            float* next = nextRow(r);
+            std::uint8_t* out = dst.ptr(r);
+            int above = r == 0 ? cols : 0;  // 上一列已完成的像素數 (快取值)
+            for (int begin = 0; begin < cols; begin += PROGRESS_CHUNK) {
+                const int end = std::min(begin + PROGRESS_CHUNK, cols);
+                // 第 end - 1 個像素需要上一列完成到第 end + 1 個像素
+                const int need = std::min(end + 2, cols);
+                while (above < need) {
+                    above = progress[r - 1].done.load(std::memory_order_acquire);
+                    if (above < need) std::this_thread::yield();
+                }
+                diffuseSpan(cur, next, out, cols, begin, end);
+                progress[r].done.store(end, std::memory_order_release);
+            }
+        }
+    }, threads);
+    return true;
+}
+
+bool errorDiffusion (ConstGrayView src, GrayView dst, DiffusionFilter filter, bool serpentine) {
+    if (src.empty() || src.channels != 1 || dst.channels != 1 || dst.rows != src.rows || dst.cols != src.cols) return false;
+
+    switch (filter) {
+    case DiffusionFilter::FloydSteinberg: diffuseImage<FloydSteinbergFilter>(src, dst, serpentine); return true;
+    case DiffusionFilter::JarvisJudiceNinke: diffuseImage<JarvisJudiceNinkeFilter>(src, dst, serpentine); return true;
+    case DiffusionFilter::Stucki: diffuseImage<StuckiFilter>(src, dst, serpentine); return true;
+    case DiffusionFilter::Atkinson: diffuseImage<AtkinsonFilter>(src, dst, serpentine); return true;
+    }
+    return false;
+}
+
+bool orderedDither (ConstGrayView src, GrayView dst, ThresholdMatrix matrix, int threads) {
+    const bool validMatrix = matrix == ThresholdMatrix::Bayer4 || matrix == ThresholdMatrix::Bayer8 || matrix == ThresholdMatrix::BlueNoise64;
+    if (src.empty() || src.channels != 1 || dst.channels != 1 || dst.rows != src.rows || dst.cols != src.cols || !validMatrix) return false;
+
+    const ThresholdTable& table = thresholdTable(matrix);
+    const ThresholdSpanFn span = thresholdSpan();
+    const int rows = src.rows, cols = src.cols;
+    const std::size_t bands = std::max<std::size_t>(1, std::min<std::size_t>(static_cast<std::size_t>(resolveThreads(threads)) * 4, src.total() / MIN_PARALLEL_PIXELS));
+    const int band = static_cast<int>((rows + bands - 1) / bands);
+
+    parallelFor(static_cast<std::size_t>((rows + band - 1) / band), [&](std::size_t b) {
+        const int first = static_cast<int>(b) * band;
+        const int end = std::min(first + band, rows);
+        for (int r = first; r < end; ++r) {
+            const std::uint8_t* threshold = table.tiled.data() + static_cast<std::size_t>(r % table.size) * TILE_WIDTH;
+            const std::uint8_t* in = src.ptr(r);
+            std::uint8_t* out = dst.ptr(r);
+            for (int c = 0; c < cols; c += TILE_WIDTH) span(in + c, threshold, out + c, std::min(TILE_WIDTH, cols - c));
+        }
+    }, threads);
+    return true;
+}
+
+}  // namespace stego
@@ -0,0 +1,532 @@
+#include "stego/histogram_shift.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "stego/parallel.hpp"
+#include "location_map.hpp"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define STEGO_HS_SSE2 1
+#endif
+
+namespace stego {
+
+namespace {
+
+// --- 逐列處理的核心 ---
+// SSE2 是 x86-64 的基本指令集，不需要執行期判斷；一次處理 16 個像素，峰點像素 (通常只占幾 %) 再逐一處理
+// 只平移峰點 P 與零點 Z 之間的像素：P < G < Z 以兩個無號比較 (max/min 後比較相等) 表示
+
+// G >= lo 且 G <= hi 時為 0xFF
+#ifdef STEGO_HS_SSE2
+inline __m128i inRange (__m128i v, __m128i lo, __m128i hi) {
+    return _mm_and_si128(_mm_cmpeq_epi8(_mm_max_epu8(v, lo), v), _mm_cmpeq_epi8(_mm_min_epu8(v, hi), v));
+}
+#endif
+
+// 平移並嵌入: P < G < Z -> G + 1，G == P 依序嵌入 bits[pos] (位元用完後保持 P)，回傳新的 pos
+// 原本就是 Z 的像素不變 (記錄在溢位表中)
+std::size_t shiftEmbedRow (const std::uint8_t* in, std::uint8_t* out, int n, std::uint8_t p, std::uint8_t z, const BitBuffer& bits, std::size_t pos) {
+    const std::size_t total = bits.size();
+    int c = 0;
+#ifdef STEGO_HS_SSE2
+    const __m128i vp = _mm_set1_epi8(static_cast<char>(p));
+    const __m128i vp1 = _mm_set1_epi8(static_cast<char>(p + 1));
+    const __m128i vz1 = _mm_set1_epi8(static_cast<char>(z - 1));
+    for (; c + 16 <= n; c += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + c));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + c), _mm_sub_epi8(v, inRange(v, vp1, vz1)));
+        unsigned m = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, vp)));
+        for (; m && pos < total; m &= m - 1) {
+            if (bits[pos++]) out[c + __builtin_ctz(m)] = static_cast<std::uint8_t>(p + 1);
+        }
+    }
+#endif
+    for (; c < n; ++c) {
+        std::uint8_t v = in[c];
+        out[c] = static_cast<std::uint8_t>(v + (v > p && v < z));
+        if (v == p && pos < total && bits[pos++]) out[c] = static_cast<std::uint8_t>(p + 1);
+    }
+    return pos;
+}
+
+// 還原: P < G <= Z -> G - 1 (P+1 -> P，其餘平移回去)；溢位像素由呼叫端改回 Z
+void restoreRow (const std::uint8_t* in, std::uint8_t* out, int n, std::uint8_t p, std::uint8_t z) {
+    int c = 0;
+#ifdef STEGO_HS_SSE2
+    const __m128i vp1 = _mm_set1_epi8(static_cast<char>(p + 1));
+    const __m128i vz = _mm_set1_epi8(static_cast<char>(z));
+    for (; c + 16 <= n; c += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + c));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + c), _mm_add_epi8(v, inRange(v, vp1, vz)));
+    }
+#endif
+    for (; c < n; ++c) out[c] = static_cast<std::uint8_t>(in[c] - (in[c] > p && in[c] <= z));
+}
+
+// 依序對值為 P 或 P+1 的像素呼叫 f(column, bit)，f 回傳 false 時停止並回傳 false
+template <typename F>
+bool scanPeakRow (const std::uint8_t* in, int n, std::uint8_t p, F&& f) {
+    int c = 0;
+#ifdef STEGO_HS_SSE2
+    const __m128i vp = _mm_set1_epi8(static_cast<char>(p));
+    const __m128i vp1 = _mm_set1_epi8(static_cast<char>(p + 1));
+    for (; c + 16 <= n; c += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + c));
+        unsigned m = static_cast<unsigned>(_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, vp), _mm_cmpeq_epi8(v, vp1))));
+        for (; m; m &= m - 1) {
+            const int i = c + __builtin_ctz(m);
+            if (!f(i, in[i] != p)) return false;
+        }
+    }
+#endif
+    for (; c < n; ++c) {
+        if ((in[c] == p || in[c] == p + 1) && !f(c, in[c] != p)) return false;
+    }
+    return true;
+}
+
+// 值為 value 的像素位置 (base + column) 依序加入 out
+void collectValueRow (const std::uint8_t* in, int n, std::uint8_t value, std::size_t base, std::vector<std::size_t>& out) {
+    int c = 0;
+#ifdef STEGO_HS_SSE2
+    const __m128i vv = _mm_set1_epi8(static_cast<char>(value));
+    for (; c + 16 <= n; c += 16) {
+        unsigned m = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + c)), vv)));
+        for (; m; m &= m - 1) out.push_back(base + c + __builtin_ctz(m));
+    }
+#endif
+    for (; c < n; ++c) {
+        if (in[c] == value) out.push_back(base + c);
+    }
+}
+
+// 溢位位置表的走訪：查詢的位置必須遞增
+struct OverflowCursor {
+    std::vector<std::size_t>::const_iterator it, end;
+
+    bool hit (std::size_t index) {
+        while (it != end && *it < index) ++it;
+        return it != end && *it == index;
+    }
+};
+
+// 輸出的每個像素都會被覆寫，尺寸相同時不必重新配置 (大影像的配置與清零比處理本身還慢)
+void reuseOrAllocate (Image<std::uint8_t>& out, int rows, int cols) {
+    if (out.rows() != rows || out.cols() != cols || out.channels() != 1) out = Image<std::uint8_t>(rows, cols);
+}
+
+// 解出溢位位置；影像或金鑰無效時回傳 false
+bool decodeKey (ConstGrayView stego, const HSKey& key, std::vector<std::size_t>& overflow) {
+    return !stego.empty() && stego.channels == 1 && key.peak < key.zero && detail::decodeLocations(key.overflowMap, key.overflowCount, stego.total(), overflow);
+}
+
+// 單一區段的直方圖：四個子直方圖輪流累加，連續出現的相同灰度值會寫到不同的計數器，
+// 不必等上一次寫入完成 (避免 store-forwarding 停頓)，最後再加總
+Histogram histogramRows (ConstGrayView image, int firstRow, int endRow) {
+    std::uint32_t sub[4][256] = {};
+    const int n = image.cols * image.channels;
+    for (int r = firstRow; r < endRow; ++r) {
+        const std::uint8_t* rowPtr = image.ptr(r);
+        int c = 0;
+        for (; c + 8 <= n; c += 8) {
+            std::uint64_t w;
+            std::memcpy(&w, rowPtr + c, 8);
+            ++sub[0][w & 0xFF];
+            ++sub[1][(w >> 8) & 0xFF];
+            ++sub[2][(w >> 16) & 0xFF];
+            ++sub[3][(w >> 24) & 0xFF];
+            ++sub[0][(w >> 32) & 0xFF];
+            ++sub[1][(w >> 40) & 0xFF];
+            ++sub[2][(w >> 48) & 0xFF];
+            ++sub[3][w >> 56];
+        }
+        for (; c < n; ++c) ++sub[c & 3][rowPtr[c]];
+    }
+
+    Histogram histogram{};
+    for (int i = 0; i < 256; ++i) histogram[i] = sub[0][i] + sub[1][i] + sub[2][i] + sub[3][i];
+    return histogram;
+}
+
+// --- 依列切段平行處理 ---
+// 每段的嵌入起點 = 前面各段峰點像素數的前綴和 (由各段直方圖得到)，因此輸出與單執行緒完全相同
+constexpr std::size_t MIN_BAND_PIXELS = 1 << 18;  // 太小的分段不值得切換執行緒
+
+int bandRows (ConstGrayView image, int threads) {
+    const std::size_t pixels = image.total();
+    const std::size_t bands = std::max<std::size_t>(1, std::min<std::size_t>(static_cast<std::size_t>(resolveThreads(threads)) * 4, pixels / MIN_BAND_PIXELS));
+    return std::max(1, static_cast<int>((image.rows + bands - 1) / bands));
+}
+
+std::size_t bandCount (int rows, int band) {
+    return static_cast<std::size_t>((rows + band - 1) / band);
+}
+
+std::vector<Histogram> bandHistograms (ConstGrayView image, int band, int threads) {
+    std::vector<Histogram> parts(bandCount(image.rows, band));
+    parallelFor(parts.size(), [&](std::size_t b) {
+        const int first = static_cast<int>(b) * band;
+        parts[b] = histogramRows(image, first, std::min(first + band, image.rows));
+    }, threads);
+    return parts;
+}
+
+}  // namespace
+
+Histogram calculateHistogram (ConstGrayView grayImage, int threads) {
+    Histogram histogram{};
+    for (const Histogram& part : bandHistograms(grayImage, bandRows(grayImage, threads), threads)) {
+        for (int i = 0; i < 256; ++i) histogram[i] += part[i];
+    }
+    return histogram;
+}
+
+int findPeakBin (const Histogram& histogram) {
+    int peakBin = -1;
+    std::int64_t maxFreq = -1;
+    // 需要 P 和 P+1 都有效，所以 P 最大只能是 254
+    for (int i = 0; i <= 254; ++i) {
+        if (histogram[i] > maxFreq) {
+            maxFreq = histogram[i];
+            peakBin = i;
+        }
+    }
+    return peakBin;
+}
+
+int capacityHistogramShifting (ConstGrayView grayImage, int peakBin) {
+    if (peakBin < 0 || peakBin > 255) return 0;
+    return static_cast<int>(calculateHistogram(grayImage)[peakBin]);
+}
+
+int findZeroBin (const Histogram& histogram, int peakBin) {
+    if (peakBin < 0 || peakBin > 254) return -1;
+    // 像素最少的灰度值 (相同時取最靠近 P 者)：為 0 時不需要溢位表，平移的像素也最少
+    int zeroBin = peakBin + 1;
+    for (int i = peakBin + 2; i <= 255 && histogram[zeroBin] != 0; ++i) {
+        if (histogram[i] < histogram[zeroBin]) zeroBin = i;
+    }
+    return zeroBin;
+}
+
+bool embedHistogramShifting (ConstGrayView grayImage, const BitBuffer& bits, Image<std::uint8_t>& stego, HSKey& key, int threads) {
+    if (grayImage.empty() || grayImage.channels != 1) return false;
+
+    const int band = bandRows(grayImage, threads);
+    std::vector<Histogram> parts = bandHistograms(grayImage, band, threads);
+    Histogram histogram{};
+    for (const Histogram& part : parts) {
+        for (int i = 0; i < 256; ++i) histogram[i] += part[i];
+    }
+    key = HSKey();
+    const int peakBin = findPeakBin(histogram);
+    if (peakBin == -1 || histogram[peakBin] == 0) return false;
+    if (bits.size() > histogram[peakBin]) return false;  // 容量不足
+    key.peak = static_cast<std::uint8_t>(peakBin);
+    key.zero = static_cast<std::uint8_t>(findZeroBin(histogram, peakBin));
+
+    // 各段第一個峰點像素對應的位元位置
+    std::vector<std::size_t> start(parts.size(), 0);
+    for (std::size_t b = 1; b < parts.size(); ++b) start[b] = start[b - 1] + parts[b - 1][peakBin];
+
+    // 不必先複製封面：每個像素都由平移/嵌入的結果直接寫入 (尺寸相同時沿用呼叫端的緩衝區)
+    // 零點不是空的時，原本位於 Z 的像素與平移過來的像素重疊，位置記錄在溢位表中
+    const bool recordOverflow = histogram[key.zero] != 0;
+    std::vector<std::vector<std::size_t>> overflow(parts.size());
+    reuseOrAllocate(stego, grayImage.rows, grayImage.cols);
+    parallelFor(parts.size(), [&](std::size_t b) {
+        const int first = static_cast<int>(b) * band;
+        const int end = std::min(first + band, grayImage.rows);
+        std::size_t embedded = std::min(start[b], bits.size());
+        for (int r = first; r < end; ++r) {
+            embedded = shiftEmbedRow(grayImage.ptr(r), stego.ptr(r), grayImage.cols, key.peak, key.zero, bits, embedded);
+            if (recordOverflow) collectValueRow(grayImage.ptr(r), grayImage.cols, key.zero, static_cast<std::size_t>(r) * grayImage.cols, overflow[b]);
+        }
+    }, threads);
+
+    std::size_t prev = 0;
+    for (const auto& part : overflow) {
+        for (std::size_t idx : part) detail::appendLocation(key.overflowMap, prev, idx);
+        key.overflowCount += part.size();
+    }
+    return true;
+}
+
+BitBuffer extractAndRestoreHistogramShifting (ConstGrayView stego, const HSKey& key, Image<std::uint8_t>& restored, int threads) {
+    std::vector<std::size_t> overflow;
+    if (!decodeKey(stego, key, overflow)) {
+        restored = Image<std::uint8_t>();
+        return BitBuffer();
+    }
+
+    // P 代表 0，P+1 代表 1；還原只依像素值與溢位表決定。各段分別收集位元，最後依序接起來
+    // 溢位像素的值是 Z，只有 Z == P+1 時才會被當成峰點像素，需要略過
+    const bool skipOverflow = key.zero == key.peak + 1;
+    const int band = bandRows(stego, threads);
+    std::vector<BitBuffer> parts(bandCount(stego.rows, band));
+    reuseOrAllocate(restored, stego.rows, stego.cols);
+    parallelFor(parts.size(), [&](std::size_t b) {
+        const int first = static_cast<int>(b) * band;
+        const int end = std::min(first + band, stego.rows);
+        const auto bandStart = std::lower_bound(overflow.cbegin(), overflow.cend(), static_cast<std::size_t>(first) * stego.cols);
+        OverflowCursor cursor{bandStart, overflow.cend()};
+        auto next = bandStart;
+        BitWriter writer;
+        for (int r = first; r < end; ++r) {
+            const std::size_t base = static_cast<std::size_t>(r) * stego.cols;
+            scanPeakRow(stego.ptr(r), stego.cols, key.peak, [&](int c, bool bit) {
+                if (!skipOverflow || !cursor.hit(base + c)) writer.put(bit);
+                return true;
+            });
+            restoreRow(stego.ptr(r), restored.ptr(r), stego.cols, key.peak, key.zero);
+            for (; next != overflow.cend() && *next < base + stego.cols; ++next) restored.ptr(r)[*next - base] = key.zero;
+        }
+        parts[b] = writer.take();
+    }, threads);
+
+    std::size_t total = 0;
+    for (const BitBuffer& part : parts) total += part.size();
+    BitWriter bits(total);
+    for (const BitBuffer& part : parts) bits.writeBits(part);
+    return bits.take();
+}
+
+void streamHistogramShifting (ConstGrayView stego, const HSKey& key, const ByteSink& sink) {
+    std::vector<std::size_t> overflow;
+    if (!decodeKey(stego, key, overflow)) return;
+    const bool skipOverflow = key.zero == key.peak + 1;
+    OverflowCursor cursor{overflow.cbegin(), overflow.cend()};
+    ByteAssembler out(sink);
+    for (int r = 0; r < stego.rows; ++r) {
+        const std::size_t base = static_cast<std::size_t>(r) * stego.cols;
+        const bool more = scanPeakRow(stego.ptr(r), stego.cols, key.peak, [&](int c, bool bit) {
+            return (skipOverflow && cursor.hit(base + c)) || out.put(bit, 1);
+        });
+        if (!more) return;
+    }
+}
+
+Image<std::uint8_t> restoreHistogramShifting (ConstGrayView stego, const HSKey& key, int threads) {
+    std::vector<std::size_t> overflow;
+    if (!decodeKey(stego, key, overflow)) return Image<std::uint8_t>();
+
+    // 還原只依像素值決定: P < G <= Z -> G - 1，溢位像素保持 Z，不需要取出的位元
+    Image<std::uint8_t> restored(stego.rows, stego.cols);
+    const int band = bandRows(stego, threads);
+    parallelFor(bandCount(stego.rows, band), [&](std::size_t b) {
+        const int first = static_cast<int>(b) * band;
+        const int end = std::min(first + band, stego.rows);
+        for (int r = first; r < end; ++r) restoreRow(stego.ptr(r), restored.ptr(r), stego.cols, key.peak, key.zero);
+    }, threads);
+    for (std::size_t idx : overflow) restored.data()[idx] = key.zero;
+    return restored;
+}
+
+bool embedMessageHistogramShifting (ConstGrayView grayImage, const std::string& message, Image<std::uint8_t>& stego, HSKey& key, int threads) {
+    BitBuffer bits = frameMessage(message, FrameAlgorithm::HistogramShift, 0);
+    if (bits.empty()) return false;  // 訊息過長
+    return embedHistogramShifting(grayImage, bits, stego, key, threads);
+}
+
+std::string extractMessageHistogramShifting (ConstGrayView stego, const HSKey& key, Image<std::uint8_t>& restored, FrameStatus* status, int threads) {
+    FrameReader reader(FrameAlgorithm::HistogramShift, 0, stego.total());
+    streamHistogramShifting(stego, key, reader.sink());
+    restored = restoreHistogramShifting(stego, key, threads);
+    return reader.takeMessage(status);
+}
+
+namespace {
+
+// 多組平移的查表：嵌入時依原值、提取時依嵌入後的值決定處理方式
+struct MultiHSTables {
+    std::uint8_t shift[256];    // 非峰點像素嵌入後的值
+    std::int8_t dir[256];       // 峰點嵌入 1 時的方向 (+1 / -1)，非峰點為 0
+    bool overflow[256];         // 非空的零點：這些像素的位置要記錄下來
+    std::uint8_t restore[256];  // 嵌入後的值 -> 原值
+    std::int8_t bit[256];       // 嵌入後的值代表的位元，-1 表示不攜帶位元
+};
+
+MultiHSTables buildTables (const std::vector<HSPair>& pairs, const Histogram* histogram) {
+    MultiHSTables t;
+    for (int v = 0; v < 256; ++v) {
+        t.shift[v] = t.restore[v] = static_cast<std::uint8_t>(v);
+        t.dir[v] = 0;
+        t.overflow[v] = false;
+        t.bit[v] = -1;
+    }
+    for (const HSPair& pair : pairs) {
+        const int p = pair.peak, z = pair.zero;
+        const int d = z > p ? 1 : -1;
+        // P 與 Z 之間 (不含兩端) 往 Z 平移一格；嵌入後 P+d .. Z 之間的值還原時往回一格
+        for (int v = p + d; v != z; v += d) t.shift[v] = static_cast<std::uint8_t>(v + d);
+        for (int v = p + d; v != z + d; v += d) t.restore[v] = static_cast<std::uint8_t>(v - d);
+        t.dir[p] = static_cast<std::int8_t>(d);
+        t.bit[p] = 0;
+        t.bit[p + d] = 1;
+        if (histogram && (*histogram)[z] > 0) t.overflow[z] = true;
+    }
+    return t;
+}
+
+// 各組區間互不重疊且 P != Z
+bool validPairs (const std::vector<HSPair>& pairs) {
+    bool used[256] = {};
+    for (const HSPair& pair : pairs) {
+        if (pair.peak == pair.zero) return false;
+        const int lo = std::min(pair.peak, pair.zero), hi = std::max(pair.peak, pair.zero);
+        for (int v = lo; v <= hi; ++v) {
+            if (used[v]) return false;
+            used[v] = true;
+        }
+    }
+    return !pairs.empty();
+}
+
+}  // namespace
+
+std::vector<HSPair> selectHSPairs (const Histogram& histogram, int maxPairs, std::size_t bitsNeeded) {
+    std::vector<HSPair> pairs;
+    int order[256];
+    for (int v = 0; v < 256; ++v) order[v] = v;
+    std::stable_sort(order, order + 256, [&](int a, int b) { return histogram[a] > histogram[b]; });
+
+    bool used[256] = {};
+    std::size_t capacity = 0;
+    for (int p : order) {
+        if (static_cast<int>(pairs.size()) >= maxPairs || capacity >= bitsNeeded || histogram[p] == 0) break;
+        if (used[p]) continue;
+
+        // 往兩側找到已使用的區間為止，取像素最少 (相同時取較近) 的灰度值當零點
+        int best = -1;
+        for (int d = -1; d <= 1; d += 2) {
+            for (int z = p + d; z >= 0 && z <= 255 && !used[z]; z += d) {
+                if (best < 0 || histogram[z] < histogram[best] || (histogram[z] == histogram[best] && std::abs(z - p) < std::abs(best - p))) best = z;
+            }
+        }
+        if (best < 0 || histogram[best] >= histogram[p]) continue;  // 沒有淨容量
+
+        for (int v = std::min(p, best); v <= std::max(p, best); ++v) used[v] = true;
+        pairs.push_back({static_cast<std::uint8_t>(p), static_cast<std::uint8_t>(best)});
+        capacity += histogram[p];
+    }
+    return pairs;
+}
+
+bool embedMultiHistogramShifting (ConstGrayView grayImage, const BitBuffer& bits, Image<std::uint8_t>& stego, MultiHSKey& key, int maxPairs, int threads) {
+    if (grayImage.empty() || grayImage.channels != 1) return false;
+
+    const int band = bandRows(grayImage, threads);
+    std::vector<Histogram> parts = bandHistograms(grayImage, band, threads);
+    Histogram histogram{};
+    for (const Histogram& part : parts) {
+        for (int i = 0; i < 256; ++i) histogram[i] += part[i];
+    }
+
+    key = MultiHSKey();
+    key.pairs = selectHSPairs(histogram, maxPairs, bits.size());
+    std::size_t capacity = 0;
+    for (const HSPair& pair : key.pairs) capacity += histogram[pair.peak];
+    if (key.pairs.empty() || bits.size() > capacity) return false;  // 容量不足
+
+    // 各段第一個峰點像素對應的位元位置 (所有組的峰點共用同一條位元序列)
+    std::vector<std::size_t> start(parts.size(), 0);
+    for (std::size_t b = 1; b < parts.size(); ++b) {
+        start[b] = start[b - 1];
+        for (const HSPair& pair : key.pairs) start[b] += parts[b - 1][pair.peak];
+    }
+
+    const MultiHSTables t = buildTables(key.pairs, &histogram);
+    const std::size_t total = bits.size();
+    std::vector<std::vector<std::size_t>> overflow(parts.size());
+    reuseOrAllocate(stego, grayImage.rows, grayImage.cols);
+    parallelFor(parts.size(), [&](std::size_t b) {
+        const int first = static_cast<int>(b) * band;
+        const int end = std::min(first + band, grayImage.rows);
+        std::size_t pos = std::min(start[b], total);
+        for (int r = first; r < end; ++r) {
+            const std::uint8_t* in = grayImage.ptr(r);
+            std::uint8_t* out = stego.ptr(r);
+            const std::size_t base = static_cast<std::size_t>(r) * grayImage.cols;
+            for (int c = 0; c < grayImage.cols; ++c) {
+                const std::uint8_t v = in[c];
+                std::uint8_t o = t.shift[v];
+                if (t.dir[v] && pos < total && bits[pos++]) o = static_cast<std::uint8_t>(v + t.dir[v]);
+                if (t.overflow[v]) overflow[b].push_back(base + c);
+                out[c] = o;
+            }
+        }
+    }, threads);
+
+    // 位置依列優先遞增，差分後的值通常很小
+    std::size_t prev = 0;
+    for (const auto& part : overflow) {
+        for (std::size_t idx : part) detail::appendLocation(key.overflowMap, prev, idx);
+        key.overflowCount += part.size();
+    }
+    return true;
+}
+
+BitBuffer extractAndRestoreMultiHistogramShifting (ConstGrayView stego, const MultiHSKey& key, Image<std::uint8_t>& restored, int threads) {
+    std::vector<std::size_t> overflow;
+    if (stego.empty() || stego.channels != 1 || !validPairs(key.pairs) || !detail::decodeLocations(key.overflowMap, key.overflowCount, stego.total(), overflow)) {
+        restored = Image<std::uint8_t>();
+        return BitBuffer();
+    }
+
+    const MultiHSTables t = buildTables(key.pairs, nullptr);
+    const int band = bandRows(stego, threads);
+    std::vector<BitBuffer> parts(bandCount(stego.rows, band));
+    reuseOrAllocate(restored, stego.rows, stego.cols);
+    parallelFor(parts.size(), [&](std::size_t b) {
+        const int first = static_cast<int>(b) * band;
+        const int end = std::min(first + band, stego.rows);
+        auto next = std::lower_bound(overflow.begin(), overflow.end(), static_cast<std::size_t>(first) * stego.cols);
+        BitWriter writer;
+        for (int r = first; r < end; ++r) {
+            const std::uint8_t* in = stego.ptr(r);
+            std::uint8_t* out = restored.ptr(r);
+            const std::size_t base = static_cast<std::size_t>(r) * stego.cols;
+            for (int c = 0; c < stego.cols; ++c) {
+                const std::uint8_t v = in[c];
+                // 溢位像素嵌入時沒有改變，也不攜帶位元
+                if (next != overflow.end() && *next == base + c) {
+                    out[c] = v;
+                    ++next;
+                    continue;
+                }
+                if (t.bit[v] >= 0) writer.put(t.bit[v] != 0);
+                out[c] = t.restore[v];
+            }
+        }
+        parts[b] = writer.take();
+    }, threads);
+
+    std::size_t total = 0;
+    for (const BitBuffer& part : parts) total += part.size();
+    BitWriter bits(total);
+    for (const BitBuffer& part : parts) bits.writeBits(part);
+    return bits.take();
+}
+
+bool embedMessageMultiHistogramShifting (ConstGrayView grayImage, const std::string& message, Image<std::uint8_t>& stego, MultiHSKey& key, int maxPairs, int threads) {
+    // 組數要看負載長度才決定，因此框架參數固定為 0
+    BitBuffer bits = frameMessage(message, FrameAlgorithm::MultiHistogramShift, 0);
+    if (bits.empty()) return false;  // 訊息過長
+    return embedMultiHistogramShifting(grayImage, bits, stego, key, maxPairs, threads);
+}
+
+std::string extractMessageMultiHistogramShifting (ConstGrayView stego, const MultiHSKey& key, Image<std::uint8_t>& restored, FrameStatus* status, int threads) {
+    // 還原本來就要走訪整張影像，因此先取出全部位元再交給 FrameReader
+    BitBuffer bits = extractAndRestoreMultiHistogramShifting(stego, key, restored, threads);
+    FrameReader reader(FrameAlgorithm::MultiHistogramShift, 0, bits.size() > FRAME_HEADER_BITS ? bits.size() - FRAME_HEADER_BITS : 0);
+    const std::size_t whole = bits.size() / 8;
+    for (std::size_t i = 0; i < whole && reader.push(bits.data()[i]); ++i) {}
+    return reader.takeMessage(status);
+}
+
+}  // namespace stego
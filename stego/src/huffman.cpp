@@ -0,0 +1,293 @@
+#include "stego/huffman.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace stego {
+
+namespace {
+
+constexpr int COUNT_BITS = 32;
+constexpr int LENGTH_FIELD_BITS = 4;
+constexpr std::size_t HEADER_BITS = COUNT_BITS + 256 * LENGTH_FIELD_BITS;  // 1056 位元，碼字從位元組邊界開始
+constexpr int LOOKUP_SIZE = 1 << HUFFMAN_LOOKUP_BITS;
+
+// 碼長 <= HUFFMAN_MAX_BITS 的 Huffman 合併；最長碼超過上限時回傳 false
+// 葉節點依次數排序後，新產生的內部節點次數也是遞增的，因此兩個佇列 (葉、內部節點) 就能取代 priority_queue
+bool buildLengths (const std::array<std::uint64_t, 256>& frequencies, HuffmanLengths& lengths) {
+    std::vector<std::pair<std::uint64_t, int>> leaves;
+    for (int s = 0; s < 256; ++s) {
+        if (frequencies[s]) leaves.emplace_back(frequencies[s], s);
+    }
+    std::sort(leaves.begin(), leaves.end());
+    const int m = static_cast<int>(leaves.size());
+
+    // 節點 0..m-1 為葉，m..2m-2 為內部節點 (最後一個是根)
+    std::vector<std::uint64_t> weight(2 * m - 1);
+    std::vector<int> parent(2 * m - 1, -1);
+    for (int i = 0; i < m; ++i) weight[i] = leaves[i].first;
+    int leaf = 0, internal = m;
+    auto takeSmallest = [&](int next) {
+        // 次數相同時先取葉節點，最長碼較短
+        if (leaf < m && (internal >= next || weight[leaf] <= weight[internal])) return leaf++;
+        return internal++;
+    };
+    for (int next = m; next < 2 * m - 1; ++next) {
+        const int a = takeSmallest(next);
+        const int b = takeSmallest(next);
+        weight[next] = weight[a] + weight[b];
+        parent[a] = parent[b] = next;
+    }
+
+    // 父節點編號一定比子節點大，由根往下算深度
+    std::vector<int> depth(2 * m - 1, 0);
+    for (int i = 2 * m - 3; i >= 0; --i) depth[i] = depth[parent[i]] + 1;
+    lengths.fill(0);
+    for (int i = 0; i < m; ++i) {
+        if (depth[i] > HUFFMAN_MAX_BITS) return false;
+        lengths[leaves[i].second] = static_cast<std::uint8_t>(depth[i]);
+    }
+    return true;
+}
+
+// 各碼長的符號數與第一個碼字 (正規碼字的共同基礎)
+struct CodeRanges {
+    int count[HUFFMAN_MAX_BITS + 1] = {};
+    int first[HUFFMAN_MAX_BITS + 1] = {};
+};
+
+bool codeRanges (const HuffmanLengths& lengths, CodeRanges& ranges) {
+    for (std::uint8_t len : lengths) {
+        if (len > HUFFMAN_MAX_BITS) return false;
+        if (len) ++ranges.count[len];
+    }
+    // Kraft 不等式：sum 2^-len <= 1，否則碼字會重疊
+    int left = 1;
+    for (int bits = 1; bits <= HUFFMAN_MAX_BITS; ++bits) {
+        left = (left << 1) - ranges.count[bits];
+        if (left < 0) return false;
+    }
+    int code = 0;
+    for (int bits = 1; bits <= HUFFMAN_MAX_BITS; ++bits) {
+        code = (code + ranges.count[bits - 1]) << 1;
+        ranges.first[bits] = code;
+    }
+    return true;
+}
+
+// 解碼表：以前 11 位元查表，一個項目最多解出 2 個符號 (兩個碼字都在 11 位元內時)
+//   bit 0..3 第一個碼長 (0 表示碼字更長或不存在)、bit 4..7 總碼長、bit 8..9 符號數、bit 16..23 / 24..31 兩個符號
+// 更長的碼字以 first / count 判斷碼長，再由 sorted 取出符號
+struct DecodeTable {
+    std::uint32_t lookup[LOOKUP_SIZE] = {};
+    CodeRanges ranges;
+    int offset[HUFFMAN_MAX_BITS + 1] = {};
+    std::uint8_t sorted[256] = {};
+};
+
+bool buildDecodeTable (const HuffmanLengths& lengths, DecodeTable& table) {
+    HuffmanCodes codes;
+    if (!canonicalHuffmanCodes(lengths, codes) || !codeRanges(lengths, table.ranges)) return false;
+    int pos = 0;
+    for (int bits = 1; bits <= HUFFMAN_MAX_BITS; ++bits) {
+        table.offset[bits] = pos;
+        for (int s = 0; s < 256; ++s) {
+            if (lengths[s] == bits) table.sorted[pos++] = static_cast<std::uint8_t>(s);
+        }
+    }
+
+    // 先建單一符號的表 (符號 << 4 | 碼長)，再看第一個碼字之後剩下的位元是否還含有完整的碼字
+    std::vector<std::uint16_t> single(LOOKUP_SIZE, 0);
+    for (int s = 0; s < 256; ++s) {
+        const int len = lengths[s];
+        if (len == 0 || len > HUFFMAN_LOOKUP_BITS) continue;
+        const int begin = codes[s] << (HUFFMAN_LOOKUP_BITS - len);
+        std::fill(single.begin() + begin, single.begin() + begin + (1 << (HUFFMAN_LOOKUP_BITS - len)), static_cast<std::uint16_t>(s << 4 | len));
+    }
+    for (int v = 0; v < LOOKUP_SIZE; ++v) {
+        const std::uint32_t first = single[v], len1 = first & 15;
+        if (len1 == 0) continue;
+        const std::uint32_t second = single[(v << len1) & (LOOKUP_SIZE - 1)], len2 = second & 15;
+        if (len2 != 0 && len1 + len2 <= HUFFMAN_LOOKUP_BITS) {
+            table.lookup[v] = len1 | (len1 + len2) << 4 | 2u << 8 | (first >> 4) << 16 | (second >> 4) << 24;
+        } else {
+            table.lookup[v] = len1 | len1 << 4 | 1u << 8 | (first >> 4) << 16;
+        }
+    }
+    return true;
+}
+
+// 實際的解碼；失敗時 out 的內容由 huffmanDecode 清除
+bool decodeStream (const BitBuffer& encoded, std::vector<std::uint8_t>& out) {
+    out.clear();
+    if (encoded.size() < HEADER_BITS) return false;
+    BitReader reader(encoded);
+    const std::size_t count = reader.read(COUNT_BITS);
+    HuffmanLengths lengths;
+    for (std::uint8_t& len : lengths) len = static_cast<std::uint8_t>(reader.read(LENGTH_FIELD_BITS));
+    if (count == 0) return true;
+
+    DecodeTable table;
+    if (!buildDecodeTable(lengths, table)) return false;
+    // 每個符號至少用掉最短碼長個位元，符號數不可能超過資料能容納的數量；先檢查再配置輸出，
+    // 避免偽造的符號數 (最多 2^32 - 1) 造成巨大的配置
+    int shortest = HUFFMAN_MAX_BITS;
+    for (std::uint8_t len : lengths) {
+        if (len) shortest = std::min<int>(shortest, len);
+    }
+    if (count > (encoded.size() - HEADER_BITS) / shortest) return false;
+    out.resize(count);
+
+    // 64 位元的位元緩衝區 (靠左對齊)，每次補到至少 56 位元
+    const std::uint8_t* p = encoded.data();
+    const std::size_t bytes = encoded.byteSize();
+    std::size_t next = HEADER_BITS / 8;
+    std::uint64_t bitbuf = 0;
+    int bitcount = 0;
+    auto refill = [&] {
+        if (next + 8 <= bytes) {
+            bitbuf |= detail::loadBE64(p + next, 8) >> bitcount;
+            const int take = (63 - bitcount) >> 3;
+            next += take;
+            bitcount += take * 8;
+            return;
+        }
+        while (bitcount <= 56) {
+            bitbuf |= static_cast<std::uint64_t>(next < bytes ? p[next] : 0) << (56 - bitcount);
+            ++next;
+            bitcount += 8;
+        }
+    };
+    // 超過 11 位元的碼字：逐一比較各碼長的範圍，碼字不存在 (不完整的碼表) 時回傳 -1
+    auto decodeLong = [&]() -> int {
+        const int peek = static_cast<int>(bitbuf >> (64 - HUFFMAN_MAX_BITS));
+        for (int len = HUFFMAN_LOOKUP_BITS + 1; len <= HUFFMAN_MAX_BITS; ++len) {
+            const int index = (peek >> (HUFFMAN_MAX_BITS - len)) - table.ranges.first[len];
+            if (index >= 0 && index < table.ranges.count[len]) {
+                bitbuf <<= len;
+                bitcount -= len;
+                return table.sorted[table.offset[len] + index];
+            }
+        }
+        return -1;
+    };
+
+    // 每次查表寫出 1 ~ 2 個符號 (第二個位置可能之後被覆寫)，因此保留 2 個位置的餘裕；
+    // 補滿後至少 56 位元，3 次查表最多用掉 45 位元
+    std::uint8_t* dst = out.data();
+    std::size_t i = 0;
+    while (i + 6 <= count) {
+        refill();
+        for (int r = 0; r < 3; ++r) {
+            const std::uint32_t e = table.lookup[bitbuf >> (64 - HUFFMAN_LOOKUP_BITS)];
+            if (__builtin_expect((e & 15) == 0, 0)) {
+                const int symbol = decodeLong();
+                if (symbol < 0) return false;
+                dst[i++] = static_cast<std::uint8_t>(symbol);
+                continue;
+            }
+            dst[i] = static_cast<std::uint8_t>(e >> 16);
+            dst[i + 1] = static_cast<std::uint8_t>(e >> 24);
+            const int total = (e >> 4) & 15;
+            bitbuf <<= total;
+            bitcount -= total;
+            i += (e >> 8) & 3;
+        }
+    }
+    while (i < count) {
+        refill();
+        const std::uint32_t e = table.lookup[bitbuf >> (64 - HUFFMAN_LOOKUP_BITS)];
+        int symbol = static_cast<int>((e >> 16) & 0xFF);
+        if (e & 15) {
+            bitbuf <<= e & 15;
+            bitcount -= e & 15;
+        } else if ((symbol = decodeLong()) < 0) {
+            return false;
+        }
+        dst[i++] = static_cast<std::uint8_t>(symbol);
+    }
+    // 用掉的位元不能超過實際資料 (超出的部分是補上的 0)
+    return next * 8 - bitcount <= encoded.size();
+}
+
+
+}  // namespace
+
+HuffmanLengths huffmanCodeLengths (const std::array<std::uint64_t, 256>& frequencies) {
+    HuffmanLengths lengths{};
+    const auto used = std::count_if(frequencies.begin(), frequencies.end(), [](std::uint64_t f) { return f > 0; });
+    if (used == 0) return lengths;
+    if (used == 1) {
+        lengths[std::find_if(frequencies.begin(), frequencies.end(), [](std::uint64_t f) { return f > 0; }) - frequencies.begin()] = 1;
+        return lengths;
+    }
+    std::array<std::uint64_t, 256> scaled = frequencies;
+    while (!buildLengths(scaled, lengths)) {
+        for (std::uint64_t& f : scaled) f = f ? (f + 1) >> 1 : 0;
+    }
+    return lengths;
+}
+
+bool canonicalHuffmanCodes (const HuffmanLengths& lengths, HuffmanCodes& codes) {
+    CodeRanges ranges;
+    if (!codeRanges(lengths, ranges)) return false;
+    int next[HUFFMAN_MAX_BITS + 1];
+    std::copy(ranges.first, ranges.first + HUFFMAN_MAX_BITS + 1, next);
+    codes.fill(0);
+    for (int s = 0; s < 256; ++s) {
+        if (lengths[s]) codes[s] = static_cast<std::uint16_t>(next[lengths[s]]++);
+    }
+    return true;
+}
+
+BitBuffer huffmanEncode (const void* data, std::size_t size) {
+    if (size > std::numeric_limits<std::uint32_t>::max()) return BitBuffer();
+    const auto* in = static_cast<const std::uint8_t*>(data);
+
+    // 4 份直方圖交錯累加，避免連續相同位元組時同一個計數器的讀寫相依
+    std::array<std::uint64_t, 256> hist[4] = {};
+    std::size_t i = 0;
+    for (; i + 4 <= size; i += 4) {
+        ++hist[0][in[i]];
+        ++hist[1][in[i + 1]];
+        ++hist[2][in[i + 2]];
+        ++hist[3][in[i + 3]];
+    }
+    for (; i < size; ++i) ++hist[0][in[i]];
+    std::array<std::uint64_t, 256> frequencies{};
+    std::uint64_t totalBits = 0;
+    for (int s = 0; s < 256; ++s) frequencies[s] = hist[0][s] + hist[1][s] + hist[2][s] + hist[3][s];
+
+    const HuffmanLengths lengths = huffmanCodeLengths(frequencies);
+    HuffmanCodes codes;
+    canonicalHuffmanCodes(lengths, codes);
+    for (int s = 0; s < 256; ++s) totalBits += frequencies[s] * lengths[s];
+
+    BitWriter writer(HEADER_BITS + totalBits);
+    writer.write(size, COUNT_BITS);
+    for (std::uint8_t len : lengths) writer.write(len, LENGTH_FIELD_BITS);
+
+    // 每 4 個符號 (最多 60 位元) 先在暫存器組好才寫入一次
+    i = 0;
+    for (; i + 4 <= size; i += 4) {
+        std::uint64_t v = 0;
+        int n = 0;
+        for (int j = 0; j < 4; ++j) {
+            const std::uint8_t s = in[i + j];
+            v = (v << lengths[s]) | codes[s];
+            n += lengths[s];
+        }
+        writer.write(v, n);
+    }
+    for (; i < size; ++i) writer.write(codes[in[i]], lengths[in[i]]);
+    return writer.take();
+}
+
+bool huffmanDecode (const BitBuffer& encoded, std::vector<std::uint8_t>& out) {
+    // 失敗時不留下解到一半的資料
+    if (decodeStream(encoded, out)) return true;
+    out.clear();
+    return false;
+}
+
+}  // namespace stego
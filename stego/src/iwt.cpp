@@ -0,0 +1,551 @@
+#include "stego/iwt.hpp"
+
+#include <algorithm>
+#include <vector>
+
+#include "location_map.hpp"
+
+namespace stego {
+
+namespace {
+
+// floor(h / 2)，對負數也成立
+inline int floorHalf (int h) { return h >> 1; }
+
+// --- lifting 核心 ---
+// 每個樣本是 LANES 個並排的獨立訊號 (行轉換時是相鄰的 LANES 行)，第 i 個樣本在 x + i * xStep
+// forward: n 個樣本 (偶數) 轉成低頻 lo[k * outStep] 與高頻 hi[k * outStep]，k < n / 2；inverse 相反
+// 輸入與輸出不能重疊 (呼叫端先把輸入搬到暫存)
+
+struct HaarLifting {
+    template <int LANES>
+    static void forward (const std::int32_t* x, std::ptrdiff_t xStep, int n, std::int32_t* lo, std::int32_t* hi, std::ptrdiff_t outStep) {
+        for (int k = 0; k < n / 2; ++k) {
+            const std::int32_t* x0 = x + 2 * k * xStep;
+            const std::int32_t* x1 = x0 + xStep;
+            std::int32_t* l = lo + k * outStep;
+            std::int32_t* h = hi + k * outStep;
+            for (int j = 0; j < LANES; ++j) {
+                const int d = x0[j] - x1[j];
+                h[j] = d;
+                l[j] = x1[j] + floorHalf(d);
+            }
+        }
+    }
+
+    template <int LANES>
+    static void inverse (const std::int32_t* lo, const std::int32_t* hi, std::ptrdiff_t inStep, int n, std::int32_t* x, std::ptrdiff_t xStep) {
+        for (int k = 0; k < n / 2; ++k) {
+            const std::int32_t* l = lo + k * inStep;
+            const std::int32_t* h = hi + k * inStep;
+            std::int32_t* x0 = x + 2 * k * xStep;
+            std::int32_t* x1 = x0 + xStep;
+            for (int j = 0; j < LANES; ++j) {
+                const int v1 = l[j] - floorHalf(h[j]);
+                x1[j] = v1;
+                x0[j] = h[j] + v1;
+            }
+        }
+    }
+};
+
+struct LeGall53Lifting {
+    // 對稱延伸: x[n] = x[n - 2]，d[-1] = d[0]
+    template <int LANES>
+    static void forward (const std::int32_t* x, std::ptrdiff_t xStep, int n, std::int32_t* lo, std::int32_t* hi, std::ptrdiff_t outStep) {
+        const int half = n / 2;
+        for (int k = 0; k < half; ++k) {  // predict
+            const std::int32_t* x0 = x + 2 * k * xStep;
+            const std::int32_t* x1 = x0 + xStep;
+            const std::int32_t* x2 = k + 1 < half ? x1 + xStep : x0;
+            std::int32_t* h = hi + k * outStep;
+            for (int j = 0; j < LANES; ++j) h[j] = x1[j] - floorHalf(x0[j] + x2[j]);
+        }
+        for (int k = 0; k < half; ++k) {  // update
+            const std::int32_t* x0 = x + 2 * k * xStep;
+            const std::int32_t* h = hi + k * outStep;
+            const std::int32_t* hp = k > 0 ? h - outStep : h;
+            std::int32_t* l = lo + k * outStep;
+            for (int j = 0; j < LANES; ++j) l[j] = x0[j] + ((hp[j] + h[j] + 2) >> 2);
+        }
+    }
+
+    template <int LANES>
+    static void inverse (const std::int32_t* lo, const std::int32_t* hi, std::ptrdiff_t inStep, int n, std::int32_t* x, std::ptrdiff_t xStep) {
+        const int half = n / 2;
+        for (int k = 0; k < half; ++k) {  // 還原偶數樣本
+            const std::int32_t* l = lo + k * inStep;
+            const std::int32_t* h = hi + k * inStep;
+            const std::int32_t* hp = k > 0 ? h - inStep : h;
+            std::int32_t* x0 = x + 2 * k * xStep;
+            for (int j = 0; j < LANES; ++j) x0[j] = l[j] - ((hp[j] + h[j] + 2) >> 2);
+        }
+        for (int k = 0; k < half; ++k) {  // 還原奇數樣本
+            const std::int32_t* h = hi + k * inStep;
+            std::int32_t* x0 = x + 2 * k * xStep;
+            const std::int32_t* x2 = k + 1 < half ? x0 + 2 * xStep : x0;
+            std::int32_t* x1 = x0 + xStep;
+            for (int j = 0; j < LANES; ++j) x1[j] = h[j] + floorHalf(x0[j] + x2[j]);
+        }
+    }
+};
+
+constexpr int COLUMN_BLOCK = 16;  // 行轉換一次處理的行數 (16 個 int32 = 一條 64 bytes 快取列)
+
+bool validLevels (ImageView<const std::int32_t> coeffs, int levels) {
+    if (coeffs.empty() || coeffs.channels != 1 || levels < 1 || levels > 30) return false;
+    const int mask = (1 << levels) - 1;
+    return (coeffs.rows & mask) == 0 && (coeffs.cols & mask) == 0;
+}
+
+std::size_t scratchSize (ImageView<const std::int32_t> coeffs) {
+    return std::max(static_cast<std::size_t>(coeffs.cols), static_cast<std::size_t>(coeffs.rows) * COLUMN_BLOCK);
+}
+
+// 列轉換: L 放左半、H 放右半
+template <typename Lifting>
+void forwardRows (ImageView<std::int32_t> region, std::int32_t* scratch) {
+    const int half = region.cols / 2;
+    for (int r = 0; r < region.rows; ++r) {
+        std::int32_t* row = region.ptr(r);
+        std::copy(row, row + region.cols, scratch);
+        Lifting::template forward<1>(scratch, 1, region.cols, row, row + half, 1);
+    }
+}
+
+template <typename Lifting>
+void inverseRows (ImageView<std::int32_t> region, std::int32_t* scratch) {
+    const int half = region.cols / 2;
+    for (int r = 0; r < region.rows; ++r) {
+        std::int32_t* row = region.ptr(r);
+        std::copy(row, row + region.cols, scratch);
+        Lifting::template inverse<1>(scratch, scratch + half, 1, region.cols, row, 1);
+    }
+}
+
+// 把 [c0, c0 + width) 行搬進暫存 (每列 COLUMN_BLOCK 個元素)
+void loadColumns (ImageView<const std::int32_t> region, int c0, int width, std::int32_t* scratch) {
+    for (int r = 0; r < region.rows; ++r) std::copy(region.ptr(r) + c0, region.ptr(r) + c0 + width, scratch + r * COLUMN_BLOCK);
+}
+
+// 行轉換: L 放上半、H 放下半；每次處理 COLUMN_BLOCK 行，內層迴圈沿著列連續存取
+template <typename Lifting>
+void forwardColumns (ImageView<std::int32_t> region, std::int32_t* scratch) {
+    const int half = region.rows / 2;
+    int c0 = 0;
+    for (; c0 + COLUMN_BLOCK <= region.cols; c0 += COLUMN_BLOCK) {
+        loadColumns(region, c0, COLUMN_BLOCK, scratch);
+        Lifting::template forward<COLUMN_BLOCK>(scratch, COLUMN_BLOCK, region.rows, region.ptr(0) + c0, region.ptr(half) + c0, region.step);
+    }
+    if (c0 == region.cols) return;
+    const int rest = region.cols - c0;
+    loadColumns(region, c0, rest, scratch);
+    for (int j = 0; j < rest; ++j) {
+        Lifting::template forward<1>(scratch + j, COLUMN_BLOCK, region.rows, region.ptr(0) + c0 + j, region.ptr(half) + c0 + j, region.step);
+    }
+}
+
+template <typename Lifting>
+void inverseColumns (ImageView<std::int32_t> region, std::int32_t* scratch) {
+    const std::int32_t* hiRows = scratch + static_cast<std::ptrdiff_t>(region.rows / 2) * COLUMN_BLOCK;
+    int c0 = 0;
+    for (; c0 + COLUMN_BLOCK <= region.cols; c0 += COLUMN_BLOCK) {
+        loadColumns(region, c0, COLUMN_BLOCK, scratch);
+        Lifting::template inverse<COLUMN_BLOCK>(scratch, hiRows, COLUMN_BLOCK, region.rows, region.ptr(0) + c0, region.step);
+    }
+    if (c0 == region.cols) return;
+    const int rest = region.cols - c0;
+    loadColumns(region, c0, rest, scratch);
+    for (int j = 0; j < rest; ++j) {
+        Lifting::template inverse<1>(scratch + j, hiRows + j, COLUMN_BLOCK, region.rows, region.ptr(0) + c0 + j, region.step);
+    }
+}
+
+// 盲提取的標頭: 峰點 (16 位元，加上 32768)、方向 (1)、hsStart (32)、溢位數 (32)、溢位表位元組數 (32)
+constexpr int BLIND_HEADER_BITS = 16 + 1 + 32 + 32 + 32;
+
+// HH 係數 (r, c) 換成 hh 之後，所屬 2x2 區塊反轉換的像素是否都在 [0, 255] (計算同 inverseIWTHaar)
+bool blockInRange (ImageView<const std::int32_t> coeffs, int r, int c, int hh) {
+    const int hr = coeffs.rows / 2, hc = coeffs.cols / 2;
+    const int ll = coeffs.ptr(r)[c], hl = coeffs.ptr(r)[hc + c], lh = coeffs.ptr(hr + r)[c];
+    // 行反轉換 (L、H 兩行)
+    const int l1 = ll - floorHalf(lh), l0 = lh + l1;
+    const int h1 = hl - floorHalf(hh), h0 = hh + h1;
+    // 列反轉換 (上、下兩列)
+    const int a1 = l0 - floorHalf(h0), a0 = h0 + a1;
+    const int b1 = l1 - floorHalf(h1), b0 = h1 + b1;
+    auto inRange = [](int v) { return v >= 0 && v <= 255; };
+    return inRange(a0) && inRange(a1) && inRange(b0) && inRange(b1);
+}
+
+// 依列優先索引存取 HH 子帶
+struct HHIndex {
+    ImageView<std::int32_t> coeffs;
+    ImageView<std::int32_t> hh;
+
+    explicit HHIndex (ImageView<std::int32_t> c) : coeffs(c), hh(hhBand(c)) {}
+
+    std::size_t total () const { return hh.total(); }
+    int row (std::size_t i) const { return static_cast<int>(i / hh.cols); }
+    int col (std::size_t i) const { return static_cast<int>(i % hh.cols); }
+    std::int32_t& operator[] (std::size_t i) const { return hh.ptr(row(i))[col(i)]; }
+
+    bool inRange (std::size_t i, int value) const { return blockInRange(coeffs, row(i), col(i), value); }
+    // LSB 改成 0 或 1 都不會溢位 (與目前的 LSB 無關，提取端看到的結果相同)
+    bool lsbSafe (std::size_t i) const { return inRange(i, (*this)[i] & ~1) && inRange(i, (*this)[i] | 1); }
+};
+
+}  // namespace
+
+bool forwardIWT (ImageView<std::int32_t> coeffs, int levels, Wavelet wavelet) {
+    if (!validLevels(coeffs, levels)) return false;
+    std::vector<std::int32_t> scratch(scratchSize(coeffs));
+    for (int k = 0; k < levels; ++k) {
+        ImageView<std::int32_t> region = coeffs.roi(0, 0, coeffs.cols >> k, coeffs.rows >> k);
+        if (wavelet == Wavelet::LeGall53) {
+            forwardRows<LeGall53Lifting>(region, scratch.data());
+            forwardColumns<LeGall53Lifting>(region, scratch.data());
+        } else {
+            forwardRows<HaarLifting>(region, scratch.data());
+            forwardColumns<HaarLifting>(region, scratch.data());
+        }
+    }
+    return true;
+}
+
+bool inverseIWT (ImageView<std::int32_t> coeffs, int levels, Wavelet wavelet) {
+    if (!validLevels(coeffs, levels)) return false;
+    std::vector<std::int32_t> scratch(scratchSize(coeffs));
+    for (int k = levels - 1; k >= 0; --k) {
+        ImageView<std::int32_t> region = coeffs.roi(0, 0, coeffs.cols >> k, coeffs.rows >> k);
+        if (wavelet == Wavelet::LeGall53) {
+            inverseColumns<LeGall53Lifting>(region, scratch.data());
+            inverseRows<LeGall53Lifting>(region, scratch.data());
+        } else {
+            inverseColumns<HaarLifting>(region, scratch.data());
+            inverseRows<HaarLifting>(region, scratch.data());
+        }
+    }
+    return true;
+}
+
+Image<std::int32_t> forwardIWTHaar (ConstGrayView input) {
+    if (input.empty() || input.channels != 1 || input.rows % 2 != 0 || input.cols % 2 != 0) return Image<std::int32_t>();
+
+    Image<std::int32_t> output(input.rows, input.cols);
+    for (int r = 0; r < input.rows; ++r) std::copy(input.ptr(r), input.ptr(r) + input.cols, output.ptr(r));
+    forwardIWT(output.view(), 1, Wavelet::Haar);
+    return output;
+}
+
+Image<std::uint8_t> inverseIWTHaar (ImageView<const std::int32_t> input) {
+    if (input.empty() || input.rows % 2 != 0 || input.cols % 2 != 0) return Image<std::uint8_t>();
+
+    Image<std::int32_t> tmp = Image<std::int32_t>::clone(input);
+    inverseIWT(tmp.view(), 1, Wavelet::Haar);
+
+    // 鉗位回 8 位元
+    Image<std::uint8_t> output(input.rows, input.cols);
+    for (int r = 0; r < input.rows; ++r) {
+        const std::int32_t* in = tmp.ptr(r);
+        std::uint8_t* out = output.ptr(r);
+        for (int c = 0; c < input.cols; ++c) out[c] = static_cast<std::uint8_t>(std::clamp(in[c], 0, 255));
+    }
+    return output;
+}
+
+std::map<int, int> calculateHistogramInt (ImageView<const std::int32_t> intMatrix) {
+    std::map<int, int> histogram;
+    for (int r = 0; r < intMatrix.rows; ++r) {
+        const std::int32_t* rowPtr = intMatrix.ptr(r);
+        for (int c = 0; c < intMatrix.cols; ++c) {
+            histogram[rowPtr[c]]++;
+        }
+    }
+    return histogram;
+}
+
+int findPeakBinInt (const std::map<int, int>& histogram) {
+    int peakBin = INVALID_PEAK;
+    int maxFreq = -1;
+    for (const auto& [bin, freq] : histogram) {
+        if (freq > maxFreq && bin < std::numeric_limits<int>::max()) {
+            maxFreq = freq;
+            peakBin = bin;
+        }
+    }
+    return maxFreq <= 0 ? INVALID_PEAK : peakBin;
+}
+
+Image<std::int32_t> embedHSInHH (ImageView<const std::int32_t> iwtCoeffs, const BitBuffer& bits, int& peakBinHH) {
+    Image<std::int32_t> modified = Image<std::int32_t>::clone(iwtCoeffs);
+    ImageView<std::int32_t> hh = hhBand(modified.view());
+
+    std::map<int, int> histogram = calculateHistogramInt(hh);
+    peakBinHH = findPeakBinInt(histogram);
+    if (peakBinHH == INVALID_PEAK) return Image<std::int32_t>();
+    if (bits.size() > static_cast<std::size_t>(histogram.at(peakBinHH))) return Image<std::int32_t>();  // 容量不足
+
+    const int p = peakBinHH;
+    const int intMax = std::numeric_limits<int>::max();
+    const std::size_t total = bits.size();
+    std::size_t embedded = 0;
+
+    for (int r = 0; r < hh.rows; ++r) {
+        std::int32_t* rowPtr = hh.ptr(r);
+        for (int c = 0; c < hh.cols; ++c) {
+            int v = rowPtr[c];
+            if (v > p) {
+                if (v != intMax) rowPtr[c] = v + 1;
+            } else if (v == p && embedded < total) {
+                if (bits[embedded] && p != intMax) rowPtr[c] = p + 1;
+                ++embedded;
+            }
+        }
+    }
+    return modified;
+}
+
+BitBuffer extractRestoreHSInHH (ImageView<const std::int32_t> stegoCoeffs, int peakBinHH, Image<std::int32_t>& restoredCoeffs) {
+    BitWriter bits;
+    if (peakBinHH == INVALID_PEAK) {
+        restoredCoeffs = Image<std::int32_t>();
+        return bits.take();
+    }
+
+    restoredCoeffs = Image<std::int32_t>::clone(stegoCoeffs);
+    ImageView<std::int32_t> hh = hhBand(restoredCoeffs.view());
+    const int p = peakBinHH;
+
+    // 遍歷 HH 子帶：提取位元並還原係數
+    for (int r = 0; r < hh.rows; ++r) {
+        std::int32_t* rowPtr = hh.ptr(r);
+        for (int c = 0; c < hh.cols; ++c) {
+            int v = rowPtr[c];
+            if (v == p) {
+                bits.put(false);
+            } else if (v == p + 1) {
+                bits.put(true);
+                rowPtr[c] = p;
+            } else if (v > p + 1) {
+                rowPtr[c] = v - 1;
+            }
+        }
+    }
+    return bits.take();
+}
+
+void streamHSInHH (ImageView<const std::int32_t> stegoCoeffs, int peakBinHH, const ByteSink& sink) {
+    if (peakBinHH == INVALID_PEAK || stegoCoeffs.empty()) return;
+    ImageView<const std::int32_t> hh = hhBand(stegoCoeffs);
+    ByteAssembler out(sink);
+    const int p = peakBinHH;
+    for (int r = 0; r < hh.rows; ++r) {
+        const std::int32_t* rowPtr = hh.ptr(r);
+        for (int c = 0; c < hh.cols; ++c) {
+            if ((rowPtr[c] == p || rowPtr[c] == p + 1) && !out.put(rowPtr[c] - p, 1)) return;
+        }
+    }
+}
+
+Image<std::int32_t> restoreHSInHH (ImageView<const std::int32_t> stegoCoeffs, int peakBinHH) {
+    if (peakBinHH == INVALID_PEAK) return Image<std::int32_t>();
+
+    Image<std::int32_t> restored = Image<std::int32_t>::clone(stegoCoeffs);
+    ImageView<std::int32_t> hh = hhBand(restored.view());
+    const int p = peakBinHH;
+    // P+1 -> P，v > P+1 -> v - 1
+    for (int r = 0; r < hh.rows; ++r) {
+        std::int32_t* rowPtr = hh.ptr(r);
+        for (int c = 0; c < hh.cols; ++c) {
+            if (rowPtr[c] > p) --rowPtr[c];
+        }
+    }
+    return restored;
+}
+
+Image<std::int32_t> embedMessageHSInHH (ImageView<const std::int32_t> iwtCoeffs, const std::string& message, int& peakBinHH) {
+    BitBuffer bits = frameMessage(message, FrameAlgorithm::IWTHistogramShift, 0);
+    if (bits.empty()) return Image<std::int32_t>();  // 訊息過長
+    return embedHSInHH(iwtCoeffs, bits, peakBinHH);
+}
+
+std::string extractMessageHSInHH (ImageView<const std::int32_t> stegoCoeffs, int peakBinHH, Image<std::int32_t>& restoredCoeffs, FrameStatus* status) {
+    FrameReader reader(FrameAlgorithm::IWTHistogramShift, 0, hhBand(stegoCoeffs).total());
+    streamHSInHH(stegoCoeffs, peakBinHH, reader.sink());
+    restoredCoeffs = restoreHSInHH(stegoCoeffs, peakBinHH);
+    return reader.takeMessage(status);
+}
+
+bool embedBlindHSInHH (ConstGrayView cover, const BitBuffer& bits, Image<std::uint8_t>& stego) {
+    Image<std::int32_t> coeffs = forwardIWTHaar(cover);
+    if (coeffs.empty()) return false;
+    const HHIndex hh(coeffs.view());
+    const std::size_t total = hh.total();
+
+    std::map<int, int> histogram = calculateHistogramInt(hh.hh);
+    const int p = findPeakBinInt(histogram);
+    if (p == INVALID_PEAK) return false;
+    // 往係數較少的一側平移，失真較小
+    std::size_t above = 0, below = 0;
+    for (const auto& [bin, freq] : histogram) {
+        if (bin > p) above += freq;
+        else if (bin < p) below += freq;
+    }
+    const int d = above <= below ? 1 : -1;
+
+    // 峰點與平移側的係數會變成 v + d，修改後區塊溢位的係數不使用
+    auto overflows = [&](std::size_t i) {
+        const int v = hh[i];
+        return (v == p || (v - p) * d > 0) && !hh.inRange(i, v + d);
+    };
+
+    // 先以整個 HH 的溢位表決定保留區大小；HS 從保留區之後開始，實際的溢位表只會更短
+    std::vector<std::uint8_t> map;
+    std::size_t prev = 0;
+    for (std::size_t i = 0; i < total; ++i) {
+        if (overflows(i)) detail::appendLocation(map, prev, i);
+    }
+    std::vector<std::size_t> reserved;
+    const std::size_t needed = BLIND_HEADER_BITS + map.size() * 8;
+    for (std::size_t i = 0; i < total && reserved.size() < needed; ++i) {
+        if (hh.lsbSafe(i)) reserved.push_back(i);
+    }
+    if (reserved.size() < needed) return false;
+    const std::size_t hsStart = reserved.back() + 1;
+
+    map.clear();
+    prev = 0;
+    std::size_t overflowCount = 0, capacity = 0;
+    for (std::size_t i = hsStart; i < total; ++i) {
+        if (overflows(i)) {
+            detail::appendLocation(map, prev, i);
+            ++overflowCount;
+        } else if (hh[i] == p) {
+            ++capacity;
+        }
+    }
+    reserved.resize(BLIND_HEADER_BITS + map.size() * 8);
+
+    // 負載: 保留區原本的 LSB，接著是 bits
+    BitWriter payloadWriter(reserved.size() + bits.size());
+    for (std::size_t i : reserved) payloadWriter.put(hh[i] & 1);
+    payloadWriter.writeBits(bits);
+    const BitBuffer payload = payloadWriter.take();
+    if (payload.size() > capacity) return false;  // 容量不足
+
+    std::size_t embedded = 0;
+    for (std::size_t i = hsStart; i < total; ++i) {
+        const int v = hh[i];
+        if ((v != p && (v - p) * d <= 0) || overflows(i)) continue;
+        if (v != p) {
+            hh[i] = v + d;
+        } else {
+            if (embedded < payload.size() && payload[embedded]) hh[i] = p + d;
+            ++embedded;
+        }
+    }
+
+    // 標頭與溢位表寫入保留區的 LSB
+    BitWriter headerWriter(reserved.size());
+    headerWriter.write(static_cast<std::uint32_t>(p + 32768), 16);
+    headerWriter.put(d < 0);
+    headerWriter.write(hsStart, 32);
+    headerWriter.write(overflowCount, 32);
+    headerWriter.write(map.size(), 32);
+    headerWriter.writeBytes(map.data(), map.size());
+    const BitBuffer header = headerWriter.take();
+    for (std::size_t k = 0; k < reserved.size(); ++k) hh[reserved[k]] = (hh[reserved[k]] & ~1) | header[k];
+
+    // 所有區塊都已確認在範圍內，反轉換不會被鉗位
+    stego = inverseIWTHaar(coeffs.view());
+    return true;
+}
+
+BitBuffer extractRestoreBlindHSInHH (ConstGrayView stego, Image<std::uint8_t>& restored) {
+    restored = Image<std::uint8_t>();
+    Image<std::int32_t> coeffs = forwardIWTHaar(stego);
+    if (coeffs.empty()) return BitBuffer();
+    const HHIndex hh(coeffs.view());
+    const std::size_t total = hh.total();
+
+    // 依序讀取保留區的 LSB: 先是固定長度的標頭，再依標頭讀溢位表
+    std::vector<std::size_t> reserved;
+    std::size_t scan = 0;
+    auto readReserved = [&](std::size_t count) {
+        BitWriter lsb(count);
+        for (; scan < total && reserved.size() < count; ++scan) {
+            if (!hh.lsbSafe(scan)) continue;
+            reserved.push_back(scan);
+            lsb.put(hh[scan] & 1);
+        }
+        return lsb.take();
+    };
+
+    const BitBuffer header = readReserved(BLIND_HEADER_BITS);
+    if (reserved.size() < BLIND_HEADER_BITS) return BitBuffer();
+    BitReader reader(header);
+    const int p = static_cast<int>(reader.read(16)) - 32768;
+    const int d = reader.get() ? -1 : 1;
+    const std::size_t hsStart = reader.read(32);
+    const std::size_t overflowCount = reader.read(32);
+    const std::size_t mapBytes = reader.read(32);
+    if (hsStart > total || mapBytes > total / 8) return BitBuffer();
+
+    const BitBuffer mapBits = readReserved(BLIND_HEADER_BITS + mapBytes * 8);
+    std::vector<std::size_t> overflowed;
+    if (reserved.size() < BLIND_HEADER_BITS + mapBytes * 8 || reserved.back() >= hsStart ||
+        !detail::decodeLocations(mapBits.bytes(), overflowCount, total, overflowed) ||
+        (!overflowed.empty() && overflowed.front() < hsStart)) {
+        return BitBuffer();
+    }
+
+    // 提取並還原 HS 區
+    BitWriter writer;
+    auto next = overflowed.begin();
+    for (std::size_t i = hsStart; i < total; ++i) {
+        if (next != overflowed.end() && *next == i) {
+            ++next;
+            continue;
+        }
+        const int w = hh[i];
+        if (w == p) {
+            writer.put(false);
+        } else if (w == p + d) {
+            writer.put(true);
+            hh[i] = p;
+        } else if ((w - p) * d > 0) {
+            hh[i] = w - d;
+        }
+    }
+    const BitBuffer payload = writer.take();
+    if (payload.size() < reserved.size()) return BitBuffer();
+
+    // 寫回保留區原本的 LSB
+    for (std::size_t k = 0; k < reserved.size(); ++k) hh[reserved[k]] = (hh[reserved[k]] & ~1) | payload[k];
+    restored = inverseIWTHaar(coeffs.view());
+
+    BitWriter bits(payload.size() - reserved.size());
+    for (std::size_t pos = reserved.size(); pos < payload.size(); pos += 64) {
+        const int n = static_cast<int>(std::min<std::size_t>(64, payload.size() - pos));
+        bits.write(payload.read(pos, n), n);
+    }
+    return bits.take();
+}
+
+bool embedMessageBlindHSInHH (ConstGrayView cover, const std::string& message, Image<std::uint8_t>& stego) {
+    BitBuffer bits = frameMessage(message, FrameAlgorithm::BlindIWTHistogramShift, 0);
+    if (bits.empty()) return false;  // 訊息過長
+    return embedBlindHSInHH(cover, bits, stego);
+}
+
+std::string extractMessageBlindHSInHH (ConstGrayView stego, Image<std::uint8_t>& restored, FrameStatus* status) {
+    // 還原本來就要走訪整個 HH，因此先取出全部位元再交給 FrameReader
+    BitBuffer bits = extractRestoreBlindHSInHH(stego, restored);
+    FrameReader reader(FrameAlgorithm::BlindIWTHistogramShift, 0, bits.size() > FRAME_HEADER_BITS ? bits.size() - FRAME_HEADER_BITS : 0);
+    const std::size_t whole = bits.size() / 8;
+    for (std::size_t i = 0; i < whole && reader.push(bits.data()[i]); ++i) {}
+    return reader.takeMessage(status);
+}
+
+}  // namespace stego
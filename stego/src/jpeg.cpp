@@ -0,0 +1,212 @@
+#include "stego/jpeg.hpp"
+
+#include <algorithm>
+#include <csetjmp>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+
+extern "C" {
+#include <jpeglib.h>
+#include <jerror.h>
+}
+
+#include "stego/dct.hpp"
+
+namespace stego {
+
+namespace {
+
+// libjpeg 預設遇到錯誤會直接 exit()，改成 longjmp 回到呼叫端並回傳失敗
+struct ErrorManager {
+    jpeg_error_mgr pub;
+    std::jmp_buf jump;
+};
+
+void onError (j_common_ptr cinfo) {
+    std::longjmp(reinterpret_cast<ErrorManager*>(cinfo->err)->jump, 1);
+}
+
+// 不輸出訊息；資料提早結束 (libjpeg 補上假的 EOI 後繼續解碼，只發出警告) 當作錯誤，
+// 否則截斷的檔案會被當成完整的圖片讀入並重新編碼
+void onMessage (j_common_ptr cinfo, int msgLevel) {
+    if (msgLevel >= 0) return;  // 追蹤訊息
+    ++cinfo->err->num_warnings;
+    if (cinfo->err->msg_code == JWRN_JPEG_EOF) onError(cinfo);
+}
+
+// 逐列 (區塊列) 走訪亮度分量的係數，visit(row, widthInBlocks) 回傳 false 時停止
+using CoefVisitor = std::function<bool(JBLOCKROW, JDIMENSION)>;
+
+bool isMarker (const jpeg_saved_marker_ptr m, int marker, const char* tag, unsigned len) {
+    return m->marker == marker && m->data_length >= len && std::memcmp(m->data, tag, len) == 0;
+}
+
+// 一次轉碼用到的 libjpeg 狀態與輸出緩衝區。放在呼叫 setjmp 的函式 (transcode) 之外：
+// 在 setjmp 之後被修改的區域變數 (例如 jpeg_mem_dest 寫入的緩衝區指標) longjmp 回來時值不確定
+struct Codec {
+    jpeg_decompress_struct src;
+    jpeg_compress_struct dst;
+    ErrorManager err;
+    unsigned char* outBuf = nullptr;
+    unsigned long outSize = 0;
+};
+
+bool transcode (Codec& codec, const JPEGBytes& in, const CoefVisitor& visit, JPEGBytes* out) {
+    jpeg_decompress_struct& src = codec.src;
+    jpeg_compress_struct& dst = codec.dst;
+    // setjmp 之後不建立需要解構的物件，資源由 processCoefficients 釋放
+    if (setjmp(codec.err.jump)) return false;
+
+    jpeg_mem_src(&src, in.data(), static_cast<unsigned long>(in.size()));
+    if (out) {
+        // 保留註解與 APPn (EXIF、ICC profile...)，寫回時原樣複製
+        jpeg_save_markers(&src, JPEG_COM, 0xFFFF);
+        for (int m = 0; m < 16; ++m) jpeg_save_markers(&src, JPEG_APP0 + m, 0xFFFF);
+    }
+    jpeg_read_header(&src, TRUE);
+    jvirt_barray_ptr* coefs = jpeg_read_coefficients(&src);
+
+    const jpeg_component_info* luma = &src.comp_info[0];
+    for (JDIMENSION r = 0; r < luma->height_in_blocks; ++r) {
+        JBLOCKARRAY rows = (*src.mem->access_virt_barray)(reinterpret_cast<j_common_ptr>(&src), coefs[0], r, 1, out ? TRUE : FALSE);
+        if (!visit(rows[0], luma->width_in_blocks)) break;
+    }
+
+    if (out) {
+        jpeg_copy_critical_parameters(&src, &dst);
+        dst.optimize_coding = TRUE;  // 依修改後的係數重建 Huffman 表，檔案不會因預設表而變大
+        if (src.progressive_mode) jpeg_simple_progression(&dst);  // 漸進式 JPEG 維持漸進式
+        jpeg_mem_dest(&dst, &codec.outBuf, &codec.outSize);
+        jpeg_write_coefficients(&dst, coefs);
+        for (jpeg_saved_marker_ptr m = src.marker_list; m; m = m->next) {
+            // JFIF / Adobe 標記由 libjpeg 自行產生，略過避免重複 (同 jpegtran)
+            if (dst.write_JFIF_header && isMarker(m, JPEG_APP0, "JFIF", 5)) continue;
+            if (dst.write_Adobe_marker && isMarker(m, JPEG_APP0 + 14, "Adobe", 5)) continue;
+            jpeg_write_marker(&dst, m->marker, m->data, m->data_length);
+        }
+        jpeg_finish_compress(&dst);
+        out->assign(codec.outBuf, codec.outBuf + codec.outSize);
+    }
+    return true;
+}
+
+// 讀入 in 的量化係數並交給 visit；out 不為 nullptr 時把 (可能已修改的) 係數重新熵編碼寫入 out
+// 失敗 (不是有效的 JPEG 或資料不完整) 時回傳 false
+bool processCoefficients (const JPEGBytes& in, const CoefVisitor& visit, JPEGBytes* out) {
+    Codec codec;
+    codec.src.err = jpeg_std_error(&codec.err.pub);
+    codec.dst.err = &codec.err.pub;
+    codec.err.pub.error_exit = onError;
+    codec.err.pub.emit_message = onMessage;
+    jpeg_create_decompress(&codec.src);
+    jpeg_create_compress(&codec.dst);
+
+    const bool ok = transcode(codec, in, visit, out);
+
+    jpeg_destroy_compress(&codec.dst);
+    jpeg_destroy_decompress(&codec.src);
+    std::free(codec.outBuf);
+    return ok;
+}
+
+// 區塊中可以攜帶位元的係數 (ZigZag 前 used 個 AC 係數中不為 0、1 者)，f(coef) 回傳 false 時停止
+template <typename F>
+bool forEachUsableCoef (JBLOCKROW row, JDIMENSION blocks, int used, F&& f) {
+    for (JDIMENSION b = 0; b < blocks; ++b) {
+        JCOEF* block = row[b];
+        for (int k = 0; k < used; ++k) {
+            JCOEF& c = block[ZIGZAG_ID[k][0] * DCT_BLOCK + ZIGZAG_ID[k][1]];
+            if (c == 0 || c == 1) continue;
+            if (!f(c)) return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+std::size_t capacityJPEG (const JPEGBytes& jpeg, int coeffsPerBlock) {
+    const int used = std::min(coeffsPerBlock, 20);
+    std::size_t count = 0;
+    if (used <= 0) return 0;
+    bool ok = processCoefficients(jpeg, [&](JBLOCKROW row, JDIMENSION blocks) {
+        return forEachUsableCoef(row, blocks, used, [&](JCOEF&) {
+            ++count;
+            return true;
+        });
+    }, nullptr);
+    return ok ? count : 0;
+}
+
+JPEGBytes embedJPEG (const JPEGBytes& cover, const BitBuffer& bits, int coeffsPerBlock, std::size_t& bitsEmbedded) {
+    const int used = std::min(coeffsPerBlock, 20);
+    const std::size_t N = bits.size();
+    std::size_t id = 0;
+    JPEGBytes out;
+    bitsEmbedded = 0;
+    bool ok = processCoefficients(cover, [&](JBLOCKROW row, JDIMENSION blocks) {
+        return forEachUsableCoef(row, blocks, used, [&](JCOEF& c) {
+            if (id >= N) return false;
+            // 二補數下 (c & ~1) 對負數一樣只清掉最低位元，修改後不會變成 0 或 1
+            c = static_cast<JCOEF>((c & ~1) | bits[id++]);
+            return true;
+        });
+    }, &out);
+    if (!ok) return JPEGBytes();
+    bitsEmbedded = id;
+    return out;
+}
+
+BitBuffer extractJPEG (const JPEGBytes& stego, int coeffsPerBlock, std::size_t numBits) {
+    const int used = std::min(coeffsPerBlock, 20);
+    BitWriter writer(numBits);
+    if (numBits == 0) return writer.take();
+    processCoefficients(stego, [&](JBLOCKROW row, JDIMENSION blocks) {
+        return forEachUsableCoef(row, blocks, used, [&](JCOEF& c) {
+            writer.put((c & 1) != 0);
+            return writer.size() < numBits;
+        });
+    }, nullptr);
+    return writer.take();
+}
+
+void streamJPEG (const JPEGBytes& stego, int coeffsPerBlock, const ByteSink& sink) {
+    const int used = std::min(coeffsPerBlock, 20);
+    ByteAssembler out(sink);
+    processCoefficients(stego, [&](JBLOCKROW row, JDIMENSION blocks) {
+        return forEachUsableCoef(row, blocks, used, [&](JCOEF& c) { return out.put(c & 1, 1); });
+    }, nullptr);
+}
+
+bool embedMessageJPEG (const JPEGBytes& cover, JPEGBytes& stego, const std::string& msg, int coeffsPerBlock) {
+    BitBuffer bits = frameMessage(msg, FrameAlgorithm::JPEGZigZag, static_cast<std::uint16_t>(coeffsPerBlock));
+    if (bits.empty() || bits.size() > capacityJPEG(cover, coeffsPerBlock)) return false;
+    std::size_t bitsEmbedded = 0;
+    JPEGBytes out = embedJPEG(cover, bits, coeffsPerBlock, bitsEmbedded);
+    if (out.empty() || bitsEmbedded < bits.size()) return false;
+    stego = std::move(out);
+    return true;
+}
+
+std::string extractMessageJPEG (const JPEGBytes& stego, int coeffsPerBlock, FrameStatus* status) {
+    // 容量要走訪完所有係數才知道，因此一次取出全部可用的 LSB (只解碼一次) 再交給 FrameReader
+    const int used = std::min(coeffsPerBlock, 20);
+    BitWriter writer;
+    if (used > 0) {
+        processCoefficients(stego, [&](JBLOCKROW row, JDIMENSION blocks) {
+            return forEachUsableCoef(row, blocks, used, [&](JCOEF& c) {
+                writer.put((c & 1) != 0);
+                return true;
+            });
+        }, nullptr);
+    }
+    BitBuffer bits = writer.take();
+    FrameReader reader(FrameAlgorithm::JPEGZigZag, static_cast<std::uint16_t>(coeffsPerBlock), bits.size() > FRAME_HEADER_BITS ? bits.size() - FRAME_HEADER_BITS : 0);
+    const std::size_t whole = bits.size() / 8;
+    for (std::size_t i = 0; i < whole && reader.push(bits.data()[i]); ++i) {}
+    return reader.takeMessage(status);
+}
+
+}  // namespace stego
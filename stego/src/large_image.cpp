@@ -0,0 +1,291 @@
+#include "stego/large_image.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define STEGO_HAVE_MMAP 1
+#endif
+
+namespace stego {
+
+namespace {
+
+// --- TIFF 解析 (只取本模組需要的欄位) ---
+struct TIFFReader {
+    const std::uint8_t* data;
+    std::size_t size;
+    bool bigEndian = false;
+    bool big = false;  // BigTIFF: 偏移與計數為 8 位元組
+
+    bool has (std::uint64_t offset, std::uint64_t n) const { return offset <= size && n <= size - offset; }
+
+    // count 個 elemBytes 位元組的陣列是否在檔案內；count 來自檔案，先除再比較以免乘積溢位
+    bool hasArray (std::uint64_t offset, std::uint64_t count, std::uint64_t elemBytes) const {
+        return offset <= size && count <= (size - offset) / elemBytes;
+    }
+
+    std::uint64_t read (std::uint64_t offset, int bytes) const {
+        std::uint64_t v = 0;
+        for (int i = 0; i < bytes; ++i) {
+            const int shift = bigEndian ? 8 * (bytes - 1 - i) : 8 * i;
+            v |= static_cast<std::uint64_t>(data[offset + i]) << shift;
+        }
+        return v;
+    }
+};
+
+struct TIFFEntry {
+    int type = 0;
+    std::uint64_t count = 0;
+    std::uint64_t valueOffset = 0;  // 值所在的檔案位置 (放得下時就是欄位本身)
+};
+
+int typeSize (int type) {
+    switch (type) {
+    case 1: return 1;   // BYTE
+    case 3: return 2;   // SHORT
+    case 4: return 4;   // LONG
+    case 16: return 8;  // LONG8
+    default: return 0;
+    }
+}
+
+// 讀取整數陣列欄位，型別不支援或超出檔案時回傳 false
+bool readValues (const TIFFReader& t, const TIFFEntry& e, std::vector<std::uint64_t>& out) {
+    const int sz = typeSize(e.type);
+    if (sz == 0 || e.count == 0 || !t.hasArray(e.valueOffset, e.count, sz)) return false;
+    out.resize(e.count);
+    for (std::uint64_t i = 0; i < e.count; ++i) out[i] = t.read(e.valueOffset + i * sz, sz);
+    return true;
+}
+
+bool readValue (const TIFFReader& t, const TIFFEntry& e, std::uint64_t& out) {
+    std::vector<std::uint64_t> v;
+    if (!readValues(t, e, v)) return false;
+    out = v[0];
+    return true;
+}
+
+}  // namespace
+
+MappedGrayImage::~MappedGrayImage () { close(); }
+
+void MappedGrayImage::close () {
+#ifdef STEGO_HAVE_MMAP
+    if (data_) munmap(const_cast<std::uint8_t*>(data_), size_);
+#endif
+    data_ = nullptr;
+    size_ = 0;
+    rows_ = cols_ = blockRows_ = blockCols_ = 0;
+    blockOffsets_.clear();
+    invert_ = false;
+    releasedRows_ = 0;
+}
+
+bool MappedGrayImage::map (const std::string& path) {
+    close();
+#ifdef STEGO_HAVE_MMAP
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        ::close(fd);
+        return false;
+    }
+    void* p = mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);  // 映射建立後就不需要檔案描述子
+    if (p == MAP_FAILED) return false;
+    madvise(p, static_cast<std::size_t>(st.st_size), MADV_SEQUENTIAL);  // 依列讀取，讓核心預讀並及早回收
+    data_ = static_cast<const std::uint8_t*>(p);
+    size_ = static_cast<std::size_t>(st.st_size);
+    return true;
+#else
+    (void)path;
+    return false;
+#endif
+}
+
+bool MappedGrayImage::openRaw (const std::string& path, int rows, int cols, std::size_t offset) {
+    if (rows <= 0 || cols <= 0 || !map(path)) return false;
+    const std::uint64_t bytes = static_cast<std::uint64_t>(rows) * cols;
+    if (offset > size_ || bytes > size_ - offset) {
+        close();
+        return false;
+    }
+    rows_ = blockRows_ = rows;
+    cols_ = blockCols_ = cols;
+    blockOffsets_.assign(1, offset);
+    return true;
+}
+
+bool MappedGrayImage::openTIFF (const std::string& path) {
+    if (!map(path)) return false;
+    auto fail = [this] {
+        close();
+        return false;
+    };
+
+    TIFFReader t{data_, size_};
+    if (size_ < 8) return fail();
+    if (data_[0] == 'M' && data_[1] == 'M') t.bigEndian = true;
+    else if (data_[0] != 'I' || data_[1] != 'I') return fail();
+    const std::uint64_t version = t.read(2, 2);
+    if (version == 43) t.big = true;
+    else if (version != 42) return fail();
+
+    const int offBytes = t.big ? 8 : 4;
+    const std::uint64_t ifd = t.big ? (t.has(8, 8) ? t.read(8, 8) : 0) : t.read(4, 4);
+    const int countBytes = t.big ? 8 : 2, entryBytes = t.big ? 20 : 12;
+    if (!t.has(ifd, countBytes)) return fail();
+    const std::uint64_t entries = t.read(ifd, countBytes);
+    if (!t.hasArray(ifd + countBytes, entries, entryBytes)) return fail();
+
+    // 需要的欄位: 寬、高、每樣本位元數、壓縮、光度、樣本數、條帶或分塊
+    TIFFEntry width, height, bits, compression, photometric, samples, stripOffsets, rowsPerStrip, tileWidth, tileLength, tileOffsets;
+    for (std::uint64_t i = 0; i < entries; ++i) {
+        const std::uint64_t at = ifd + countBytes + i * entryBytes;
+        TIFFEntry e;
+        const int tag = static_cast<int>(t.read(at, 2));
+        e.type = static_cast<int>(t.read(at + 2, 2));
+        e.count = t.read(at + 4, offBytes);
+        // 值放得下欄位本身 (count * 型別大小 <= offBytes) 時就在欄位內，同樣先除以免溢位
+        const int sz = typeSize(e.type);
+        const bool inlineValue = sz == 0 || e.count <= static_cast<std::uint64_t>(offBytes / sz);
+        e.valueOffset = inlineValue ? at + 4 + offBytes : t.read(at + 4 + offBytes, offBytes);
+        switch (tag) {
+        case 256: width = e; break;
+        case 257: height = e; break;
+        case 258: bits = e; break;
+        case 259: compression = e; break;
+        case 262: photometric = e; break;
+        case 273: stripOffsets = e; break;
+        case 277: samples = e; break;
+        case 278: rowsPerStrip = e; break;
+        case 322: tileWidth = e; break;
+        case 323: tileLength = e; break;
+        case 324: tileOffsets = e; break;
+        default: break;
+        }
+    }
+
+    std::uint64_t w = 0, h = 0, b = 8, comp = 1, photo = 1, spp = 1;
+    if (!readValue(t, width, w) || !readValue(t, height, h)) return fail();
+    if (bits.count && !readValue(t, bits, b)) return fail();
+    if (compression.count && !readValue(t, compression, comp)) return fail();
+    if (photometric.count && !readValue(t, photometric, photo)) return fail();
+    if (samples.count && !readValue(t, samples, spp)) return fail();
+    if (w == 0 || h == 0 || w > 0x7FFFFFFF || h > 0x7FFFFFFF || b != 8 || comp != 1 || spp != 1 || photo > 1) return fail();
+
+    std::uint64_t bw = w, bh = h;
+    if (tileOffsets.count) {
+        if (!readValue(t, tileWidth, bw) || !readValue(t, tileLength, bh) || !readValues(t, tileOffsets, blockOffsets_)) return fail();
+    } else {
+        if (rowsPerStrip.count && !readValue(t, rowsPerStrip, bh)) return fail();
+        if (!readValues(t, stripOffsets, blockOffsets_)) return fail();
+    }
+    if (bw == 0 || bh == 0 || bw > 0x7FFFFFFF) return fail();
+    bh = std::min(bh, h);
+
+    // 檢查每個區塊都完整落在檔案內 (條帶的最後一塊可以比較短)
+    const std::uint64_t across = (w + bw - 1) / bw, down = (h + bh - 1) / bh;
+    if (blockOffsets_.size() < across * down) return fail();
+    for (std::uint64_t i = 0; i < across * down; ++i) {
+        const std::uint64_t blockHeight = tileOffsets.count ? bh : std::min(bh, h - (i / across) * bh);
+        if (!t.hasArray(blockOffsets_[i], blockHeight, bw)) return fail();
+    }
+
+    rows_ = static_cast<int>(h);
+    cols_ = static_cast<int>(w);
+    blockRows_ = static_cast<int>(bh);
+    blockCols_ = static_cast<int>(bw);
+    invert_ = photo == 0;
+    return true;
+}
+
+// 每讀過這麼多列才交還一次頁面，避免每列都呼叫 madvise
+constexpr int RELEASE_STEP = 64;
+
+void MappedGrayImage::releasePages (std::uint64_t begin, std::uint64_t end) const {
+#ifdef STEGO_HAVE_MMAP
+    // 範圍向外對齊頁面；唯讀的檔案映射交還後再讀只會重新載入，多交還相鄰的資料不影響正確性
+    static const std::uint64_t page = static_cast<std::uint64_t>(sysconf(_SC_PAGESIZE));
+    const std::uint64_t base = reinterpret_cast<std::uintptr_t>(data_);
+    const std::uint64_t first = (base + begin) / page * page;
+    const std::uint64_t last = std::min((base + end + page - 1) / page * page, (base + size_ + page - 1) / page * page);
+    if (first < last) madvise(reinterpret_cast<void*>(first), last - first, MADV_DONTNEED);
+#else
+    (void)begin;
+    (void)end;
+#endif
+}
+
+void MappedGrayImage::releaseBefore (int r) const {
+    if (r < releasedRows_ + RELEASE_STEP) return;
+    const int across = (cols_ + blockCols_ - 1) / blockCols_;
+    const std::uint64_t blockBytes = static_cast<std::uint64_t>(blockRows_) * blockCols_;
+    // 已經讀完的區塊列整塊交還
+    const int doneBlockRows = r / blockRows_;
+    for (int br = releasedRows_ / blockRows_; br < doneBlockRows; ++br) {
+        const int from = std::max(releasedRows_ - br * blockRows_, 0);
+        for (int b = 0; b < across; ++b) {
+            const std::uint64_t start = blockOffsets_[static_cast<std::size_t>(br) * across + b];
+            releasePages(start + static_cast<std::uint64_t>(from) * blockCols_, start + blockBytes);
+        }
+    }
+    // 每個區塊列只有一塊 (raw、條帶) 時，目前區塊內讀過的部分是連續的，也可以先交還
+    const int from = std::max(releasedRows_, doneBlockRows * blockRows_);
+    if (across == 1 && r > from) {
+        const std::uint64_t start = blockOffsets_[doneBlockRows];
+        releasePages(start + static_cast<std::uint64_t>(from - doneBlockRows * blockRows_) * blockCols_,
+                     start + static_cast<std::uint64_t>(r - doneBlockRows * blockRows_) * blockCols_);
+    }
+    releasedRows_ = r;
+}
+
+bool MappedGrayImage::readRow (int r, std::uint8_t* out) const {
+    if (!data_ || r < 0 || r >= rows_) return false;
+    releaseBefore(r);
+    const int across = (cols_ + blockCols_ - 1) / blockCols_;
+    const std::size_t first = static_cast<std::size_t>(r / blockRows_) * across;
+    const std::uint64_t inBlock = static_cast<std::uint64_t>(r % blockRows_) * blockCols_;
+    for (int b = 0; b < across; ++b) {
+        const int c0 = b * blockCols_;
+        const int n = std::min(blockCols_, cols_ - c0);
+        std::memcpy(out + c0, data_ + blockOffsets_[first + b] + inBlock, n);
+    }
+    if (invert_) {
+        for (int c = 0; c < cols_; ++c) out[c] = static_cast<std::uint8_t>(255 - out[c]);
+    }
+    return true;
+}
+
+std::string SubbandFileWriter::fileName (const std::string& prefix, int level, Subband band) {
+    static const char* const names[] = {"LL", "HL", "LH", "HH"};
+    return prefix + "_L" + std::to_string(level) + "_" + names[static_cast<int>(band)] + ".f32";
+}
+
+SubbandFileWriter::SubbandFileWriter (const std::string& prefix, int levels, bool everyLevelLL) : files_(static_cast<std::size_t>(std::max(levels, 0)) * 4) {
+    for (int level = 1; level <= levels; ++level) {
+        for (Subband band : {Subband::LL, Subband::HL, Subband::LH, Subband::HH}) {
+            if (band == Subband::LL && level != levels && !everyLevelLL) continue;
+            std::ofstream& f = files_[(level - 1) * 4 + static_cast<int>(band)];
+            f.open(fileName(prefix, level, band), std::ios::binary | std::ios::trunc);
+            ok_ = ok_ && f.is_open();
+        }
+    }
+}
+
+SubbandRowSink SubbandFileWriter::sink () {
+    return [this](int level, Subband band, int, const float* data, int width) {
+        std::ofstream& f = files_[(level - 1) * 4 + static_cast<int>(band)];
+        f.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(width) * sizeof(float));
+        return static_cast<bool>(f);
+    };
+}
+
+}  // namespace stego
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace stego {
+namespace detail {
+
+// --- 可逆嵌入的位置表 ---
+// 遞增的像素索引 (列優先) 差分後以 LEB128 編碼，相鄰位置越近佔的位元組越少
+
+inline void appendLocation (std::vector<std::uint8_t>& out, std::size_t& prev, std::size_t index) {
+    std::uint64_t v = index - prev;
+    prev = index;
+    while (v >= 0x80) {
+        out.push_back(static_cast<std::uint8_t>(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<std::uint8_t>(v));
+}
+
+// 解出 count 個位置，格式不符、不遞增或超出 limit 時回傳 false
+inline bool decodeLocations (const std::vector<std::uint8_t>& map, std::size_t count, std::size_t limit, std::vector<std::size_t>& positions) {
+    positions.clear();
+    positions.reserve(count);
+    std::size_t i = 0, prev = 0;
+    while (positions.size() < count) {
+        std::uint64_t v = 0;
+        int shift = 0;
+        for (;;) {
+            if (i >= map.size() || shift > 56) return false;
+            std::uint8_t b = map[i++];
+            v |= static_cast<std::uint64_t>(b & 0x7F) << shift;
+            shift += 7;
+            if (!(b & 0x80)) break;
+        }
+        if (!positions.empty() && v == 0) return false;
+        prev += static_cast<std::size_t>(v);
+        if (prev >= limit) return false;
+        positions.push_back(prev);
+    }
+    return i == map.size();
+}
+
+}  // namespace detail
+}  // namespace stego
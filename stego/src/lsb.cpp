@@ -0,0 +1,351 @@
+#include "stego/lsb.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "stego/parallel.hpp"
+#include "lsb_kernels.hpp"
+
+namespace stego {
+
+namespace {
+
+void checkK (int k) {
+    if (k < 1 || k > 8) {
+        throw std::invalid_argument("k 必須介於 1 到 8 之間");
+    }
+}
+
+// 依序走訪樣本 [firstSample, endSample) 的連續記憶體區段，f(ptr, n) 回傳 false 時停止
+// 連續影像視為單一區段，讓批次核心盡量少被列邊界打斷
+template <typename T, typename F>
+void forEachSegment (ImageView<T> image, std::size_t firstSample, std::size_t endSample, F&& f) {
+    endSample = std::min(endSample, image.samples());
+    if (firstSample >= endSample) return;
+    if (image.continuous()) {
+        f(image.data + firstSample, endSample - firstSample);
+        return;
+    }
+    const std::size_t rowLen = static_cast<std::size_t>(image.cols) * image.channels;
+    for (std::size_t s = firstSample; s < endSample;) {
+        std::size_t c = s % rowLen;
+        std::size_t n = std::min(rowLen - c, endSample - s);
+        if (!f(image.ptr(static_cast<int>(s / rowLen)) + c, n)) return;
+        s += n;
+    }
+}
+
+// 從負載的第 pos 個位元開始嵌入樣本 [firstSample, endSample)，負載用完即停止，回傳結束時的位元位置
+std::size_t embedRange (GrayView image, const BitBuffer& bits, std::size_t pos, int k, std::size_t firstSample, std::size_t endSample) {
+    const std::size_t N = bits.size();
+    const std::uint8_t mask = static_cast<std::uint8_t>(~((1 << k) - 1));  // 清除最低 k 位元的遮罩
+
+    forEachSegment(image, firstSample, endSample, [&](std::uint8_t* px, std::size_t n) {
+        std::size_t c = 0;
+        // 超過結尾的位元以 0 補齊
+        auto embedOne = [&] {
+            px[c] = static_cast<std::uint8_t>((px[c] & mask) | bits.read(pos, k));
+            pos += k;
+            ++c;
+        };
+        // 逐樣本處理到負載位置對齊 byte，再交給 SIMD 核心處理完整的負載區塊
+        while (c < n && pos < N && (pos & 7)) embedOne();
+        if (pos < N) {
+            std::size_t done = detail::embedLSBKernel(px + c, std::min(n - c, (N - pos) / k), bits.data() + (pos >> 3), k);
+            c += done;
+            pos += done * k;
+        }
+        while (c < n && pos < N) embedOne();
+        return pos < N;
+    });
+    return pos;
+}
+
+// 取出樣本 [firstSample, endSample) 的位元接在 writer 後面，直到 writer 累積 numBits 個位元
+void extractRange (ConstGrayView image, BitWriter& writer, std::size_t numBits, int k, std::size_t firstSample, std::size_t endSample) {
+    forEachSegment(image, firstSample, endSample, [&](const std::uint8_t* px, std::size_t n) {
+        std::size_t c = 0;
+        auto extractOne = [&] {
+            int take = static_cast<int>(std::min<std::size_t>(k, numBits - writer.size()));
+            writer.write(px[c++] >> (k - take), take);
+        };
+        while (c < n && writer.size() < numBits && (writer.size() & 7)) extractOne();
+        if (writer.size() < numBits) {
+            // 只預留核心會填滿的完整區塊
+            const std::size_t block = detail::lsbKernelBlock(k);
+            std::size_t m = block ? std::min(n - c, (numBits - writer.size()) / k) / block * block : 0;
+            if (m) c += detail::extractLSBKernel(px + c, m, writer.appendBytes(m * k / 8), k);
+        }
+        while (c < n && writer.size() < numBits) extractOne();
+        return writer.size() < numBits;
+    });
+}
+
+// 平行模式的分段：把負載會用到的樣本切成 bands 段，每段長度為 BAND_ALIGN 的倍數
+// 因此每段的負載起點 (段起點 * k) 都對齊 byte，各段可以獨立嵌入/取出
+constexpr std::size_t BAND_ALIGN = 64;
+constexpr std::size_t MIN_BAND_SAMPLES = 1 << 16;  // 太小的分段不值得切換執行緒
+
+constexpr std::size_t STREAM_CHUNK = 256;  // 串流提取每次交給核心的樣本數 (核心區塊大小的倍數)
+
+std::size_t bandLength (std::size_t samples, int threads) {
+    std::size_t bands = std::max<std::size_t>(1, std::min<std::size_t>(static_cast<std::size_t>(resolveThreads(threads)) * 4, samples / MIN_BAND_SAMPLES));
+    std::size_t len = (samples + bands - 1) / bands;
+    return (len + BAND_ALIGN - 1) / BAND_ALIGN * BAND_ALIGN;
+}
+
+}  // namespace
+
+std::size_t capacityLSB (ConstGrayView image, int k) {
+    checkK(k);
+    return image.samples() * k;
+}
+
+std::size_t embedLSB (GrayView image, const BitBuffer& bits, int k, std::size_t firstSample) {
+    checkK(k);
+    if (bits.empty() || image.empty()) return 0;
+    return std::min(embedRange(image, bits, 0, k, firstSample, image.samples()), bits.size());
+}
+
+BitBuffer extractLSB (ConstGrayView image, std::size_t numBits, int k, std::size_t firstSample) {
+    checkK(k);
+    BitWriter writer(numBits);
+    if (numBits == 0 || image.empty()) return writer.take();
+    extractRange(image, writer, numBits, k, firstSample, image.samples());
+    return writer.take();
+}
+
+std::size_t embedLSBParallel (GrayView image, const BitBuffer& bits, int k, std::size_t firstSample, int threads) {
+    checkK(k);
+    if (bits.empty() || image.empty() || firstSample >= image.samples()) return 0;
+
+    // 負載需要的樣本數 (前綴和: 第 b 段的負載起點 = b * band * k)
+    const std::size_t samples = std::min((bits.size() + k - 1) / k, image.samples() - firstSample);
+    const std::size_t band = bandLength(samples, threads);
+    const std::size_t bands = (samples + band - 1) / band;
+    parallelFor(bands, [&](std::size_t b) {
+        const std::size_t begin = b * band;
+        embedRange(image, bits, begin * k, k, firstSample + begin, firstSample + std::min(begin + band, samples));
+    }, threads);
+    return std::min(samples * k, bits.size());
+}
+
+BitBuffer extractLSBParallel (ConstGrayView image, std::size_t numBits, int k, std::size_t firstSample, int threads) {
+    checkK(k);
+    if (numBits == 0 || image.empty() || firstSample >= image.samples()) return BitBuffer();
+
+    const std::size_t samples = std::min((numBits + k - 1) / k, image.samples() - firstSample);
+    const std::size_t band = bandLength(samples, threads);
+    const std::size_t bands = (samples + band - 1) / band;
+    std::vector<BitBuffer> parts(bands);
+    parallelFor(bands, [&](std::size_t b) {
+        const std::size_t begin = b * band;
+        const std::size_t want = std::min(numBits - begin * k, band * k);
+        BitWriter writer(want);
+        extractRange(image, writer, want, k, firstSample + begin, firstSample + std::min(begin + band, samples));
+        parts[b] = writer.take();
+    }, threads);
+
+    // 每段起點都對齊 byte，串接時直接複製
+    BitWriter writer(std::min(numBits, samples * k));
+    for (const BitBuffer& part : parts) writer.writeBits(part);
+    return writer.take();
+}
+
+bool embedMessageLSB (ConstGrayView cover, Image<std::uint8_t>& stego, const std::string& msg, int k, int threads) {
+    BitBuffer bits = frameMessage(msg, FrameAlgorithm::LSB, static_cast<std::uint16_t>(k));
+    if (bits.empty() || bits.size() > capacityLSB(cover, k)) return false;  // 訊息過長或容量不足
+
+    stego = Image<std::uint8_t>::clone(cover);
+    if (threads == 1) {
+        embedLSB(stego, bits, k);
+    } else {
+        embedLSBParallel(stego, bits, k, 0, threads);
+    }
+    return true;
+}
+
+void streamLSB (ConstGrayView stego, int k, const ByteSink& sink, std::size_t firstSample) {
+    checkK(k);
+    if (stego.empty()) return;
+    ByteAssembler out(sink);
+    std::uint8_t chunk[STREAM_CHUNK * 4 / 8];
+
+    forEachSegment(stego, firstSample, stego.samples(), [&](const std::uint8_t* px, std::size_t n) {
+        std::size_t c = 0;
+        while (c < n && !out.aligned()) {
+            if (!out.put(px[c++], k)) return false;
+        }
+        // 對齊後每次以核心取出一小段，sink 停止時最多多讀 STREAM_CHUNK 個樣本
+        const std::size_t block = detail::lsbKernelBlock(k);
+        while (block && n - c >= block) {
+            std::size_t m = std::min(n - c, STREAM_CHUNK) / block * block;
+            c += detail::extractLSBKernel(px + c, m, chunk, k);
+            if (!out.putBytes(chunk, m * k / 8)) return false;
+        }
+        for (; c < n; ++c) {
+            if (!out.put(px[c], k)) return false;
+        }
+        return true;
+    });
+}
+
+std::string extractMessageLSB (ConstGrayView stego, int k, FrameStatus* status) {
+    const std::size_t capacity = capacityLSB(stego, k);
+    FrameReader reader(FrameAlgorithm::LSB, static_cast<std::uint16_t>(k), capacity > FRAME_HEADER_BITS ? capacity - FRAME_HEADER_BITS : 0);
+    streamLSB(stego, k, reader.sink());
+    return reader.takeMessage(status);
+}
+
+Image<std::uint8_t> embedFixedLSB (ConstGrayView cover, const BitBuffer& payload, int k, std::size_t& bitsEmbedded) {
+    checkK(k);
+    bitsEmbedded = 0;
+    if (cover.empty() || cover.channels != 1 || cover.total() < static_cast<std::size_t>(FRAME_HEADER_BITS)) return Image<std::uint8_t>();
+
+    // 容量不足時截斷負載，讓標頭的長度與 CRC 對應實際嵌入的部分
+    const std::size_t room = (cover.total() - FRAME_HEADER_BITS) * k;
+    BitBuffer truncated;
+    const BitBuffer* body = &payload;
+    if (payload.size() > room) {
+        truncated = payload;
+        truncated.resize(room);
+        body = &truncated;
+    }
+
+    const BitBuffer header = frameHeader(*body, FrameAlgorithm::FixedLSB, static_cast<std::uint16_t>(k));
+    if (header.empty()) return Image<std::uint8_t>();  // 負載超過標頭長度欄位的範圍
+
+    Image<std::uint8_t> stego = Image<std::uint8_t>::clone(cover);
+    // 步驟 1: 前 FRAME_HEADER_BITS 個像素以 1 bit LSB 嵌入框架標頭
+    embedLSB(stego, header, 1);
+    // 步驟 2: 其餘像素依序嵌入 k 個位元
+    bitsEmbedded = embedLSB(stego, *body, k, FRAME_HEADER_BITS);
+    return stego;
+}
+
+BitBuffer extractFixedLSB (ConstGrayView stego, int k, FrameStatus* status) {
+    checkK(k);
+    FrameStatus result = FrameStatus::Incomplete;
+    BitBuffer payload;
+    if (!stego.empty() && stego.channels == 1 && stego.total() >= static_cast<std::size_t>(FRAME_HEADER_BITS)) {
+        FrameHeader header;
+        result = parseFrameHeader(extractLSB(stego, FRAME_HEADER_BITS, 1).data(), FrameAlgorithm::FixedLSB, static_cast<std::uint16_t>(k),
+                                  (stego.total() - FRAME_HEADER_BITS) * k, header);
+        if (result == FrameStatus::Ok) {
+            payload = extractLSB(stego, header.payloadBits, k, FRAME_HEADER_BITS);
+            result = verifyFramePayload(header, payload);
+        }
+    }
+    if (status) *status = result;
+    return result == FrameStatus::Ok ? payload : BitBuffer();
+}
+
+double blockVariance (ConstGrayView block) {
+    if (block.empty()) return -1.0;
+    double sum = 0.0, sumSq = 0.0;
+    for (int r = 0; r < block.rows; ++r) {
+        const std::uint8_t* row = block.ptr(r);
+        for (int c = 0; c < block.cols; ++c) {
+            sum += row[c];
+            sumSq += static_cast<double>(row[c]) * row[c];
+        }
+    }
+    double n = static_cast<double>(block.total());
+    double mean = sum / n;
+    return sumSq / n - mean * mean;
+}
+
+namespace {
+
+// 依原始影像決定可嵌入的像素，依序呼叫 f(pixel&)；f 回傳 false 時停止
+template <typename T, typename F>
+void forEachAdaptivePixel (ImageView<T> image, ConstGrayView varianceSource, int blockSize, double varianceThreshold, F&& f) {
+    for (int rb = 0; rb < image.rows; rb += blockSize) {
+        for (int cb = 0; cb < image.cols; cb += blockSize) {
+            int w = std::min(blockSize, image.cols - cb);
+            int h = std::min(blockSize, image.rows - rb);
+
+            // 平滑區 (k=0) 直接跳過，變異數必須基於未修改的原始影像計算
+            if (blockVariance(varianceSource.roi(cb, rb, w, h)) < varianceThreshold) continue;
+
+            for (int br = 0; br < h; ++br) {
+                for (int bc = 0; bc < w; ++bc) {
+                    // 前 FRAME_HEADER_BITS 個像素已用於框架標頭
+                    if (static_cast<long long>(rb + br) * image.cols + (cb + bc) < FRAME_HEADER_BITS) continue;
+                    if (!f(image.at(rb + br, cb + bc))) return;
+                }
+            }
+        }
+    }
+}
+
+// 適應性模式的框架參數: 區塊大小與 k
+std::uint16_t adaptiveParam (int blockSize, int k) {
+    return static_cast<std::uint16_t>((blockSize << 4) | k);
+}
+
+}  // namespace
+
+Image<std::uint8_t> embedAdaptiveLSB (ConstGrayView cover, const BitBuffer& payload, int blockSize, double varianceThreshold, int k, std::size_t& bitsEmbedded) {
+    checkK(k);
+    bitsEmbedded = 0;
+    if (cover.empty() || cover.channels != 1 || cover.total() < static_cast<std::size_t>(FRAME_HEADER_BITS)) return Image<std::uint8_t>();
+
+    // 先計算可嵌入的像素數，容量不足時截斷負載
+    std::size_t room = 0;
+    forEachAdaptivePixel(cover, cover, blockSize, varianceThreshold, [&](const std::uint8_t&) {
+        room += k;
+        return true;
+    });
+    BitBuffer truncated;
+    const BitBuffer* body = &payload;
+    if (payload.size() > room) {
+        truncated = payload;
+        truncated.resize(room);
+        body = &truncated;
+    }
+
+    const BitBuffer header = frameHeader(*body, FrameAlgorithm::AdaptiveLSB, adaptiveParam(blockSize, k));
+    if (header.empty()) return Image<std::uint8_t>();  // 負載超過標頭長度欄位的範圍
+
+    Image<std::uint8_t> stego = Image<std::uint8_t>::clone(cover);
+    embedLSB(stego, header, 1);
+
+    const std::uint8_t mask = static_cast<std::uint8_t>(~((1 << k) - 1));
+    BitReader reader(*body);
+    if (body->empty()) return stego;
+    forEachAdaptivePixel(stego.view(), cover, blockSize, varianceThreshold, [&](std::uint8_t& pixel) {
+        pixel = static_cast<std::uint8_t>((pixel & mask) | reader.read(k));
+        return !reader.done();
+    });
+    bitsEmbedded = body->size();
+    return stego;
+}
+
+BitBuffer extractAdaptiveLSB (ConstGrayView stego, ConstGrayView coverForVariance, int blockSize, double varianceThreshold, int k, FrameStatus* status) {
+    checkK(k);
+    FrameStatus result = FrameStatus::Incomplete;
+    BitBuffer payload;
+    if (!stego.empty() && !coverForVariance.empty() && stego.total() >= static_cast<std::size_t>(FRAME_HEADER_BITS)) {
+        FrameHeader header;
+        result = parseFrameHeader(extractLSB(stego, FRAME_HEADER_BITS, 1).data(), FrameAlgorithm::AdaptiveLSB, adaptiveParam(blockSize, k),
+                                  (stego.total() - FRAME_HEADER_BITS) * k, header);
+        if (result == FrameStatus::Ok) {
+            const std::size_t total = header.payloadBits;
+            BitWriter writer(total);
+            if (total > 0) {
+                forEachAdaptivePixel(stego, coverForVariance, blockSize, varianceThreshold, [&](const std::uint8_t& pixel) {
+                    int take = static_cast<int>(std::min<std::size_t>(k, total - writer.size()));
+                    writer.write(pixel >> (k - take), take);
+                    return writer.size() < total;
+                });
+            }
+            payload = writer.take();
+            result = verifyFramePayload(header, payload);
+        }
+    }
+    if (status) *status = result;
+    return result == FrameStatus::Ok ? payload : BitBuffer();
+}
+
+}  // namespace stego
@@ -0,0 +1,183 @@
+#include "lsb_kernels.hpp"
+
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define STEGO_LSB_X86 1
+#endif
+
+namespace stego {
+namespace detail {
+
+namespace {
+
+// 每 16 個樣本 (一個 128 位元通道) 的 pshufb 索引與位元遮罩
+// spread: 第 j 次處理取出每個樣本 k 個位元中的第 j 個 (在負載中的位置 p = i * k + j)
+// gather: 第 g 組 16 個輸出位元，通道 L 對應負載位置 p = 16g + 8 * (L / 8) + 7 - L % 8
+//         (movemask 把通道 L 放在第 L 個位元，反轉每個 byte 內的順序才會是 MSB-first)
+template <int K>
+struct LSBTables {
+    std::uint8_t spreadIdx[K][16] = {};
+    std::uint8_t spreadMask[K][16] = {};
+    std::uint8_t gatherIdx[K][16] = {};
+    std::uint8_t gatherMask[K][16] = {};
+
+    constexpr LSBTables () {
+        for (int j = 0; j < K; ++j) {
+            for (int i = 0; i < 16; ++i) {
+                int p = i * K + j;
+                spreadIdx[j][i] = static_cast<std::uint8_t>(p >> 3);
+                spreadMask[j][i] = static_cast<std::uint8_t>(0x80 >> (p & 7));
+
+                int q = 16 * j + 8 * (i >> 3) + 7 - (i & 7);
+                gatherIdx[j][i] = static_cast<std::uint8_t>(q / K);
+                gatherMask[j][i] = static_cast<std::uint8_t>(1 << (K - 1 - q % K));
+            }
+        }
+    }
+};
+
+template <int K>
+constexpr LSBTables<K> TABLES{};
+
+#ifdef STEGO_LSB_X86
+
+inline __m128i load16 (const std::uint8_t* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+
+// --- SSSE3: 一次 16 個樣本，使用 2k 個負載位元組 ---
+template <int K>
+__attribute__((target("ssse3"))) std::size_t embedSSSE3 (std::uint8_t* px, std::size_t n, const std::uint8_t* payload) {
+    const auto& t = TABLES<K>;
+    const __m128i keep = _mm_set1_epi8(static_cast<char>(0xFF << K));
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16, payload += 2 * K) {
+        std::uint8_t buf[16] = {};
+        std::memcpy(buf, payload, 2 * K);
+        const __m128i src = load16(buf);
+        __m128i val = _mm_setzero_si128();
+        for (int j = 0; j < K; ++j) {
+            const __m128i m = load16(t.spreadMask[j]);
+            __m128i b = _mm_cmpeq_epi8(_mm_and_si128(_mm_shuffle_epi8(src, load16(t.spreadIdx[j])), m), m);
+            val = _mm_or_si128(val, _mm_and_si128(b, _mm_set1_epi8(static_cast<char>(1 << (K - 1 - j)))));
+        }
+        __m128i* dst = reinterpret_cast<__m128i*>(px + i);
+        _mm_storeu_si128(dst, _mm_or_si128(_mm_and_si128(_mm_loadu_si128(dst), keep), val));
+    }
+    return i;
+}
+
+template <int K>
+__attribute__((target("ssse3"))) std::size_t extractSSSE3 (const std::uint8_t* px, std::size_t n, std::uint8_t* out) {
+    const auto& t = TABLES<K>;
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16, out += 2 * K) {
+        const __m128i p = load16(px + i);
+        for (int g = 0; g < K; ++g) {
+            const __m128i m = load16(t.gatherMask[g]);
+            __m128i b = _mm_cmpeq_epi8(_mm_and_si128(_mm_shuffle_epi8(p, load16(t.gatherIdx[g])), m), m);
+            std::uint16_t bits = static_cast<std::uint16_t>(_mm_movemask_epi8(b));
+            std::memcpy(out + 2 * g, &bits, 2);
+        }
+    }
+    return i;
+}
+
+// --- AVX2: 一次 32 個樣本，兩個 128 位元通道各自處理 16 個樣本 ---
+template <int K>
+__attribute__((target("avx2"))) std::size_t embedAVX2 (std::uint8_t* px, std::size_t n, const std::uint8_t* payload) {
+    const auto& t = TABLES<K>;
+    const __m256i keep = _mm256_set1_epi8(static_cast<char>(0xFF << K));
+    __m256i idx[K], msk[K], wt[K];
+    for (int j = 0; j < K; ++j) {
+        idx[j] = _mm256_broadcastsi128_si256(load16(t.spreadIdx[j]));
+        msk[j] = _mm256_broadcastsi128_si256(load16(t.spreadMask[j]));
+        wt[j] = _mm256_set1_epi8(static_cast<char>(1 << (K - 1 - j)));
+    }
+    std::size_t i = 0;
+    for (; i + 32 <= n; i += 32, payload += 4 * K) {
+        std::uint8_t buf[16] = {};
+        std::memcpy(buf, payload, 4 * K);
+        const __m128i x = load16(buf);
+        const __m256i src = _mm256_set_m128i(_mm_srli_si128(x, 2 * K), x);  // 高通道使用後 2k 個位元組
+        __m256i val = _mm256_setzero_si256();
+        for (int j = 0; j < K; ++j) {
+            __m256i b = _mm256_cmpeq_epi8(_mm256_and_si256(_mm256_shuffle_epi8(src, idx[j]), msk[j]), msk[j]);
+            val = _mm256_or_si256(val, _mm256_and_si256(b, wt[j]));
+        }
+        __m256i* dst = reinterpret_cast<__m256i*>(px + i);
+        _mm256_storeu_si256(dst, _mm256_or_si256(_mm256_and_si256(_mm256_loadu_si256(dst), keep), val));
+    }
+    return i;
+}
+
+template <int K>
+__attribute__((target("avx2"))) std::size_t extractAVX2 (const std::uint8_t* px, std::size_t n, std::uint8_t* out) {
+    const auto& t = TABLES<K>;
+    __m256i idx[K], msk[K];
+    for (int g = 0; g < K; ++g) {
+        idx[g] = _mm256_broadcastsi128_si256(load16(t.gatherIdx[g]));
+        msk[g] = _mm256_broadcastsi128_si256(load16(t.gatherMask[g]));
+    }
+    std::size_t i = 0;
+    for (; i + 32 <= n; i += 32, out += 4 * K) {
+        const __m256i p = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(px + i));
+        for (int g = 0; g < K; ++g) {
+            __m256i b = _mm256_cmpeq_epi8(_mm256_and_si256(_mm256_shuffle_epi8(p, idx[g]), msk[g]), msk[g]);
+            std::uint32_t bits = static_cast<std::uint32_t>(_mm256_movemask_epi8(b));
+            std::uint16_t lo = static_cast<std::uint16_t>(bits), hi = static_cast<std::uint16_t>(bits >> 16);
+            std::memcpy(out + 2 * g, &lo, 2);
+            std::memcpy(out + 2 * K + 2 * g, &hi, 2);
+        }
+    }
+    return i;
+}
+
+#endif  // STEGO_LSB_X86
+
+using EmbedFn = std::size_t (*)(std::uint8_t*, std::size_t, const std::uint8_t*);
+using ExtractFn = std::size_t (*)(const std::uint8_t*, std::size_t, std::uint8_t*);
+
+struct KernelSet {
+    std::size_t block = 0;
+    EmbedFn embed[5] = {};
+    ExtractFn extract[5] = {};
+};
+
+// 依 CPU 支援的指令集選擇核心 (只在第一次使用時偵測)
+const KernelSet& kernels () {
+    static const KernelSet set = [] {
+        KernelSet s;
+#ifdef STEGO_LSB_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            s.block = 32;
+            s.embed[1] = embedAVX2<1>, s.embed[2] = embedAVX2<2>, s.embed[3] = embedAVX2<3>, s.embed[4] = embedAVX2<4>;
+            s.extract[1] = extractAVX2<1>, s.extract[2] = extractAVX2<2>, s.extract[3] = extractAVX2<3>, s.extract[4] = extractAVX2<4>;
+        } else if (__builtin_cpu_supports("ssse3")) {
+            s.block = 16;
+            s.embed[1] = embedSSSE3<1>, s.embed[2] = embedSSSE3<2>, s.embed[3] = embedSSSE3<3>, s.embed[4] = embedSSSE3<4>;
+            s.extract[1] = extractSSSE3<1>, s.extract[2] = extractSSSE3<2>, s.extract[3] = extractSSSE3<3>, s.extract[4] = extractSSSE3<4>;
+        }
+#endif
+        return s;
+    }();
+    return set;
+}
+
+}  // namespace
+
+std::size_t embedLSBKernel (std::uint8_t* px, std::size_t n, const std::uint8_t* payload, int k) {
+    if (k < 1 || k > 4 || !kernels().embed[k]) return 0;
+    return kernels().embed[k](px, n, payload);
+}
+
+std::size_t extractLSBKernel (const std::uint8_t* px, std::size_t n, std::uint8_t* out, int k) {
+    if (k < 1 || k > 4 || !kernels().extract[k]) return 0;
+    return kernels().extract[k](px, n, out);
+}
+
+std::size_t lsbKernelBlock (int k) { return (k >= 1 && k <= 4) ? kernels().block : 0; }
+
+}  // namespace detail
+}  // namespace stego
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace stego {
+namespace detail {
+
+// --- k-bit LSB 批次核心 ---
+// 只處理 k = 1..4，且負載位置必須對齊 byte；每次處理 16 (SSSE3) 或 32 (AVX2) 個樣本
+// 回傳實際處理的樣本數 (區塊大小的倍數)，剩下的樣本由呼叫端逐一處理
+
+// 將 payload 依序嵌入 px[0..n) 的最低 k 個位元，payload 至少要有 n * k / 8 個位元組
+std::size_t embedLSBKernel (std::uint8_t* px, std::size_t n, const std::uint8_t* payload, int k);
+
+// 取出 px[0..n) 的最低 k 個位元並打包到 out (MSB-first)，out 至少要有 n * k / 8 個位元組
+std::size_t extractLSBKernel (const std::uint8_t* px, std::size_t n, std::uint8_t* out, int k);
+
+// 目前 CPU 上 k 對應的區塊大小 (樣本數)，沒有可用核心時為 0
+std::size_t lsbKernelBlock (int k);
+
+}  // namespace detail
+}  // namespace stego
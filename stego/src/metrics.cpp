@@ -0,0 +1,29 @@
+#include "stego/metrics.hpp"
+
+#include <cmath>
+#include <limits>
+
+namespace stego {
+
+double calculatePSNR (ConstGrayView img1, ConstGrayView img2) {
+    if (img1.empty() || img2.empty()) return 0.0;
+    if (img1.rows != img2.rows || img1.cols != img2.cols || img1.channels != img2.channels) return 0.0;
+
+    // 計算均方誤差 (MSE)，以整數累加平方差避免浮點誤差
+    const int rowLen = img1.cols * img1.channels;
+    std::uint64_t sse = 0;
+    for (int r = 0; r < img1.rows; ++r) {
+        const std::uint8_t* a = img1.ptr(r);
+        const std::uint8_t* b = img2.ptr(r);
+        for (int c = 0; c < rowLen; ++c) {
+            int d = static_cast<int>(a[c]) - b[c];
+            sse += static_cast<std::uint64_t>(d * d);
+        }
+    }
+    if (sse == 0) return std::numeric_limits<double>::infinity();  // 影像完全相同
+
+    double mse = static_cast<double>(sse) / (static_cast<double>(img1.total()) * img1.channels);
+    return 10.0 * std::log10((255.0 * 255.0) / mse);
+}
+
+}  // namespace stego
@@ -0,0 +1,116 @@
+#include "stego/parallel.hpp"
+
+#include <algorithm>
+
+namespace stego {
+
+namespace {
+
+thread_local bool insideTask = false;  // 目前執行緒是否正在執行池中的工作
+
+}  // namespace
+
+ThreadPool::ThreadPool (int threads) {
+    if (threads <= 0) threads = static_cast<int>(std::thread::hardware_concurrency());
+    for (int i = 1; i < threads; ++i) workers_.emplace_back([this] { workerLoop(); });
+}
+
+ThreadPool::~ThreadPool () {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    for (auto& t : workers_) t.join();
+}
+
+ThreadPool& ThreadPool::global () {
+    static ThreadPool pool;
+    return pool;
+}
+
+void ThreadPool::runTasks (std::size_t generation) {
+    insideTask = true;
+    for (;;) {
+        std::size_t id;
+        const std::function<void(std::size_t)>* job;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (generation_ != generation || next_ >= count_) break;  // 只執行自己加入的那一批
+            id = next_++;
+            job = job_;
+        }
+        try {
+            (*job)(id);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!error_) error_ = std::current_exception();
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (--pending_ == 0) finished_.notify_all();
+    }
+    insideTask = false;
+}
+
+void ThreadPool::workerLoop () {
+    std::size_t seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [&] { return stop_ || generation_ != seen; });
+            if (stop_) return;
+            seen = generation_;
+            // 這一批的參與執行緒數已達上限時不加入
+            if (joined_ >= limit_) continue;
+            ++joined_;
+        }
+        runTasks(seen);
+    }
+}
+
+void ThreadPool::parallelFor (std::size_t count, const std::function<void(std::size_t)>& fn, int maxThreads) {
+    if (count == 0) return;
+    if (insideTask || workers_.empty() || count == 1 || maxThreads == 1) {
+        for (std::size_t i = 0; i < count; ++i) fn(i);
+        return;
+    }
+
+    std::lock_guard<std::mutex> submit(submitMutex_);
+    std::size_t generation;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        job_ = &fn;
+        count_ = count;
+        next_ = 0;
+        pending_ = count;
+        error_ = nullptr;
+        limit_ = maxThreads > 0 ? std::min(maxThreads, size()) : size();
+        joined_ = 1;  // 呼叫端
+        generation = ++generation_;
+    }
+    wake_.notify_all();
+    runTasks(generation);
+
+    std::exception_ptr error;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        finished_.wait(lock, [&] { return pending_ == 0; });
+        job_ = nullptr;
+        error = error_;
+    }
+    if (error) std::rethrow_exception(error);
+}
+
+int resolveThreads (int threads) {
+    return threads > 0 ? threads : ThreadPool::global().size();
+}
+
+void parallelFor (std::size_t count, const std::function<void(std::size_t)>& fn, int threads) {
+    if (threads == 1 || count <= 1) {
+        for (std::size_t i = 0; i < count; ++i) fn(i);
+        return;
+    }
+    ThreadPool::global().parallelFor(count, fn, threads);
+}
+
+}  // namespace stego
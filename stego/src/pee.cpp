@@ -0,0 +1,249 @@
+#include "stego/pee.hpp"
+
+#include <algorithm>
+#include <vector>
+
+#include "stego/parallel.hpp"
+#include "location_map.hpp"
+
+namespace stego {
+
+namespace {
+
+// 一次處理的像素集合: 列 [rowBegin, rowEnd)、行 [colBegin, colEnd)
+// parity >= 0 時只取 (r + c) % 2 == parity 的像素 (棋盤格的其中一色)
+struct Pass {
+    int rowBegin, rowEnd, colBegin, colEnd, parity;
+};
+
+std::vector<Pass> passesFor (PEEPredictor predictor, int rows, int cols) {
+    if (predictor == PEEPredictor::MED) return {{1, rows, 1, cols, -1}};
+    return {{1, rows - 1, 1, cols - 1, 0}, {1, rows - 1, 1, cols - 1, 1}};
+}
+
+template <typename F>
+void forEachPassPixel (const Pass& pass, int r, F&& f) {
+    const int step = pass.parity < 0 ? 1 : 2;
+    int c = pass.colBegin;
+    if (pass.parity >= 0 && ((r + c) & 1) != pass.parity) ++c;
+    for (; c < pass.colEnd; c += step) f(c);
+}
+
+int predictRhombus (ConstGrayView img, int r, int c) {
+    const std::uint8_t* up = img.ptr(r - 1);
+    const std::uint8_t* row = img.ptr(r);
+    const std::uint8_t* down = img.ptr(r + 1);
+    return (up[c] + down[c] + row[c - 1] + row[c + 1] + 2) >> 2;
+}
+
+int predictMED (ConstGrayView img, int r, int c) {
+    const int a = img.ptr(r)[c - 1];      // 左
+    const int b = img.ptr(r - 1)[c];      // 上
+    const int d = img.ptr(r - 1)[c - 1];  // 左上
+    if (d >= std::max(a, b)) return std::min(a, b);
+    if (d <= std::min(a, b)) return std::max(a, b);
+    return a + b - d;
+}
+
+enum class PixelKind { Expand, Shift, Skip };
+
+// 依原值與預測值決定像素的處理方式；任一種結果會超出 [0, 255] 時不使用該像素
+PixelKind classify (int x, int pred, int T) {
+    const int e = x - pred;
+    if (e >= -T && e < T) {
+        const int lo = pred + 2 * e;
+        return lo >= 0 && lo + 1 <= 255 ? PixelKind::Expand : PixelKind::Skip;
+    }
+    const int y = e >= T ? x + T : x - T;
+    return y >= 0 && y <= 255 ? PixelKind::Shift : PixelKind::Skip;
+}
+
+// 還原單一像素，擴張像素回傳取出的位元，平移像素回傳 -1
+int restorePixel (std::uint8_t& px, int pred, int T) {
+    const int e = px - pred;
+    if (e >= -2 * T && e < 2 * T) {
+        const int bit = e & 1;
+        px = static_cast<std::uint8_t>(pred + (e - bit) / 2);
+        return bit;
+    }
+    px = static_cast<std::uint8_t>(e >= 2 * T ? px - T : px + T);
+    return -1;
+}
+
+// --- 依列切段平行處理 (同一次處理中的像素彼此獨立) ---
+constexpr std::size_t MIN_BAND_PIXELS = 1 << 16;  // 太小的分段不值得切換執行緒
+
+int bandRows (int rows, int cols, int threads) {
+    const std::size_t pixels = static_cast<std::size_t>(rows) * cols;
+    const std::size_t bands = std::max<std::size_t>(1, std::min<std::size_t>(static_cast<std::size_t>(resolveThreads(threads)) * 4, pixels / MIN_BAND_PIXELS));
+    return std::max(1, static_cast<int>((rows + bands - 1) / bands));
+}
+
+// 嵌入一次處理：原值與預測都從 src 讀取，結果寫入 dst (Rhombus 時兩者是同一張影像，
+// 寫入的只有本色像素，讀取的鄰點都是另一色)；位元從 bits[pos] 開始
+// 回傳擴張像素數，未使用的像素位置加入 skipped
+template <typename Predict>
+std::size_t embedPass (const Pass& pass, ConstGrayView src, GrayView dst, Predict predict, const BitBuffer& bits, std::size_t pos, int T, std::vector<std::size_t>& skipped, int threads) {
+    const int rows = pass.rowEnd - pass.rowBegin;
+    if (rows <= 0 || pass.colEnd <= pass.colBegin) return 0;
+    const int band = bandRows(rows, src.cols, threads);
+    const std::size_t bands = static_cast<std::size_t>((rows + band - 1) / band);
+
+    // 先數出各段的擴張像素數，得到各段的位元起點，輸出因此與執行緒數無關
+    std::vector<std::size_t> start(bands + 1, 0);
+    parallelFor(bands, [&](std::size_t b) {
+        const int first = pass.rowBegin + static_cast<int>(b) * band;
+        const int end = std::min(first + band, pass.rowEnd);
+        std::size_t n = 0;
+        for (int r = first; r < end; ++r) {
+            const std::uint8_t* in = src.ptr(r);
+            forEachPassPixel(pass, r, [&](int c) { n += classify(in[c], predict(src, r, c), T) == PixelKind::Expand; });
+        }
+        start[b + 1] = n;
+    }, threads);
+    for (std::size_t b = 0; b < bands; ++b) start[b + 1] += start[b];
+
+    const std::size_t total = bits.size();
+    std::vector<std::vector<std::size_t>> skip(bands);
+    parallelFor(bands, [&](std::size_t b) {
+        const int first = pass.rowBegin + static_cast<int>(b) * band;
+        const int end = std::min(first + band, pass.rowEnd);
+        std::size_t p = pos + start[b];
+        for (int r = first; r < end; ++r) {
+            const std::uint8_t* in = src.ptr(r);
+            std::uint8_t* out = dst.ptr(r);
+            forEachPassPixel(pass, r, [&](int c) {
+                const int x = in[c];
+                const int pred = predict(src, r, c);
+                switch (classify(x, pred, T)) {
+                case PixelKind::Expand: {
+                    const int bit = p < total && bits[p];
+                    ++p;
+                    out[c] = static_cast<std::uint8_t>(pred + 2 * (x - pred) + bit);
+                    break;
+                }
+                case PixelKind::Shift:
+                    out[c] = static_cast<std::uint8_t>(x - pred >= T ? x + T : x - T);
+                    break;
+                case PixelKind::Skip:
+                    skip[b].push_back(static_cast<std::size_t>(r) * src.cols + c);
+                    break;
+                }
+            });
+        }
+    }, threads);
+
+    for (const auto& part : skip) skipped.insert(skipped.end(), part.begin(), part.end());
+    return start[bands];
+}
+
+// 提取並原地還原一次處理；skipped 為排序後的未使用像素位置
+template <typename Predict>
+BitBuffer extractPass (const Pass& pass, GrayView img, Predict predict, int T, const std::vector<std::size_t>& skipped, int threads) {
+    const int rows = pass.rowEnd - pass.rowBegin;
+    if (rows <= 0 || pass.colEnd <= pass.colBegin) return BitBuffer();
+    const int band = bandRows(rows, img.cols, threads);
+    std::vector<BitBuffer> parts(static_cast<std::size_t>((rows + band - 1) / band));
+
+    parallelFor(parts.size(), [&](std::size_t b) {
+        const int first = pass.rowBegin + static_cast<int>(b) * band;
+        const int end = std::min(first + band, pass.rowEnd);
+        auto next = std::lower_bound(skipped.begin(), skipped.end(), static_cast<std::size_t>(first) * img.cols);
+        BitWriter writer;
+        for (int r = first; r < end; ++r) {
+            std::uint8_t* row = img.ptr(r);
+            forEachPassPixel(pass, r, [&](int c) {
+                const std::size_t idx = static_cast<std::size_t>(r) * img.cols + c;
+                while (next != skipped.end() && *next < idx) ++next;
+                if (next != skipped.end() && *next == idx) return;  // 嵌入時沒有修改
+                const int bit = restorePixel(row[c], predict(img, r, c), T);
+                if (bit >= 0) writer.put(bit != 0);
+            });
+        }
+        parts[b] = writer.take();
+    }, threads);
+
+    std::size_t total = 0;
+    for (const BitBuffer& part : parts) total += part.size();
+    BitWriter out(total);
+    for (const BitBuffer& part : parts) out.writeBits(part);
+    return out.take();
+}
+
+}  // namespace
+
+bool embedPEE (ConstGrayView cover, const BitBuffer& bits, Image<std::uint8_t>& stego, PEEKey& key, PEEPredictor predictor, int maxThreshold, int threads) {
+    if (cover.empty() || cover.channels != 1) return false;
+
+    const std::vector<Pass> passes = passesFor(predictor, cover.rows, cover.cols);
+    for (int T = 1; T <= maxThreshold; ++T) {
+        stego = Image<std::uint8_t>::clone(cover);
+        std::vector<std::size_t> skipped;
+        std::size_t capacity = 0;
+        for (const Pass& pass : passes) {
+            // MED 以封面 (因果鄰點的原值) 預測；Rhombus 直接讀寫隱寫影像
+            if (predictor == PEEPredictor::MED) {
+                capacity += embedPass(pass, cover, stego.view(), predictMED, bits, capacity, T, skipped, threads);
+            } else {
+                capacity += embedPass(pass, stego.view(), stego.view(), predictRhombus, bits, capacity, T, skipped, threads);
+            }
+        }
+        if (capacity < bits.size()) continue;  // 加大門檻再試
+
+        std::sort(skipped.begin(), skipped.end());
+        key = PEEKey();
+        key.predictor = predictor;
+        key.threshold = T;
+        key.overflowCount = skipped.size();
+        std::size_t prev = 0;
+        for (std::size_t idx : skipped) detail::appendLocation(key.overflowMap, prev, idx);
+        return true;
+    }
+    return false;
+}
+
+BitBuffer extractAndRestorePEE (ConstGrayView stego, const PEEKey& key, Image<std::uint8_t>& restored, int threads) {
+    std::vector<std::size_t> skipped;
+    const bool validPredictor = key.predictor == PEEPredictor::Rhombus || key.predictor == PEEPredictor::MED;
+    if (stego.empty() || stego.channels != 1 || !validPredictor || key.threshold < 1 || key.threshold > 127 ||
+        !detail::decodeLocations(key.overflowMap, key.overflowCount, stego.total(), skipped)) {
+        restored = Image<std::uint8_t>();
+        return BitBuffer();
+    }
+
+    // 以嵌入的相反順序還原，每次處理看到的鄰點都和嵌入時相同
+    restored = Image<std::uint8_t>::clone(stego);
+    const std::vector<Pass> passes = passesFor(key.predictor, stego.rows, stego.cols);
+    std::vector<BitBuffer> parts(passes.size());
+    for (std::size_t i = passes.size(); i-- > 0;) {
+        if (key.predictor == PEEPredictor::MED) {
+            // 預測需要已還原的左、上鄰點，只能依列優先順序進行
+            parts[i] = extractPass(passes[i], restored.view(), predictMED, key.threshold, skipped, 1);
+        } else {
+            parts[i] = extractPass(passes[i], restored.view(), predictRhombus, key.threshold, skipped, threads);
+        }
+    }
+
+    std::size_t total = 0;
+    for (const BitBuffer& part : parts) total += part.size();
+    BitWriter bits(total);
+    for (const BitBuffer& part : parts) bits.writeBits(part);
+    return bits.take();
+}
+
+bool embedMessagePEE (ConstGrayView cover, const std::string& message, Image<std::uint8_t>& stego, PEEKey& key, PEEPredictor predictor, int maxThreshold, int threads) {
+    BitBuffer bits = frameMessage(message, FrameAlgorithm::PredictionErrorExpansion, static_cast<std::uint16_t>(predictor));
+    if (bits.empty()) return false;  // 訊息過長
+    return embedPEE(cover, bits, stego, key, predictor, maxThreshold, threads);
+}
+
+std::string extractMessagePEE (ConstGrayView stego, const PEEKey& key, Image<std::uint8_t>& restored, FrameStatus* status, int threads) {
+    // 還原本來就要走訪整張影像，因此先取出全部位元再交給 FrameReader
+    BitBuffer bits = extractAndRestorePEE(stego, key, restored, threads);
+    FrameReader reader(FrameAlgorithm::PredictionErrorExpansion, static_cast<std::uint16_t>(key.predictor), bits.size() > FRAME_HEADER_BITS ? bits.size() - FRAME_HEADER_BITS : 0);
+    const std::size_t whole = bits.size() / 8;
+    for (std::size_t i = 0; i < whole && reader.push(bits.data()[i]); ++i) {}
+    return reader.takeMessage(status);
+}
+
+}  // namespace stego
@@ -0,0 +1,557 @@
+#include "stego/shamir.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstring>
+
+#include "stego/parallel.hpp"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define STEGO_SHAMIR_X86 1
+#endif
+
+namespace stego {
+
+namespace {
+
+constexpr unsigned FIELD_POLY = 0x11d;
+
+// 對數 / 指數表：exp 存兩輪，log a + log b 不必取模
+struct LogExpTable {
+    std::array<std::uint8_t, 512> exp{};
+    std::array<std::uint8_t, 256> log{};
+};
+
+LogExpTable buildLogExp () {
+    LogExpTable t;
+    unsigned v = 1;
+    for (int i = 0; i < 255; ++i) {
+        t.exp[i] = t.exp[i + 255] = static_cast<std::uint8_t>(v);
+        t.log[v] = static_cast<std::uint8_t>(i);
+        v <<= 1;
+        if (v & 0x100) v ^= FIELD_POLY;
+    }
+    return t;
+}
+
+const LogExpTable& logExp () {
+    static const LogExpTable table = buildLogExp();
+    return table;
+}
+
+// 乘上常數 c 的查表：lo[i] = c * i、hi[i] = c * (i << 4)，c * v = lo[v & 15] ^ hi[v >> 4]
+struct MulTable {
+    alignas(16) std::uint8_t lo[16];
+    alignas(16) std::uint8_t hi[16];
+};
+
+MulTable mulTable (std::uint8_t c) {
+    MulTable t;
+    for (int i = 0; i < 16; ++i) {
+        t.lo[i] = gf256Mul(c, static_cast<std::uint8_t>(i));
+        t.hi[i] = gf256Mul(c, static_cast<std::uint8_t>(i << 4));
+    }
+    return t;
+}
+
+// out[i] = c * a[i] ^ b[i] (out 可以與 b 相同)
+using MulXorFn = void (*)(const std::uint8_t* a, const std::uint8_t* b, std::uint8_t* out, std::size_t n, const MulTable& t);
+
+void mulXorScalar (const std::uint8_t* a, const std::uint8_t* b, std::uint8_t* out, std::size_t n, const MulTable& t) {
+    for (std::size_t i = 0; i < n; ++i) out[i] = t.lo[a[i] & 15] ^ t.hi[a[i] >> 4] ^ b[i];
+}
+
+#ifdef STEGO_SHAMIR_X86
+__attribute__((target("avx2"))) void mulXorAVX2 (const std::uint8_t* a, const std::uint8_t* b, std::uint8_t* out, std::size_t n, const MulTable& t) {
+    const __m256i lo = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(t.lo)));
+    const __m256i hi = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(t.hi)));
+    const __m256i nibble = _mm256_set1_epi8(0x0F);
+    std::size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        const __m256i pl = _mm256_shuffle_epi8(lo, _mm256_and_si256(v, nibble));
+        const __m256i ph = _mm256_shuffle_epi8(hi, _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble));
+        const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_xor_si256(_mm256_xor_si256(pl, ph), x));
+    }
+    mulXorScalar(a + i, b + i, out + i, n - i, t);
+}
+#endif  // STEGO_SHAMIR_X86
+
+MulXorFn mulXorKernel () {
+    static const MulXorFn fn = [] {
+#ifdef STEGO_SHAMIR_X86
+        if (__builtin_cpu_supports("avx2")) return mulXorAVX2;
+#endif
+        return mulXorScalar;
+    }();
+    return fn;
+}
+
+std::uint64_t splitMix64 (std::uint64_t& state) {
+    std::uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// 以 BLOCK 位元組為單位處理，係數與累加值都留在 L1/L2；每個工作處理 BLOCKS_PER_TASK 個區塊
+constexpr std::size_t BLOCK = 4096;
+constexpr std::size_t BLOCKS_PER_TASK = 16;
+
+// --- GF(2^31 - 1) ---
+// 2^31 = 1 (mod p)，因此 v = (v & p) + (v >> 31) (mod p)；v < 2^63 時結果小於 2^32 + 2^31
+std::uint64_t fold31 (std::uint64_t v) { return (v & MERSENNE_31) + (v >> 31); }
+
+std::uint32_t reduce31 (std::uint64_t v) {
+    v = fold31(fold31(v));
+    return static_cast<std::uint32_t>(v >= MERSENNE_31 ? v - MERSENNE_31 : v);
+}
+
+std::uint32_t mulMod31 (std::uint32_t a, std::uint32_t b) { return reduce31(static_cast<std::uint64_t>(a) * b); }
+
+std::uint32_t powMod31 (std::uint32_t a, std::uint32_t e) {
+    std::uint32_t ans = 1;
+    for (; e; e >>= 1, a = mulMod31(a, a)) if (e & 1) ans = mulMod31(ans, a);
+    return ans;
+}
+
+// out[j] = sum_i w[i] * ys[i][j] (mod p)，j = begin..end-1；每加一個乘積 (< 2^62) 就折疊一次，累加值保持在 2^33 以內
+using DotFn = void (*)(const std::uint32_t* const* ys, const std::uint32_t* w, int m, std::size_t begin, std::size_t end, std::uint32_t* out);
+
+void dotScalar (const std::uint32_t* const* ys, const std::uint32_t* w, int m, std::size_t begin, std::size_t end, std::uint32_t* out) {
+    for (std::size_t j = begin; j < end; ++j) {
+        std::uint64_t acc = 0;
+        for (int i = 0; i < m; ++i) acc = fold31(acc + static_cast<std::uint64_t>(w[i]) * ys[i][j]);
+        out[j] = reduce31(acc);
+    }
+}
+
+#ifdef STEGO_SHAMIR_X86
+__attribute__((target("avx2"))) inline __m256i fold31AVX2 (__m256i v) {
+    const __m256i p = _mm256_set1_epi64x(MERSENNE_31);
+    return _mm256_add_epi64(_mm256_and_si256(v, p), _mm256_srli_epi64(v, 31));
+}
+
+// 4 個 64 位元累加值 -> 4 個化簡到 [0, p) 的 32 位元結果
+__attribute__((target("avx2"))) inline __m128i finish31AVX2 (__m256i v) {
+    const __m256i p = _mm256_set1_epi64x(MERSENNE_31);
+    v = fold31AVX2(fold31AVX2(v));
+    v = _mm256_sub_epi64(v, _mm256_and_si256(_mm256_cmpgt_epi64(v, _mm256_set1_epi64x(MERSENNE_31 - 1)), p));
+    return _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(v, _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7)));
+}
+
+// 每次 8 個秘密：兩組 4 個 64 位元累加值，_mm256_mul_epu32 做 32x32 -> 64 位元乘法
+__attribute__((target("avx2"))) void dotAVX2 (const std::uint32_t* const* ys, const std::uint32_t* w, int m, std::size_t begin, std::size_t end, std::uint32_t* out) {
+    std::size_t j = begin;
+    for (; j + 8 <= end; j += 8) {
+        __m256i lo = _mm256_setzero_si256(), hi = _mm256_setzero_si256();
+        for (int i = 0; i < m; ++i) {
+            const __m256i wi = _mm256_set1_epi64x(w[i]);
+            const __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ys[i] + j));
+            lo = fold31AVX2(_mm256_add_epi64(lo, _mm256_mul_epu32(_mm256_cvtepu32_epi64(_mm256_castsi256_si128(y)), wi)));
+            hi = fold31AVX2(_mm256_add_epi64(hi, _mm256_mul_epu32(_mm256_cvtepu32_epi64(_mm256_extracti128_si256(y, 1)), wi)));
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + j), finish31AVX2(lo));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + j + 4), finish31AVX2(hi));
+    }
+    dotScalar(ys, w, m, j, end, out);
+}
+#endif  // STEGO_SHAMIR_X86
+
+DotFn dotKernel () {
+    static const DotFn fn = [] {
+#ifdef STEGO_SHAMIR_X86
+        if (__builtin_cpu_supports("avx2")) return dotAVX2;
+#endif
+        return dotScalar;
+    }();
+    return fn;
+}
+
+// 每個工作還原的秘密數
+constexpr std::size_t SECRETS_PER_TASK = 1 << 14;
+
+// --- 影像秘密分享 ---
+constexpr std::uint32_t PRIME_251 = 251;
+constexpr std::uint32_t ESCAPE_251 = 250;  // 像素 >= 250 拆成 250 與 (像素 - 250)
+constexpr int ROWS_PER_BAND = 16;
+
+struct Field251 {
+    static std::uint32_t add (std::uint32_t a, std::uint32_t b) { return (a + b) % PRIME_251; }
+    static std::uint32_t sub (std::uint32_t a, std::uint32_t b) { return (a + PRIME_251 - b) % PRIME_251; }
+    static std::uint32_t mul (std::uint32_t a, std::uint32_t b) { return a * b % PRIME_251; }
+    static std::uint32_t inv (std::uint32_t a) {
+        std::uint32_t ans = 1, e = PRIME_251 - 2;
+        for (; e; e >>= 1, a = mul(a, a)) if (e & 1) ans = mul(ans, a);
+        return ans;
+    }
+};
+
+struct Field256 {
+    static std::uint32_t add (std::uint32_t a, std::uint32_t b) { return a ^ b; }
+    static std::uint32_t sub (std::uint32_t a, std::uint32_t b) { return a ^ b; }
+    static std::uint32_t mul (std::uint32_t a, std::uint32_t b) { return gf256Mul(static_cast<std::uint8_t>(a), static_cast<std::uint8_t>(b)); }
+    static std::uint32_t inv (std::uint32_t a) { return gf256Inv(static_cast<std::uint8_t>(a)); }
+};
+
+// 反 Vandermonde 矩陣 inv[t * k + i]，係數 a_t = sum_i inv[t][i] * q(x_i)；x 重複時回傳空 vector
+// 第 i 行是拉格朗日基底 L_i(x) = prod_{j != i} (x - x_j) / (x_i - x_j) 的係數：先展開 P(x) = prod_j (x - x_j)，
+// 以綜合除法得到 P(x) / (x - x_i)，k 個分母 prod_{j != i} (x_i - x_j) 以批次反元素只求一次反元素
+template <typename F>
+std::vector<std::uint32_t> vandermondeInverse (const std::vector<std::uint32_t>& xs) {
+    const int k = static_cast<int>(xs.size());
+    std::vector<std::uint32_t> full(k + 1, 0);  // full[t] 為 P(x) 的 x^t 係數
+    full[0] = 1;
+    for (int j = 0; j < k; ++j) {
+        for (int t = j + 1; t >= 0; --t) full[t] = F::sub(t > 0 ? full[t - 1] : 0, F::mul(full[t], xs[j]));
+    }
+
+    std::vector<std::uint32_t> quotient(static_cast<std::size_t>(k) * k), denom(k);
+    for (int i = 0; i < k; ++i) {
+        std::uint32_t* q = quotient.data() + static_cast<std::size_t>(i) * k;
+        q[k - 1] = full[k];
+        for (int t = k - 1; t > 0; --t) q[t - 1] = F::add(full[t], F::mul(xs[i], q[t]));
+        std::uint32_t d = 0;  // Q(x_i) = prod_{j != i} (x_i - x_j)
+        for (int t = k - 1; t >= 0; --t) d = F::add(F::mul(d, xs[i]), q[t]);
+        if (d == 0) return {};
+        denom[i] = d;
+    }
+
+    std::vector<std::uint32_t> prefix(k);
+    prefix[0] = denom[0];
+    for (int i = 1; i < k; ++i) prefix[i] = F::mul(prefix[i - 1], denom[i]);
+    std::uint32_t inverse = F::inv(prefix[k - 1]);
+    std::vector<std::uint32_t> out(static_cast<std::size_t>(k) * k);
+    for (int i = k - 1; i >= 0; --i) {
+        const std::uint32_t inverseD = i > 0 ? F::mul(inverse, prefix[i - 1]) : inverse;
+        inverse = F::mul(inverse, denom[i]);
+        for (int t = 0; t < k; ++t) out[static_cast<std::size_t>(t) * k + i] = F::mul(quotient[static_cast<std::size_t>(i) * k + t], inverseD);
+    }
+    return out;
+}
+
+// GF251 一列展開後的值 (像素 >= 250 佔兩個)
+std::size_t expandedLength (const std::uint8_t* in, int cols) {
+    std::size_t len = cols;
+    for (int c = 0; c < cols; ++c) len += in[c] >= ESCAPE_251;
+    return len;
+}
+
+// 依列切段平行：fn(first, last) 處理 [first, last) 列，暫存緩衝區每段配置一次
+template <typename Fn>
+void forEachRowBand (int rows, int threads, Fn&& fn) {
+    const std::size_t bands = (static_cast<std::size_t>(rows) + ROWS_PER_BAND - 1) / ROWS_PER_BAND;
+    parallelFor(bands, [&](std::size_t band) {
+        const int first = static_cast<int>(band) * ROWS_PER_BAND;
+        fn(first, std::min(rows, first + ROWS_PER_BAND));
+    }, threads);
+}
+
+}  // namespace
+
+std::uint8_t gf256Mul (std::uint8_t a, std::uint8_t b) {
+    if (a == 0 || b == 0) return 0;
+    const LogExpTable& t = logExp();
+    return t.exp[t.log[a] + t.log[b]];
+}
+
+std::uint8_t gf256Inv (std::uint8_t a) {
+    const LogExpTable& t = logExp();
+    return a == 0 ? 0 : t.exp[255 - t.log[a]];
+}
+
+std::vector<ShamirShare> shamirSplit (const void* secret, std::size_t size, int k, int n, std::uint64_t seed, int threads) {
+    if (k < 2 || n < k || n > 255 || (secret == nullptr && size > 0)) return {};
+    const auto* in = static_cast<const std::uint8_t*>(secret);
+
+    std::vector<ShamirShare> shares(n);
+    std::vector<MulTable> tables(n);
+    for (int i = 0; i < n; ++i) {
+        shares[i].x = static_cast<std::uint8_t>(i + 1);
+        shares[i].data.resize(size);
+        tables[i] = mulTable(shares[i].x);
+    }
+    const MulXorFn mulXor = mulXorKernel();
+
+    const std::size_t blocks = (size + BLOCK - 1) / BLOCK;
+    const std::size_t tasks = (blocks + BLOCKS_PER_TASK - 1) / BLOCKS_PER_TASK;
+    parallelFor(tasks, [&](std::size_t task) {
+        // coefficients[j - 1] 為區塊內各位元組的第 j 次係數
+        std::vector<std::uint8_t> coefficients(static_cast<std::size_t>(k - 1) * BLOCK);
+        const std::size_t last = std::min(blocks, (task + 1) * BLOCKS_PER_TASK);
+        for (std::size_t b = task * BLOCKS_PER_TASK; b < last; ++b) {
+            const std::size_t begin = b * BLOCK;
+            const std::size_t len = std::min(BLOCK, size - begin);
+            const std::size_t padded = (len + 7) & ~std::size_t{7};
+
+            std::uint64_t state = seed ^ (static_cast<std::uint64_t>(b) * 0xD1B54A32D192ED03ULL);
+            for (int j = 0; j < k - 1; ++j) {
+                std::uint8_t* c = coefficients.data() + j * BLOCK;
+                for (std::size_t i = 0; i < padded; i += 8) {
+                    const std::uint64_t r = splitMix64(state);
+                    std::memcpy(c + i, &r, 8);
+                }
+            }
+
+            // Horner：y = (((c_{k-1} x + c_{k-2}) x + ...) x + secret
+            for (int s = 0; s < n; ++s) {
+                std::uint8_t* y = shares[s].data.data() + begin;
+                const std::uint8_t* top = coefficients.data() + static_cast<std::size_t>(k - 2) * BLOCK;
+                if (k == 2) {
+                    mulXor(top, in + begin, y, len, tables[s]);
+                    continue;
+                }
+                mulXor(top, top - BLOCK, y, len, tables[s]);
+                for (int j = k - 4; j >= 0; --j) mulXor(y, coefficients.data() + j * BLOCK, y, len, tables[s]);
+                mulXor(y, in + begin, y, len, tables[s]);
+            }
+        }
+    }, threads);
+    return shares;
+}
+
+std::vector<std::uint8_t> gf256LagrangeAtZero (const std::vector<std::uint8_t>& xs) {
+    std::vector<std::uint8_t> weights(xs.size());
+    for (std::size_t i = 0; i < xs.size(); ++i) {
+        std::uint8_t num = 1, denom = 1;
+        for (std::size_t j = 0; j < xs.size(); ++j) {
+            if (j == i) continue;
+            // 特徵值 2 的體中 0 - x_j = x_j，x_j - x_i = x_j ^ x_i
+            if (xs[j] == xs[i]) return {};
+            num = gf256Mul(num, xs[j]);
+            denom = gf256Mul(denom, static_cast<std::uint8_t>(xs[j] ^ xs[i]));
+        }
+        if (xs[i] == 0) return {};
+        weights[i] = gf256Mul(num, gf256Inv(denom));
+    }
+    return weights;
+}
+
+std::vector<std::uint8_t> shamirCombine (const std::vector<ShamirShare>& shares, int threads) {
+    if (shares.empty()) return {};
+    const std::size_t size = shares[0].data.size();
+    std::vector<std::uint8_t> xs;
+    for (const ShamirShare& s : shares) {
+        if (s.data.size() != size) return {};
+        xs.push_back(s.x);
+    }
+    const std::vector<std::uint8_t> weights = gf256LagrangeAtZero(xs);
+    if (weights.empty()) return {};
+
+    std::vector<MulTable> tables;
+    for (std::uint8_t w : weights) tables.push_back(mulTable(w));
+    const MulXorFn mulXor = mulXorKernel();
+
+    std::vector<std::uint8_t> secret(size, 0);
+    const std::size_t blocks = (size + BLOCK - 1) / BLOCK;
+    const std::size_t tasks = (blocks + BLOCKS_PER_TASK - 1) / BLOCKS_PER_TASK;
+    parallelFor(tasks, [&](std::size_t task) {
+        const std::size_t last = std::min(blocks, (task + 1) * BLOCKS_PER_TASK);
+        for (std::size_t b = task * BLOCKS_PER_TASK; b < last; ++b) {
+            const std::size_t begin = b * BLOCK;
+            const std::size_t len = std::min(BLOCK, size - begin);
+            std::uint8_t* out = secret.data() + begin;
+            for (std::size_t i = 0; i < shares.size(); ++i) mulXor(shares[i].data.data() + begin, out, out, len, tables[i]);
+        }
+    }, threads);
+    return secret;
+}
+
+LagrangeReconstructor::LagrangeReconstructor (const std::vector<std::uint32_t>& xs) {
+    const int m = static_cast<int>(xs.size());
+    std::vector<std::uint32_t> sorted(xs);
+    std::sort(sorted.begin(), sorted.end());
+    if (m == 0 || sorted.front() == 0 || sorted.back() >= MERSENNE_31 || std::adjacent_find(sorted.begin(), sorted.end()) != sorted.end()) return;
+
+    // L_i(0) = prod_{j != i} (-x_j) / (x_i - x_j) = N / e_i，N = prod_j (-x_j)、e_i = (-x_i) * prod_{j != i} (x_i - x_j)
+    std::uint32_t numerator = 1;
+    std::vector<std::uint32_t> e(m);
+    for (int i = 0; i < m; ++i) {
+        numerator = mulMod31(numerator, MERSENNE_31 - xs[i]);
+        e[i] = MERSENNE_31 - xs[i];
+        for (int j = 0; j < m; ++j) {
+            if (j != i) e[i] = mulMod31(e[i], xs[i] > xs[j] ? xs[i] - xs[j] : xs[i] + (MERSENNE_31 - xs[j]));
+        }
+    }
+
+    // Montgomery 批次反元素：prefix[i] = e_0 ... e_i，只對 prefix[m - 1] 做一次費馬小定理求反元素，再由後往前拆開
+    std::vector<std::uint32_t> prefix(m);
+    prefix[0] = e[0];
+    for (int i = 1; i < m; ++i) prefix[i] = mulMod31(prefix[i - 1], e[i]);
+    std::uint32_t inverse = powMod31(prefix[m - 1], MERSENNE_31 - 2);  // (e_0 ... e_i)^-1
+
+    weights_.resize(m);
+    for (int i = m - 1; i >= 0; --i) {
+        const std::uint32_t inverseE = i > 0 ? mulMod31(inverse, prefix[i - 1]) : inverse;
+        inverse = mulMod31(inverse, e[i]);
+        weights_[i] = mulMod31(numerator, inverseE);
+    }
+}
+
+std::uint32_t LagrangeReconstructor::reconstruct (const std::uint32_t* ys) const {
+    std::uint64_t acc = 0;
+    for (std::size_t i = 0; i < weights_.size(); ++i) acc = fold31(acc + static_cast<std::uint64_t>(weights_[i]) * ys[i]);
+    return reduce31(acc);
+}
+
+void LagrangeReconstructor::reconstruct (const std::uint32_t* const* ys, std::size_t count, std::uint32_t* out, int threads) const {
+    if (!valid() || count == 0) return;
+    const DotFn dot = dotKernel();
+    const std::size_t tasks = (count + SECRETS_PER_TASK - 1) / SECRETS_PER_TASK;
+    parallelFor(tasks, [&](std::size_t task) {
+        const std::size_t begin = task * SECRETS_PER_TASK;
+        dot(ys, weights_.data(), size(), begin, std::min(count, begin + SECRETS_PER_TASK), out);
+    }, threads);
+}
+
+std::vector<ShadowImage> splitSecretImage (ConstGrayView secret, int k, int n, SharingField field, int threads) {
+    const bool prime = field == SharingField::GF251;
+    if (secret.empty() || secret.channels != 1 || k < 2 || n < k || n > (prime ? 250 : 255)) return {};
+    const int rows = secret.rows, cols = secret.cols;
+
+    // 影子寬度：GF256 為 ceil(cols / k)；GF251 先平行算出每列展開後的長度，取最長的一列
+    std::size_t width = (static_cast<std::size_t>(cols) + k - 1) / k;
+    if (prime) {
+        std::vector<std::size_t> lengths(rows);
+        forEachRowBand(rows, threads, [&](int first, int last) {
+            for (int r = first; r < last; ++r) lengths[r] = expandedLength(secret.ptr(r), cols);
+        });
+        width = (*std::max_element(lengths.begin(), lengths.end()) + k - 1) / k;
+    }
+
+    std::vector<ShadowImage> shadows(n);
+    for (int i = 0; i < n; ++i) {
+        shadows[i].x = static_cast<std::uint8_t>(i + 1);
+        shadows[i].image = Image<std::uint8_t>(rows, static_cast<int>(width));
+    }
+
+    if (prime) {
+        // powers[i * k + t] = x_i^t mod 251
+        std::vector<std::uint32_t> powers(static_cast<std::size_t>(n) * k);
+        for (int i = 0; i < n; ++i) {
+            std::uint32_t p = 1;
+            for (int t = 0; t < k; ++t, p = p * (i + 1) % PRIME_251) powers[static_cast<std::size_t>(i) * k + t] = p;
+        }
+        forEachRowBand(rows, threads, [&](int first, int last) {
+            // planes[t][g] 為第 g 組的第 t 個係數 (展開後的第 g * k + t 個值，不足補 0)
+            std::vector<std::uint32_t> planes(k * width), acc(width);
+            for (int r = first; r < last; ++r) {
+                std::fill(planes.begin(), planes.end(), 0);
+                const std::uint8_t* in = secret.ptr(r);
+                std::size_t pos = 0;
+                auto push = [&](std::uint32_t v) { planes[(pos % k) * width + pos / k] = v; ++pos; };
+                for (int c = 0; c < cols; ++c) {
+                    if (in[c] >= ESCAPE_251) {
+                        push(ESCAPE_251);
+                        push(in[c] - ESCAPE_251);
+                    } else {
+                        push(in[c]);
+                    }
+                }
+                for (int i = 0; i < n; ++i) {
+                    const std::uint32_t* pw = powers.data() + static_cast<std::size_t>(i) * k;
+                    std::fill(acc.begin(), acc.end(), 0);
+                    // 每項 < 251^2，k <= 250 項的和不會超過 32 位元，最後才取模
+                    for (int t = 0; t < k; ++t) {
+                        const std::uint32_t* a = planes.data() + t * width;
+                        for (std::size_t g = 0; g < width; ++g) acc[g] += a[g] * pw[t];
+                    }
+                    std::uint8_t* out = shadows[i].image.ptr(r);
+                    for (std::size_t g = 0; g < width; ++g) out[g] = static_cast<std::uint8_t>(acc[g] % PRIME_251);
+                }
+            }
+        });
+        return shadows;
+    }
+
+    std::vector<MulTable> tables(n);
+    for (int i = 0; i < n; ++i) tables[i] = mulTable(shadows[i].x);
+    const MulXorFn mulXor = mulXorKernel();
+    forEachRowBand(rows, threads, [&](int first, int last) {
+        std::vector<std::uint8_t> planes(k * width);
+        for (int r = first; r < last; ++r) {
+            std::fill(planes.begin(), planes.end(), 0);
+            const std::uint8_t* in = secret.ptr(r);
+            for (int c = 0; c < cols; ++c) planes[(c % k) * width + c / k] = in[c];
+            // Horner：y = ((a_{k-1} x + a_{k-2}) x + ...) x + a_0
+            for (int i = 0; i < n; ++i) {
+                std::uint8_t* y = shadows[i].image.ptr(r);
+                mulXor(planes.data() + (k - 1) * width, planes.data() + (k - 2) * width, y, width, tables[i]);
+                for (int t = k - 3; t >= 0; --t) mulXor(y, planes.data() + t * width, y, width, tables[i]);
+            }
+        }
+    });
+    return shadows;
+}
+
+bool combineSecretImage (const std::vector<ShadowImage>& shadows, int k, SharingField field, GrayView dst, int threads) {
+    const bool prime = field == SharingField::GF251;
+    if (dst.empty() || dst.channels != 1 || k < 2 || static_cast<int>(shadows.size()) < k) return false;
+    const int rows = dst.rows, cols = dst.cols;
+    const std::size_t width = shadows[0].image.cols();
+    const std::size_t minWidth = (static_cast<std::size_t>(cols) + k - 1) / k;
+    std::vector<std::uint32_t> xs(k);
+    for (int i = 0; i < k; ++i) {
+        const ShadowImage& s = shadows[i];
+        if (s.image.rows() != rows || static_cast<std::size_t>(s.image.cols()) != width || s.x == 0 || (prime && s.x >= PRIME_251)) return false;
+        xs[i] = s.x;
+    }
+    if (prime ? width < minWidth : width != minWidth) return false;
+
+    const std::vector<std::uint32_t> inverse = prime ? vandermondeInverse<Field251>(xs) : vandermondeInverse<Field256>(xs);
+    if (inverse.empty()) return false;
+
+    if (prime) {
+        std::atomic<bool> ok{true};
+        forEachRowBand(rows, threads, [&](int first, int last) {
+            std::vector<std::uint32_t> acc(width), values(k * width);
+            for (int r = first; r < last; ++r) {
+                // a_t[g] = sum_i inv[t][i] * y_i[g]，寫回展開後的順序 g * k + t
+                for (int t = 0; t < k; ++t) {
+                    std::fill(acc.begin(), acc.end(), 0);
+                    for (int i = 0; i < k; ++i) {
+                        const std::uint32_t w = inverse[static_cast<std::size_t>(t) * k + i];
+                        const std::uint8_t* y = shadows[i].image.ptr(r);
+                        for (std::size_t g = 0; g < width; ++g) acc[g] += y[g] * w;
+                    }
+                    for (std::size_t g = 0; g < width; ++g) values[g * k + t] = acc[g] % PRIME_251;
+                }
+                // 還原跳脫：250 後面接著 (像素 - 250)
+                std::uint8_t* out = dst.ptr(r);
+                std::size_t pos = 0;
+                for (int c = 0; c < cols; ++c) {
+                    if (pos >= values.size()) {
+                        ok = false;
+                        break;
+                    }
+                    std::uint32_t v = values[pos++];
+                    if (v == ESCAPE_251) v += pos < values.size() ? values[pos++] : 0;
+                    out[c] = static_cast<std::uint8_t>(std::min<std::uint32_t>(v, 255));
+                }
+            }
+        });
+        return ok;
+    }
+
+    std::vector<MulTable> tables(inverse.size());
+    for (std::size_t e = 0; e < inverse.size(); ++e) tables[e] = mulTable(static_cast<std::uint8_t>(inverse[e]));
+    const MulXorFn mulXor = mulXorKernel();
+    forEachRowBand(rows, threads, [&](int first, int last) {
+        std::vector<std::uint8_t> planes(k * width);
+        for (int r = first; r < last; ++r) {
+            std::fill(planes.begin(), planes.end(), 0);
+            for (int t = 0; t < k; ++t) {
+                std::uint8_t* a = planes.data() + t * width;
+                for (int i = 0; i < k; ++i) mulXor(shadows[i].image.ptr(r), a, a, width, tables[static_cast<std::size_t>(t) * k + i]);
+            }
+            std::uint8_t* out = dst.ptr(r);
+            for (int c = 0; c < cols; ++c) out[c] = planes[(c % k) * width + c / k];
+        }
+    });
+    return true;
+}
+
+}  // namespace stego
@@ -0,0 +1,489 @@
+#include "stego/vc.hpp"
+
+#include <algorithm>
+#include <array>
+#include <mutex>
+
+#include "stego/parallel.hpp"
+
+namespace stego {
+
+namespace {
+
+// 2x2 圖樣以 4 位元表示：bit0 左上、bit1 右上、bit2 左下、bit3 右下 (1 = 黑)
+// 依互補成對排列：PATTERNS[2p] 與 PATTERNS[2p + 1] 互補
+constexpr std::uint8_t PATTERNS[6] = {
+    0b0011, 0b1100,  // 上黑下白 / 上白下黑
+    0b0101, 0b1010,  // 左黑右白 / 左白右黑
+    0b1001, 0b0110,  // 對角
+};
+
+// 查表：entry[black][u] 為隨機位元組 u 對應的各分享圖圖樣；第 s 張的上列 2 個子像素位於第 16s 位元起，
+// 下列 2 個子像素位於第 16s + 8 位元起。連續 4 個像素的項目依序左移 0、2、4、6 位元後 OR 起來，
+// 每個位元組就是某張分享圖某一列的 8 個子像素，可整個位元組搬進輸出字組
+// u >= 252 時為 0 (重抽)，252 是 6 與 18 的公倍數，因此各圖樣的機率完全相同
+struct PatternTable {
+    int shares = 0;
+    std::array<std::array<std::uint64_t, 256>, 2> entry{};
+};
+
+constexpr int ACCEPT_LIMIT = 252;
+
+std::uint64_t spread (std::uint64_t pattern, int share) {
+    return ((pattern & 3) << (16 * share)) | ((pattern >> 2) << (16 * share + 8));
+}
+
+PatternTable buildTable (VCScheme scheme) {
+    PatternTable t;
+    t.shares = scheme == VCScheme::TwoOfFour ? 4 : 2;
+    for (int u = 0; u < ACCEPT_LIMIT; ++u) {
+        // 白點：所有分享圖相同
+        const std::uint64_t a = PATTERNS[u % 6], na = PATTERNS[(u % 6) ^ 1];
+        for (int s = 0; s < t.shares; ++s) t.entry[0][u] |= spread(a, s);
+
+        // 黑點：A 與互補的 A' 分給各分享圖
+        if (scheme == VCScheme::TwoOfTwo) {
+            t.entry[1][u] = spread(a, 0) | spread(na, 1);
+        } else {
+            static constexpr bool COMPLEMENT[3][4] = {{false, false, true, true}, {false, true, false, true}, {false, true, true, false}};
+            const bool* assign = COMPLEMENT[(u / 6) % 3];
+            for (int s = 0; s < 4; ++s) t.entry[1][u] |= spread(assign[s] ? na : a, s);
+        }
+    }
+    return t;
+}
+
+const PatternTable& patternTable (VCScheme scheme) {
+    if (scheme == VCScheme::TwoOfFour) {
+        static const PatternTable table = buildTable(VCScheme::TwoOfFour);
+        return table;
+    }
+    static const PatternTable table = buildTable(VCScheme::TwoOfTwo);
+    return table;
+}
+
+std::uint64_t splitMix64 (std::uint64_t& state) {
+    std::uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// 逐位元組取用的亂數流，每列以 (seed, 列號) 決定起點
+class ByteStream {
+public:
+    ByteStream (std::uint64_t seed, int row) : state_(seed ^ (static_cast<std::uint64_t>(row) * 0xD1B54A32D192ED03ULL)) {}
+
+    int next () {
+        if (left_ == 0) {
+            word_ = splitMix64(state_);
+            left_ = 8;
+        }
+        const int b = static_cast<int>(word_ & 0xFF);
+        word_ >>= 8;
+        --left_;
+        return b;
+    }
+
+    // 16 位元亂數：兩個位元組分開取出，確定先取的是低位元組 (同一運算式中兩次 next() 的求值順序未指定)
+    std::uint32_t next16 () {
+        const auto lo = next();
+        const auto hi = next();
+        return static_cast<std::uint32_t>(lo | hi << 8);
+    }
+
+    // [0, range) 的均勻亂數 (range <= 65536)：16 位元亂數乘上 range 取高位，落在偏差區間時重抽 (Lemire)
+    std::uint32_t below (std::uint32_t range) {
+        std::uint32_t m = next16() * range;
+        if ((m & 0xFFFF) < range) {
+            const std::uint32_t threshold = (0x10000u - range) % range;  // 只有低位小於 range 時才需要計算
+            while ((m & 0xFFFF) < threshold) m = next16() * range;
+        }
+        return m >> 16;
+    }
+
+private:
+    std::uint64_t state_;
+    std::uint64_t word_ = 0;
+    int left_ = 0;
+};
+
+constexpr int PIXELS_PER_WORD = 32;  // 每個秘密像素在每張分享圖的一列佔 2 個子像素
+
+// 產生第 r 列秘密像素對應的分享圖第 2r、2r + 1 列；分享圖張數為編譯期常數，內層迴圈完全展開
+template <int SHARES>
+void generateRow (const std::uint8_t* in, int cols, const PatternTable& table, ByteStream& random, std::vector<ShareBitmap>& shares, int r) {
+    for (std::size_t w = 0; w < shares[0].wordsPerRow(); ++w) {
+        std::uint64_t top[SHARES] = {}, bottom[SHARES] = {};
+        const int first = static_cast<int>(w) * PIXELS_PER_WORD;
+        const int count = std::min(PIXELS_PER_WORD, cols - first);
+        for (int g = 0; g * 4 < count; ++g) {
+            // 4 個像素 -> 每張分享圖上、下列各 8 個子像素
+            std::uint64_t group = 0;
+            for (int k = 0; k < 4 && g * 4 + k < count; ++k) {
+                const auto& lookup = table.entry[in[first + g * 4 + k] < 128];
+                std::uint64_t e;
+                while ((e = lookup[random.next()]) == 0) {}
+                group |= e << (2 * k);
+            }
+            for (int s = 0; s < SHARES; ++s) {
+                top[s] |= ((group >> (16 * s)) & 0xFF) << (8 * g);
+                bottom[s] |= ((group >> (16 * s + 8)) & 0xFF) << (8 * g);
+            }
+        }
+        for (int s = 0; s < SHARES; ++s) {
+            shares[s].row(2 * r)[w] = top[s];
+            shares[s].row(2 * r + 1)[w] = bottom[s];
+        }
+    }
+}
+
+
+// --- (k,n) 基底矩陣 ---
+constexpr int MAX_SHARES = 16;
+constexpr int MAX_SUBPIXELS = 64;
+constexpr int MAX_CACHED_PERMUTATION = 6;  // m <= 6 時快取全部 m! 種排列 (最多 720 種)
+
+std::int64_t binomial (int n, int r) {
+    if (r < 0 || r > n) return 0;
+    std::int64_t v = 1;
+    for (int i = 1; i <= r; ++i) v = v * (n - r + i) / i;
+    return v;
+}
+
+std::int64_t gcd64 (std::int64_t a, std::int64_t b) {
+    a = a < 0 ? -a : a;
+    b = b < 0 ? -b : b;
+    while (b) {
+        const std::int64_t t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+// 整數矩陣 (rows x cols，cols = rows + 1) 的一維零空間，化簡成互質整數；零空間不是一維時回傳空 vector
+std::vector<std::int64_t> nullVector (std::vector<std::vector<std::int64_t>> a) {
+    const int rows = static_cast<int>(a.size()), cols = static_cast<int>(a[0].size());
+    std::vector<int> pivotCol;
+    int r = 0;
+    for (int c = 0; c < cols && r < rows; ++c) {
+        int p = r;
+        while (p < rows && a[p][c] == 0) ++p;
+        if (p == rows) continue;
+        std::swap(a[r], a[p]);
+        // 消去其他列的第 c 行 (整數列運算，每次以 gcd 約分避免溢位)
+        for (int i = 0; i < rows; ++i) {
+            if (i == r || a[i][c] == 0) continue;
+            const std::int64_t g = gcd64(a[r][c], a[i][c]);
+            const std::int64_t mi = a[r][c] / g, mr = a[i][c] / g;
+            std::int64_t rowGcd = 0;
+            for (int j = 0; j < cols; ++j) {
+                a[i][j] = a[i][j] * mi - a[r][j] * mr;
+                rowGcd = gcd64(rowGcd, a[i][j]);
+            }
+            if (rowGcd > 1) for (std::int64_t& v : a[i]) v /= rowGcd;
+        }
+        pivotCol.push_back(c);
+        ++r;
+    }
+    if (static_cast<int>(pivotCol.size()) != cols - 1) return {};
+
+    int freeCol = 0;
+    while (std::find(pivotCol.begin(), pivotCol.end(), freeCol) != pivotCol.end()) ++freeCol;
+    // 每列只剩主元與自由行：a[i][p] * v[p] + a[i][free] * v[free] = 0，v[free] 取各主元的最小公倍數
+    std::int64_t scale = 1;
+    for (int i = 0; i < rows && i < static_cast<int>(pivotCol.size()); ++i) {
+        const std::int64_t p = a[i][pivotCol[i]];
+        scale = scale / gcd64(scale, p) * (p < 0 ? -p : p);
+    }
+    std::vector<std::int64_t> v(cols, 0);
+    v[freeCol] = scale;
+    for (int i = 0; i < static_cast<int>(pivotCol.size()); ++i) v[pivotCol[i]] = -a[i][freeCol] * (scale / a[i][pivotCol[i]]);
+    std::int64_t g = 0;
+    for (std::int64_t x : v) g = gcd64(g, x);
+    for (std::int64_t& x : v) x /= g;
+    return v;
+}
+
+// 依 f(w) 建立基底矩陣；不符合條件 (安全性、任 q >= k 列都要有正的對比、子像素數上限) 時回傳 false
+bool buildBasis (int k, int n, const std::vector<std::int64_t>& f, VCBasis& basis) {
+    // 安全性：任 k - 1 列的行向量分布相同 (sum_w f(w) C(n - k + 1, w - j) = 0)，同時防範求解時的溢位
+    for (int j = 0; j < k; ++j) {
+        std::int64_t sum = 0;
+        for (int w = j; w <= n; ++w) sum += f[w] * binomial(n - k + 1, w - j);
+        if (sum != 0) return false;
+    }
+    // q 列疊合後，S0 與 S1 全白的行數差 = sum_w f(w) C(n - q, w)
+    for (int q = k; q <= n; ++q) {
+        std::int64_t contrast = 0;
+        for (int w = 0; w <= n; ++w) contrast += f[w] * binomial(n - q, w);
+        if (contrast <= 0) return false;
+    }
+    std::int64_t m = 0;
+    for (int w = 0; w <= n; ++w) if (f[w] > 0) m += f[w] * binomial(n, w);
+    if (m > MAX_SUBPIXELS) return false;
+
+    basis = VCBasis();
+    basis.k = k;
+    basis.n = n;
+    basis.blockCols = 1;
+    while (basis.blockCols * basis.blockCols < m) ++basis.blockCols;
+    basis.blockRows = static_cast<int>((m + basis.blockCols - 1) / basis.blockCols);
+    for (std::uint32_t col = 0; col < (1u << n); ++col) {
+        const std::int64_t mult = f[__builtin_popcount(col)];
+        for (std::int64_t i = 0; i < (mult < 0 ? -mult : mult); ++i) (mult > 0 ? basis.white : basis.black).push_back(col);
+    }
+    const std::uint32_t allBlack = (1u << n) - 1;
+    basis.white.resize(basis.subpixels(), allBlack);
+    basis.black.resize(basis.subpixels(), allBlack);
+
+    const std::uint32_t firstK = (1u << k) - 1;
+    for (std::uint32_t col : basis.white) basis.whiteBlack += (col & firstK) != 0;
+    for (std::uint32_t col : basis.black) basis.blackBlack += (col & firstK) != 0;
+    return true;
+}
+
+// 列舉 k + 1 個權重的組合，選相對對比最高 (相同時子像素較少) 的方案
+bool searchBasis (int k, int n, VCBasis& best) {
+    const int m = n - k + 1;  // 只需檢查 q = k - 1 列的條件 (較少列的條件可由此推得)
+    bool found = false;
+    std::vector<int> support(k + 1);
+    for (int i = 0; i <= k; ++i) support[i] = i;
+    for (;;) {
+        // 條件：對 j = 0..k-1，sum_w f(w) C(n - k + 1, w - j) = 0
+        std::vector<std::vector<std::int64_t>> a(k, std::vector<std::int64_t>(k + 1));
+        for (int j = 0; j < k; ++j) for (int i = 0; i <= k; ++i) a[j][i] = binomial(m, support[i] - j);
+        const std::vector<std::int64_t> v = nullVector(a);
+        for (int sign = 1; !v.empty() && sign >= -1; sign -= 2) {
+            std::vector<std::int64_t> f(n + 1, 0);
+            for (int i = 0; i <= k; ++i) f[support[i]] = sign * v[i];
+            VCBasis candidate;
+            if (!buildBasis(k, n, f, candidate)) continue;
+            // 比較 (blackBlack - whiteBlack) / m，交叉相乘避免浮點誤差
+            const auto gain = [](const VCBasis& b) { return static_cast<std::int64_t>(b.blackBlack - b.whiteBlack); };
+            const std::int64_t lhs = gain(candidate) * best.subpixels(), rhs = gain(best) * candidate.subpixels();
+            if (!found || lhs > rhs || (lhs == rhs && candidate.subpixels() < best.subpixels())) {
+                best = std::move(candidate);
+                found = true;
+            }
+        }
+        // 下一個組合
+        int i = k;
+        while (i >= 0 && support[i] == n - k + i) --i;
+        if (i < 0) break;
+        ++support[i];
+        for (int j = i + 1; j <= k; ++j) support[j] = support[j - 1] + 1;
+    }
+    return found;
+}
+
+// 基底矩陣的一次排列對應的各分享圖區塊 (第 i 個元素為第 i 張分享圖，區塊內列優先的 m 個位元)
+void blockMasks (const std::uint32_t* columns, int m, int n, std::uint64_t* masks) {
+    for (int i = 0; i < n; ++i) masks[i] = 0;
+    for (int j = 0; j < m; ++j) for (int i = 0; i < n; ++i) masks[i] |= static_cast<std::uint64_t>((columns[j] >> i) & 1) << j;
+}
+
+// 快取的全部排列：masks[color][p * n + i]
+struct PermutationCache {
+    std::uint32_t count = 0;
+    std::vector<std::uint64_t> masks[2];
+};
+
+PermutationCache buildPermutations (const VCBasis& basis) {
+    PermutationCache cache;
+    const int m = basis.subpixels();
+    if (m > MAX_CACHED_PERMUTATION) return cache;
+    std::vector<int> perm(m);
+    for (int i = 0; i < m; ++i) perm[i] = i;
+    std::uint32_t columns[MAX_SUBPIXELS];
+    std::uint64_t masks[MAX_SHARES];
+    do {
+        for (int color = 0; color < 2; ++color) {
+            const std::vector<std::uint32_t>& base = color ? basis.black : basis.white;
+            for (int j = 0; j < m; ++j) columns[j] = base[perm[j]];
+            blockMasks(columns, m, basis.n, masks);
+            cache.masks[color].insert(cache.masks[color].end(), masks, masks + basis.n);
+        }
+        ++cache.count;
+    } while (std::next_permutation(perm.begin(), perm.end()));
+    return cache;
+}
+
+// 每組 (k,n) 的基底矩陣與其排列快取只建立一次；以指標保存，之後的呼叫不會使既有結果失效
+struct BasisEntry {
+    bool ready = false, valid = false;
+    VCBasis basis;
+    PermutationCache permutations;
+};
+
+const BasisEntry* basisEntry (int k, int n) {
+    static std::mutex mutex;
+    static BasisEntry cache[MAX_SHARES + 1][MAX_SHARES + 1];
+    std::lock_guard<std::mutex> lock(mutex);
+    BasisEntry& e = cache[k][n];
+    if (!e.ready) {
+        e.valid = searchBasis(k, n, e.basis);
+        if (e.valid) e.permutations = buildPermutations(e.basis);
+        e.ready = true;
+    }
+    return e.valid ? &e : nullptr;
+}
+
+}  // namespace
+
+std::vector<ShareBitmap> generateShares (ConstGrayView secret, VCScheme scheme, std::uint64_t seed, int threads) {
+    if (secret.empty() || secret.channels != 1 || (scheme != VCScheme::TwoOfTwo && scheme != VCScheme::TwoOfFour)) return {};
+
+    const PatternTable& table = patternTable(scheme);
+    std::vector<ShareBitmap> shares(table.shares, ShareBitmap(2 * secret.rows, 2 * secret.cols));
+
+    parallelFor(static_cast<std::size_t>(secret.rows), [&](std::size_t rr) {
+        const int r = static_cast<int>(rr);
+        ByteStream random(seed, r);
+        if (table.shares == 4) {
+            generateRow<4>(secret.ptr(r), secret.cols, table, random, shares, r);
+        } else {
+            generateRow<2>(secret.ptr(r), secret.cols, table, random, shares, r);
+        }
+    }, threads);
+    return shares;
+}
+
+ShareBitmap stackShares (const ShareBitmap& a, const ShareBitmap& b) {
+    if (a.empty() || a.rows() != b.rows() || a.cols() != b.cols()) return ShareBitmap();
+    ShareBitmap out(a.rows(), a.cols());
+    const std::size_t words = a.rows() * a.wordsPerRow();
+    const std::uint64_t* pa = a.row(0);
+    const std::uint64_t* pb = b.row(0);
+    std::uint64_t* po = out.row(0);
+    for (std::size_t i = 0; i < words; ++i) po[i] = pa[i] | pb[i];
+    return out;
+}
+
+bool unpackShare (const ShareBitmap& share, GrayView out) {
+    if (share.empty() || out.channels != 1 || out.rows != share.rows() || out.cols != share.cols()) return false;
+    for (int r = 0; r < share.rows(); ++r) {
+        const std::uint64_t* words = share.row(r);
+        std::uint8_t* px = out.ptr(r);
+        for (int c = 0; c < share.cols(); ++c) px[c] = (words[c >> 6] >> (c & 63)) & 1 ? 0 : 255;
+    }
+    return true;
+}
+
+const VCBasis* vcBasis (int k, int n) {
+    if (k < 2 || k > n || n > MAX_SHARES) return nullptr;
+    const BasisEntry* e = basisEntry(k, n);
+    return e ? &e->basis : nullptr;
+}
+
+std::vector<ShareBitmap> generateShares (ConstGrayView secret, const VCBasis& basis, std::uint64_t seed, int threads) {
+    const int m = basis.subpixels();
+    if (secret.empty() || secret.channels != 1 || basis.n < 2 || basis.n > MAX_SHARES || m <= 0 || m > MAX_SUBPIXELS ||
+        static_cast<int>(basis.white.size()) != m || static_cast<int>(basis.black.size()) != m) return {};
+
+    const int n = basis.n, bh = basis.blockRows, bw = basis.blockCols;
+    // vcBasis() 回傳的基底直接用快取中的排列；呼叫端自行組成的基底才在這裡建立
+    const PermutationCache* cached = nullptr;
+    if (basis.k >= 2 && basis.k <= n) {
+        const BasisEntry* e = basisEntry(basis.k, n);
+        if (e && &e->basis == &basis) cached = &e->permutations;
+    }
+    PermutationCache built;
+    if (!cached) {
+        built = buildPermutations(basis);
+        cached = &built;
+    }
+    const PermutationCache& cache = *cached;
+    std::vector<ShareBitmap> shares(n, ShareBitmap(bh * secret.rows, bw * secret.cols));
+    const std::uint64_t rowMask = (1ULL << bw) - 1;
+
+    parallelFor(static_cast<std::size_t>(secret.rows), [&](std::size_t rr) {
+        const int r = static_cast<int>(rr);
+        const std::uint8_t* in = secret.ptr(r);
+        ByteStream random(seed, r);
+        // 第 i 張分享圖區塊第 t 列的子像素寫入輸出列 i * bh + t；每個像素各列都寫入 bw 個位元，
+        // 因此所有輸出列共用同一個位元位置，累加滿 64 位元時一起寫出 (可跨越字組邊界)
+        std::uint64_t* outRows[MAX_SHARES * MAX_SUBPIXELS];
+        std::uint64_t acc[MAX_SHARES * MAX_SUBPIXELS] = {};
+        for (int i = 0; i < n; ++i) for (int t = 0; t < bh; ++t) outRows[i * bh + t] = shares[i].row(bh * r + t);
+        int filled = 0;
+        std::size_t word = 0;
+
+        std::uint32_t columns[MAX_SUBPIXELS];
+        std::uint64_t shuffled[MAX_SHARES];
+        for (int c = 0; c < secret.cols; ++c) {
+            const int color = in[c] < 128;
+            const std::uint64_t* masks;
+            if (cache.count) {
+                masks = cache.masks[color].data() + static_cast<std::size_t>(random.below(cache.count)) * n;
+            } else {
+                // Fisher-Yates 洗牌基底矩陣的行
+                const std::vector<std::uint32_t>& base = color ? basis.black : basis.white;
+                std::copy(base.begin(), base.end(), columns);
+                for (int j = m - 1; j > 0; --j) std::swap(columns[j], columns[random.below(static_cast<std::uint32_t>(j + 1))]);
+                blockMasks(columns, m, n, shuffled);
+                masks = shuffled;
+            }
+            const int overflow = filled + bw - 64;  // >= 0 時這個像素會填滿目前的字組
+            for (int i = 0; i < n; ++i) for (int t = 0; t < bh; ++t) {
+                const int s = i * bh + t;
+                const std::uint64_t bits = (masks[i] >> (t * bw)) & rowMask;
+                acc[s] |= bits << filled;
+                if (overflow >= 0) {
+                    outRows[s][word] = acc[s];
+                    acc[s] = overflow ? bits >> (bw - overflow) : 0;
+                }
+            }
+            if (overflow >= 0) {
+                ++word;
+                filled = overflow;
+            } else {
+                filled += bw;
+            }
+        }
+        if (filled) for (int s = 0; s < n * bh; ++s) outRows[s][word] = acc[s];
+    }, threads);
+    return shares;
+}
+
+ShareBitmap stackShares (const std::vector<ShareBitmap>& shares, const std::vector<int>& members) {
+    if (members.empty()) return ShareBitmap();
+    for (int i : members) {
+        if (i < 0 || i >= static_cast<int>(shares.size())) return ShareBitmap();
+    }
+    ShareBitmap out = shares[members[0]];
+    for (std::size_t j = 1; j < members.size(); ++j) {
+        const ShareBitmap& s = shares[members[j]];
+        if (s.rows() != out.rows() || s.cols() != out.cols()) return ShareBitmap();
+        const std::size_t words = out.rows() * out.wordsPerRow();
+        std::uint64_t* po = out.row(0);
+        const std::uint64_t* ps = s.row(0);
+        for (std::size_t w = 0; w < words; ++w) po[w] |= ps[w];
+    }
+    return out;
+}
+
+bool verifyShares (const std::vector<ShareBitmap>& shares, ConstGrayView secret, const VCBasis& basis) {
+    const int n = basis.n, k = basis.k, bh = basis.blockRows, bw = basis.blockCols;
+    if (static_cast<int>(shares.size()) != n || secret.empty() || k < 1 || k > n) return false;
+
+    std::vector<int> members(k);
+    for (int i = 0; i < k; ++i) members[i] = i;
+    for (;;) {
+        const ShareBitmap stacked = stackShares(shares, members);
+        if (stacked.rows() != bh * secret.rows || stacked.cols() != bw * secret.cols) return false;
+        for (int r = 0; r < secret.rows; ++r) for (int c = 0; c < secret.cols; ++c) {
+            int count = 0;
+            for (int t = 0; t < bh; ++t) for (int u = 0; u < bw; ++u) count += stacked.black(bh * r + t, bw * c + u);
+            if (count != (secret.ptr(r)[c] < 128 ? basis.blackBlack : basis.whiteBlack)) return false;
+        }
+        int i = k - 1;
+        while (i >= 0 && members[i] == n - k + i) --i;
+        if (i < 0) return true;
+        ++members[i];
+        for (int j = i + 1; j < k; ++j) members[j] = members[j - 1] + 1;
+    }
+}
+
+}  // namespace stego
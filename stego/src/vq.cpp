@@ -0,0 +1,148 @@
+#include "stego/vq.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace stego {
+
+std::vector<VQVector> extractBlockVectors (ConstGrayView image, int blockSize) {
+    std::vector<VQVector> vectors;
+    const int rows = (image.rows / blockSize) * blockSize;
+    const int cols = (image.cols / blockSize) * blockSize;
+    for (int r = 0; r < rows; r += blockSize) {
+        for (int c = 0; c < cols; c += blockSize) {
+            VQVector v;
+            v.reserve(blockSize * blockSize);
+            for (int br = 0; br < blockSize; ++br) {
+                const std::uint8_t* row = image.ptr(r + br) + c;
+                for (int bc = 0; bc < blockSize; ++bc) v.push_back(row[bc]);
+            }
+            vectors.push_back(std::move(v));
+        }
+    }
+    return vectors;
+}
+
+double squaredDistance (const VQVector& a, const VQVector& b) {
+    double res = 0.0;
+    const std::size_t n = a.size();
+    for (std::size_t i = 0; i < n; ++i) res += (a[i] - b[i]) * (a[i] - b[i]);
+    return res;
+}
+
+VQVector calculateCentroid (const std::vector<VQVector>& vectors) {
+    if (vectors.empty()) return VQVector();
+    VQVector sum(vectors[0].size(), 0.0);
+    for (const VQVector& v : vectors) {
+        for (std::size_t i = 0; i < sum.size() && i < v.size(); ++i) sum[i] += v[i];
+    }
+    for (double& x : sum) x /= static_cast<double>(vectors.size());
+    return sum;
+}
+
+int nearestCodeword (const VQVector& v, const std::vector<VQVector>& codebook) {
+    double minDist = std::numeric_limits<double>::max();
+    int id = -1;
+    for (int k = 0; k < static_cast<int>(codebook.size()); ++k) {
+        double d = squaredDistance(v, codebook[k]);
+        if (d < minDist) {
+            minDist = d;
+            id = k;
+        }
+    }
+    return id;
+}
+
+std::vector<int> encodeVQ (const std::vector<VQVector>& data, const std::vector<VQVector>& codebook) {
+    std::vector<int> res;
+    res.reserve(data.size());
+    for (const VQVector& v : data) res.push_back(nearestCodeword(v, codebook));
+    return res;
+}
+
+std::vector<VQVector> decodeVQ (const std::vector<int>& indices, const std::vector<VQVector>& codebook) {
+    std::vector<VQVector> res;
+    res.reserve(indices.size());
+    const int n = static_cast<int>(codebook.size());
+    for (int i : indices) {
+        res.push_back(i >= 0 && i < n ? codebook[i] : VQVector());
+    }
+    return res;
+}
+
+std::vector<VQVector> trainLBG (const std::vector<VQVector>& trainingVectors, int targetCodebookSize, double epsilon, int maxIterations, double perturbation, std::ostream* log) {
+    if (trainingVectors.empty() || targetCodebookSize < 1) return {};
+    // 碼書不會比訓練資料多 (多出的碼向量必然是空聚類)
+    const std::size_t target = std::min(static_cast<std::size_t>(targetCodebookSize), trainingVectors.size());
+    const std::size_t dim = trainingVectors[0].size();
+
+    // 1. 初始碼書 (大小為 1) 是所有訓練資料的平均值
+    std::vector<VQVector> codebook{calculateCentroid(trainingVectors)};
+    if (log) *log << "  初始碼書大小: 1" << "\n";
+
+    // 擾動向量，第一維稍微加大以打破對稱性
+    VQVector perturbationVector(dim, perturbation);
+    if (dim > 0) perturbationVector[0] += 0.1;
+
+    while (codebook.size() < target) {
+        // 2a. 分裂碼書
+        std::vector<VQVector> newCodebook;
+        if (log) *log << "  分裂碼書從 " << codebook.size() << " 到 ";
+        for (const VQVector& codeword : codebook) {
+            VQVector plus = codeword, minus = codeword;
+            for (std::size_t i = 0; i < dim; ++i) {
+                plus[i] += perturbationVector[i];
+                minus[i] -= perturbationVector[i];
+            }
+            if (newCodebook.size() < target) newCodebook.push_back(std::move(plus));
+            if (newCodebook.size() < target) newCodebook.push_back(std::move(minus));
+        }
+        codebook = std::move(newCodebook);
+        if (log) *log << codebook.size() << "..." << "\n";
+
+        // 2b. K-means 迭代優化當前碼書
+        double lastAvgDistortion = std::numeric_limits<double>::max();
+        for (int iter = 0; iter < maxIterations; ++iter) {
+            // 分配步驟
+            std::vector<std::vector<int>> clusters(codebook.size());
+            double totalDistortion = 0.0;
+            for (int i = 0; i < static_cast<int>(trainingVectors.size()); ++i) {
+                int k = nearestCodeword(trainingVectors[i], codebook);
+                if (k != -1) {
+                    clusters[k].push_back(i);
+                    totalDistortion += squaredDistance(trainingVectors[i], codebook[k]);
+                }
+            }
+
+            // 更新步驟
+            int emptyClusters = 0;
+            for (std::size_t k = 0; k < codebook.size(); ++k) {
+                if (clusters[k].empty()) {
+                    ++emptyClusters;
+                    continue;
+                }
+                std::vector<VQVector> members;
+                members.reserve(clusters[k].size());
+                for (int index : clusters[k]) members.push_back(trainingVectors[index]);
+                codebook[k] = calculateCentroid(members);
+            }
+            if (emptyClusters > 0 && log) {
+                *log << "    警告：K-means 迭代 " << iter << " 發現 " << emptyClusters << " 個空聚類！" << "\n";
+            }
+
+            // 檢查收斂 (相對失真變化)
+            double avgDistortion = totalDistortion / trainingVectors.size();
+            double change = std::abs(lastAvgDistortion - avgDistortion);
+            if (log) *log << "      迭代 " << iter << ": 平均失真 = " << avgDistortion << ", 變化 = " << change << "\n";
+            if (lastAvgDistortion != 0 && change / lastAvgDistortion < epsilon) {
+                if (log) *log << "    K-means 收斂於迭代 " << iter << "\n";
+                break;
+            }
+            lastAvgDistortion = avgDistortion;
+        }
+    }
+    return codebook;
+}
+
+}  // namespace stego
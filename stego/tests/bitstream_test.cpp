@@ -0,0 +1,84 @@
+// 打包位元序列 (BitBuffer / BitWriter / BitReader) 與位元轉換的測試
+
+#include <string>
+
+#include "stego/bits.hpp"
+#include "stego/bitstream.hpp"
+#include "testing.hpp"
+
+using namespace stego;
+
+// 任意長度的寫入與讀出順序一致，且與逐位元的 operator[] 相同
+STEGO_TEST(writerReaderRoundTrip) {
+    std::mt19937 rng(1);
+    std::vector<std::pair<std::uint64_t, int>> fields;
+    BitWriter writer;
+    for (int i = 0; i < 5000; ++i) {
+        const int n = static_cast<int>(rng() % 65);
+        const std::uint64_t v = (static_cast<std::uint64_t>(rng()) << 32 | rng()) & detail::lowMask(n);
+        if (i % 7 == 0) {
+            const std::uint8_t bytes[3] = {static_cast<std::uint8_t>(v), 0x5A, 0xC3};
+            writer.writeBytes(bytes, 3);
+            fields.emplace_back(bytes[0], 8);
+            fields.emplace_back(0x5A, 8);
+            fields.emplace_back(0xC3, 8);
+        }
+        fields.emplace_back(v, n);
+        writer.write(v, n);
+    }
+    const BitBuffer bits = writer.take();
+    BitReader reader(bits);
+    std::size_t total = 0;
+    bool same = true;
+    for (std::size_t i = 0; i < fields.size(); ++i) {
+        total += fields[i].second;
+        same = same && reader.read(fields[i].second) == fields[i].first;
+    }
+    CHECK(same);
+    CHECK(bits.size() == total);
+    CHECK(reader.done());
+}
+
+STEGO_TEST(bitBufferReadMatchesIndexing) {
+    const BitBuffer bits = test::randomBits(1000, 2);
+    bool same = true;
+    for (std::size_t pos = 0; pos + 64 <= bits.size(); pos += 13) {
+        for (int n : {1, 7, 8, 33, 64}) {
+            std::uint64_t expected = 0;
+            for (int i = 0; i < n; ++i) expected = expected << 1 | bits[pos + i];
+            same = same && bits.read(pos, n) == expected;
+        }
+    }
+    CHECK(same);
+}
+
+STEGO_TEST(writeBitsAppendsUnalignedBuffers) {
+    const BitBuffer a = test::randomBits(13, 3), b = test::randomBits(1021, 4);
+    BitWriter writer;
+    writer.writeBits(a);
+    writer.writeBits(b);
+    const BitBuffer joined = writer.take();
+    CHECK(joined.size() == a.size() + b.size());
+    bool same = true;
+    for (std::size_t i = 0; i < a.size(); ++i) same = same && joined[i] == a[i];
+    for (std::size_t i = 0; i < b.size(); ++i) same = same && joined[a.size() + i] == b[i];
+    CHECK(same);
+}
+
+STEGO_TEST(resizeClearsTruncatedBits) {
+    BitBuffer bits = BitBuffer::fromBytes("\xFF\xFF", 2);
+    bits.resize(3);
+    bits.resize(16);
+    CHECK(bits.data()[0] == 0xE0);
+    CHECK(bits.data()[1] == 0x00);
+}
+
+STEGO_TEST(stringAndIntConversions) {
+    const std::string message("hi\0there", 8);
+    CHECK(bitsToRawString(stringToBits(message)) == message);
+    CHECK(bitsToBinaryString(binaryStringToBits("1011001")) == "1011001");
+    CHECK(bitsToInt(intToBits(0xDEADBEEF)) == 0xDEADBEEFu);
+    CHECK(bitsToInt(intToBits(300, 12), 12) == 300u);
+}
+
+int main () { return test::runAll(); }
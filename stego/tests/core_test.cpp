@@ -0,0 +1,50 @@
+// 影像容器、品質指標與流加密的測試
+
+#include <cmath>
+
+#include "stego/cipher.hpp"
+#include "stego/metrics.hpp"
+#include "testing.hpp"
+
+using namespace stego;
+
+// ROI 與原影像共用像素，clone 則是連續的獨立複本
+STEGO_TEST(imageViewAndClone) {
+    Image<std::uint8_t> img = test::randomImage(20, 30, 1, 3);
+    GrayView roi = img.view().roi(4, 5, 10, 6);
+    CHECK(roi.rows == 6 && roi.cols == 10 && roi.channels == 3);
+    CHECK(!roi.continuous());
+    CHECK(&roi.at(0, 0, 2) == &img.at(5, 4, 2));
+
+    Image<std::uint8_t> copy = Image<std::uint8_t>::clone(roi);
+    CHECK(copy.view().continuous());
+    CHECK(test::sameImage<std::uint8_t>(copy.view(), roi));
+    copy.at(0, 0) ^= 1;
+    CHECK(copy.at(0, 0) != img.at(5, 4));
+}
+
+STEGO_TEST(psnrAndCompare) {
+    const Image<std::uint8_t> a = test::randomImage(16, 16, 2);
+    Image<std::uint8_t> b = Image<std::uint8_t>::clone(a);
+    CHECK(std::isinf(calculatePSNR(a, b)));
+    CHECK(compareImages(a, b));
+
+    // 每個像素差 1：MSE = 1，PSNR = 20 log10(255)
+    for (std::size_t i = 0; i < b.total(); ++i) b.data()[i] = static_cast<std::uint8_t>(a.data()[i] ^ 1);
+    CHECK(std::abs(calculatePSNR(a, b) - 20.0 * std::log10(255.0)) < 1e-9);
+    CHECK(!compareImages(a, b));
+
+    CHECK(calculatePSNR(a, test::randomImage(16, 17, 2)) == 0.0);
+    CHECK(!compareImages(a, Image<std::uint8_t>()));
+}
+
+// 同一個金鑰加密兩次還原原圖，不同金鑰得到不同的密文
+STEGO_TEST(streamCipherIsInvolution) {
+    const Image<std::uint8_t> img = test::naturalImage(40, 50, 3);
+    const Image<std::uint8_t> encrypted = encryptDecryptStream(img, 12345);
+    CHECK(!test::sameImage(encrypted, img));
+    CHECK(test::sameImage(encryptDecryptStream(encrypted, 12345), img));
+    CHECK(!test::sameImage(encryptDecryptStream(img, 12346), encrypted));
+}
+
+int main () { return test::runAll(); }
@@ -0,0 +1,107 @@
+// 浮點 Haar DWT 的測試：向量路徑與逐區塊公式逐位元相同、多層轉換遞迴處理 LL、反轉換還原、逐列分解輸出各層 LL
+
+#include <cmath>
+#include <vector>
+
+#include "stego/dwt.hpp"
+#include "testing.hpp"
+
+using namespace stego;
+
+namespace {
+
+Image<float> toFloat (ConstGrayView img) {
+    Image<float> out(img.rows, img.cols);
+    for (int r = 0; r < img.rows; ++r) {
+        for (int c = 0; c < img.cols; ++c) out.at(r, c) = img.at(r, c);
+    }
+    return out;
+}
+
+// 一層 Haar 的逐區塊公式 (與 dwt.cpp 的純量路徑相同的運算順序)：先列後行，L = (a + b) * s、H = (a - b) * s
+Image<float> referenceHaar (ImageView<const float> src, float s) {
+    const int hr = src.rows / 2, hc = src.cols / 2;
+    Image<float> out(src.rows, src.cols);
+    for (int i = 0; i < hr; ++i) {
+        for (int j = 0; j < hc; ++j) {
+            const float a0 = src.at(2 * i, 2 * j), b0 = src.at(2 * i, 2 * j + 1);
+            const float a1 = src.at(2 * i + 1, 2 * j), b1 = src.at(2 * i + 1, 2 * j + 1);
+            const float l0 = (a0 + b0) * s, h0 = (a0 - b0) * s;
+            const float l1 = (a1 + b1) * s, h1 = (a1 - b1) * s;
+            out.at(i, j) = (l0 + l1) * s;
+            out.at(i, hc + j) = (h0 + h1) * s;
+            out.at(hr + i, j) = (l0 - l1) * s;
+            out.at(hr + i, hc + j) = (h0 - h1) * s;
+        }
+    }
+    return out;
+}
+
+}  // namespace
+
+// 寬度不是 16 的倍數，讓 AVX2 路徑之後還有純量尾端
+STEGO_TEST(forwardMatchesBlockFormula) {
+    const Image<float> src = toFloat(test::randomImage(38, 74, 1));
+    for (HaarScaling scaling : {HaarScaling::Orthonormal, HaarScaling::Average}) {
+        Image<float> coeffs(src.rows(), src.cols());
+        CHECK(forwardHaarDWT(src, coeffs, 1, scaling));
+        CHECK(test::sameImage(coeffs, referenceHaar(src, scaling == HaarScaling::Average ? 0.5f : 0.70710678f)));
+    }
+}
+
+// 第 2 層是對第 1 層 LL 再做一次轉換
+STEGO_TEST(multiLevelRecursesIntoLL) {
+    const Image<float> src = toFloat(test::randomImage(64, 96, 2));
+    Image<float> one(64, 96), two(64, 96);
+    CHECK(forwardHaarDWT(src, one, 1));
+    CHECK(forwardHaarDWT(src, two, 2));
+    const Image<float> ll = Image<float>::clone(subband<const float>(one, 1, Subband::LL));
+    const Image<float> again = referenceHaar(ll, 0.70710678f);
+    CHECK(test::sameImage<float>(subband<const float>(two, 1, Subband::LL), again));
+    CHECK(test::sameImage<float>(subband<const float>(two, 1, Subband::HH), subband<const float>(one, 1, Subband::HH)));
+}
+
+STEGO_TEST(inverseRoundTrip) {
+    const Image<float> src = toFloat(test::randomImage(64, 128, 3));
+    for (HaarScaling scaling : {HaarScaling::Orthonormal, HaarScaling::Average}) {
+        for (int levels = 1; levels <= 3; ++levels) {
+            Image<float> coeffs(64, 128), back(64, 128);
+            CHECK(forwardHaarDWT(src, coeffs, levels, scaling));
+            CHECK(inverseHaarDWT(coeffs, back, levels, scaling));
+            double worst = 0;
+            for (std::size_t i = 0; i < src.total(); ++i) worst = std::max(worst, static_cast<double>(std::abs(src.data()[i] - back.data()[i])));
+            CHECK(worst < 1e-3);
+        }
+    }
+    Image<float> odd(6, 10), dst(6, 10);
+    CHECK(!forwardHaarDWT(odd, dst, 2));
+}
+
+// everyLevelLL：逐列分解送出的各層 LL 與 forwardHaarDWT 只做到該層時的 LL 逐位元相同
+STEGO_TEST(streamEmitsEveryLevelLL) {
+    const int rows = 48, cols = 80, levels = 3;
+    const Image<std::uint8_t> img = test::randomImage(rows, cols, 4);
+    std::vector<Image<float>> ll(levels + 1);
+    std::vector<int> detailRows(levels + 1, 0);
+    for (int level = 1; level <= levels; ++level) ll[level] = Image<float>(rows >> level, cols >> level);
+    const GrayRowSource source = [&](int r, std::uint8_t* out) {
+        std::copy(img.ptr(r), img.ptr(r) + cols, out);
+        return true;
+    };
+    const SubbandRowSink sink = [&](int level, Subband band, int row, const float* data, int width) {
+        if (band == Subband::HH) ++detailRows[level];
+        if (band == Subband::LL) std::copy(data, data + width, ll[level].ptr(row));
+        return true;
+    };
+    CHECK(streamHaarDWT(rows, cols, source, sink, levels, HaarScaling::Average, true));
+
+    const Image<float> src = toFloat(img);
+    for (int level = 1; level <= levels; ++level) {
+        Image<float> coeffs(rows, cols);
+        CHECK(forwardHaarDWT(src, coeffs, level, HaarScaling::Average));
+        CHECK(test::sameImage<float>(ll[level], subband<const float>(coeffs, level, Subband::LL)));
+        CHECK(detailRows[level] == rows >> level);
+    }
+}
+
+int main () { return test::runAll(); }
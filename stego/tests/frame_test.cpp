@@ -0,0 +1,65 @@
+// 框架標頭 (長度 + CRC32C) 的測試
+
+#include <string>
+
+#include "stego/frame.hpp"
+#include "testing.hpp"
+
+using namespace stego;
+
+namespace {
+
+std::string readFramedMessage (const BitBuffer& framed, FrameAlgorithm algorithm, std::uint16_t param, FrameStatus& status) {
+    FrameReader reader(algorithm, param, framed.size());
+    for (std::size_t i = 0; i < framed.byteSize() && reader.push(framed.data()[i]); ++i) {}
+    return reader.takeMessage(&status);
+}
+
+}  // namespace
+
+// CRC32C 的標準測試向量
+STEGO_TEST(crc32cKnownValue) {
+    CHECK(crc32c("123456789", 9) == 0xE3069283u);
+    // 分段計算與一次計算相同
+    CHECK(crc32c("56789", 5, crc32c("1234", 4)) == 0xE3069283u);
+}
+
+STEGO_TEST(frameRoundTrip) {
+    const std::string message("framed \0 payload", 16);
+    const BitBuffer framed = frameMessage(message, FrameAlgorithm::LSB, 3);
+    CHECK(framed.size() == FRAME_HEADER_BITS + message.size() * 8);
+    FrameStatus status = FrameStatus::Incomplete;
+    CHECK(readFramedMessage(framed, FrameAlgorithm::LSB, 3, status) == message);
+    CHECK(status == FrameStatus::Ok);
+
+    // 空訊息仍有完整的標頭
+    const BitBuffer empty = frameMessage("", FrameAlgorithm::LSB, 3);
+    CHECK(empty.size() == static_cast<std::size_t>(FRAME_HEADER_BITS));
+    CHECK(readFramedMessage(empty, FrameAlgorithm::LSB, 3, status).empty());
+    CHECK(status == FrameStatus::Ok);
+}
+
+STEGO_TEST(frameRejectsCorruption) {
+    const BitBuffer framed = frameMessage("checksum me", FrameAlgorithm::DCTZigZag, 10);
+    FrameStatus status = FrameStatus::Ok;
+
+    std::vector<std::uint8_t> bytes = framed.bytes();
+    bytes[FRAME_HEADER_BYTES + 2] ^= 1;  // 負載的第 3 個位元組
+    CHECK(readFramedMessage(BitBuffer(bytes, framed.size()), FrameAlgorithm::DCTZigZag, 10, status).empty());
+    CHECK(status == FrameStatus::BadChecksum);
+
+    bytes = framed.bytes();
+    bytes[0] ^= 0x80;
+    readFramedMessage(BitBuffer(bytes, framed.size()), FrameAlgorithm::DCTZigZag, 10, status);
+    CHECK(status == FrameStatus::BadMagic);
+
+    readFramedMessage(framed, FrameAlgorithm::DCTZigZag, 9, status);
+    CHECK(status == FrameStatus::BadParameters);
+
+    BitBuffer cut = framed;
+    cut.resize(framed.size() - 8);
+    readFramedMessage(cut, FrameAlgorithm::DCTZigZag, 10, status);
+    CHECK(status != FrameStatus::Ok);
+}
+
+int main () { return test::runAll(); }
@@ -0,0 +1,141 @@
+// 半色調的測試：波前平行 Floyd-Steinberg 與逐點迴圈逐位元相同、定點誤差擴散、有序抖色的向量與純量路徑一致
+
+#include <cmath>
+#include <vector>
+
+#include "stego/halftone.hpp"
+#include "testing.hpp"
+
+using namespace stego;
+
+namespace {
+
+// Ch09_2 / Final Demo 1 原本的逐點 float 迴圈
+Image<std::uint8_t> referenceFloydSteinberg (ConstGrayView src) {
+    std::vector<float> img(src.total());
+    for (int r = 0; r < src.rows; ++r) {
+        for (int c = 0; c < src.cols; ++c) img[static_cast<std::size_t>(r) * src.cols + c] = src.at(r, c);
+    }
+    Image<std::uint8_t> out(src.rows, src.cols);
+    for (int r = 0; r < src.rows; ++r) {
+        for (int c = 0; c < src.cols; ++c) {
+            float* px = img.data() + static_cast<std::size_t>(r) * src.cols;
+            const float oldPixel = px[c];
+            const float newPixel = oldPixel > 127 ? 255.0f : 0.0f;
+            out.at(r, c) = static_cast<std::uint8_t>(newPixel);
+            const float quantError = oldPixel - newPixel;
+            if (c + 1 < src.cols) px[c + 1] += quantError * 7.0f / 16.0f;
+            if (r + 1 < src.rows) {
+                float* below = px + src.cols;
+                if (c > 0) below[c - 1] += quantError * 3.0f / 16.0f;
+                below[c] += quantError * 5.0f / 16.0f;
+                if (c + 1 < src.cols) below[c + 1] += quantError * 1.0f / 16.0f;
+            }
+        }
+    }
+    return out;
+}
+
+bool binary (const Image<std::uint8_t>& img) {
+    for (std::size_t i = 0; i < img.total(); ++i) {
+        if (img.data()[i] != 0 && img.data()[i] != 255) return false;
+    }
+    return true;
+}
+
+double mean (const Image<std::uint8_t>& img) {
+    double sum = 0;
+    for (std::size_t i = 0; i < img.total(); ++i) sum += img.data()[i];
+    return sum / static_cast<double>(img.total());
+}
+
+}  // namespace
+
+// 影像要夠大 (>= 2^16 像素) 才會真的以波前平行執行
+STEGO_TEST(floydSteinbergMatchesReference) {
+    const Image<std::uint8_t> src = test::naturalImage(290, 310, 1);
+    const Image<std::uint8_t> expected = referenceFloydSteinberg(src);
+    for (int threads : {1, 2, 4}) {
+        Image<std::uint8_t> dst(src.rows(), src.cols());
+        CHECK(floydSteinberg(src, dst, threads));
+        CHECK(test::sameImage(dst, expected));
+    }
+    // src 與 dst 可以是同一張
+    Image<std::uint8_t> inPlace = Image<std::uint8_t>::clone(src);
+    CHECK(floydSteinberg(inPlace, inPlace, 4));
+    CHECK(test::sameImage(inPlace, expected));
+
+    Image<std::uint8_t> wrongSize(10, 10);
+    CHECK(!floydSteinberg(src, wrongSize));
+}
+
+// 每種濾波器的輸出只有 0/255，平均亮度接近原圖
+STEGO_TEST(errorDiffusionPreservesTone) {
+    const Image<std::uint8_t> src = test::naturalImage(200, 240, 2);
+    for (DiffusionFilter filter : {DiffusionFilter::FloydSteinberg, DiffusionFilter::JarvisJudiceNinke, DiffusionFilter::Stucki, DiffusionFilter::Atkinson}) {
+        for (bool serpentine : {false, true}) {
+            Image<std::uint8_t> dst(src.rows(), src.cols());
+            CHECK(errorDiffusion(src, dst, filter, serpentine));
+            CHECK(binary(dst));
+            // Atkinson 只擴散 3/4 的誤差，允許較大的偏差
+            CHECK(std::abs(mean(dst) - mean(src)) < (filter == DiffusionFilter::Atkinson ? 8.0 : 2.0));
+
+            Image<std::uint8_t> inPlace = Image<std::uint8_t>::clone(src);
+            CHECK(errorDiffusion(inPlace, inPlace, filter, serpentine));
+            CHECK(test::sameImage(inPlace, dst));
+        }
+    }
+}
+
+// 從寬影像 (全部走向量路徑) 反推門檻矩陣，再用它檢查寬度有零頭的影像 (尾端走純量路徑)
+STEGO_TEST(orderedDitherVectorMatchesScalar) {
+    const std::pair<ThresholdMatrix, int> matrices[] = {{ThresholdMatrix::Bayer4, 4}, {ThresholdMatrix::Bayer8, 8}, {ThresholdMatrix::BlueNoise64, 64}};
+    for (const auto& m : matrices) {
+        const int n = m.second;
+        // 第 r 列、第 v 個 n 寬區塊的像素值都是 v：區塊內 (r, c) 變白的最小 v 減 1 就是該位置的門檻
+        Image<std::uint8_t> ramp(n, 256 * n), rampOut(n, 256 * n);
+        for (int r = 0; r < n; ++r) {
+            for (int c = 0; c < 256 * n; ++c) ramp.at(r, c) = static_cast<std::uint8_t>(c / n);
+        }
+        CHECK(orderedDither(ramp, rampOut, m.first, 1));
+        std::vector<int> threshold(static_cast<std::size_t>(n) * n, 255);
+        for (int r = 0; r < n; ++r) {
+            for (int c = 0; c < n; ++c) {
+                for (int v = 0; v < 256; ++v) {
+                    if (rampOut.at(r, v * n + c)) {
+                        threshold[static_cast<std::size_t>(r) * n + c] = v - 1;
+                        break;
+                    }
+                }
+            }
+        }
+
+        const Image<std::uint8_t> src = test::randomImage(3 * n + 5, 203, 3);
+        Image<std::uint8_t> serial(src.rows(), src.cols()), parallel(src.rows(), src.cols());
+        CHECK(orderedDither(src, serial, m.first, 1));
+        CHECK(orderedDither(src, parallel, m.first, 4));
+        CHECK(test::sameImage(serial, parallel));
+        bool same = true;
+        for (int r = 0; r < src.rows(); ++r) {
+            for (int c = 0; c < src.cols(); ++c) {
+                const int expected = src.at(r, c) > threshold[static_cast<std::size_t>(r % n) * n + c % n] ? 255 : 0;
+                same = same && serial.at(r, c) == expected;
+            }
+        }
+        CHECK(same);
+    }
+}
+
+// 平坦的灰階抖色後白點比例接近灰度
+STEGO_TEST(orderedDitherReproducesGray) {
+    for (ThresholdMatrix matrix : {ThresholdMatrix::Bayer8, ThresholdMatrix::BlueNoise64}) {
+        for (int gray : {32, 128, 200}) {
+            const Image<std::uint8_t> src(128, 128, 1, static_cast<std::uint8_t>(gray));
+            Image<std::uint8_t> dst(128, 128);
+            CHECK(orderedDither(src, dst, matrix));
+            CHECK(std::abs(mean(dst) - gray) < 5.0);
+        }
+    }
+}
+
+int main () { return test::runAll(); }
@@ -0,0 +1,188 @@
+// 直方圖平移 (HS) RDH 的測試：SSE2 平移與逐像素參考實作一致、含灰度 255 的影像以溢位表無損還原、
+// 多組 (峰點, 零點) 版本，平行與單執行緒結果相同
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "stego/histogram_shift.hpp"
+#include "testing.hpp"
+
+using namespace stego;
+
+namespace {
+
+// 逐像素的參考實作：P < G < Z 的像素 +1，第 i 個峰點像素依第 i 個位元變為 P 或 P+1 (負載用完後保持 P)
+Image<std::uint8_t> referenceShift (ConstGrayView cover, const BitBuffer& bits, int peak, int zero) {
+    Image<std::uint8_t> out = Image<std::uint8_t>::clone(cover);
+    std::size_t pos = 0;
+    for (int r = 0; r < cover.rows; ++r) {
+        for (int c = 0; c < cover.cols; ++c) {
+            std::uint8_t& v = out.at(r, c);
+            if (v > peak && v < zero) {
+                ++v;
+            } else if (v == peak && pos < bits.size()) {
+                v = static_cast<std::uint8_t>(peak + bits[pos++]);
+            }
+        }
+    }
+    return out;
+}
+
+BitBuffer prefix (const BitBuffer& bits, std::size_t n) {
+    BitBuffer out = bits;
+    out.resize(n);
+    return out;
+}
+
+// 嵌入 bits 後，提取的前段等於 bits 且影像無損還原 (threads 1 與 4)
+bool roundTrip (const Image<std::uint8_t>& cover, const BitBuffer& bits, HSKey& key) {
+    Image<std::uint8_t> stegoImage;
+    if (!embedHistogramShifting(cover, bits, stegoImage, key)) return false;
+    for (int threads : {1, 4}) {
+        Image<std::uint8_t> restored;
+        if (prefix(extractAndRestoreHistogramShifting(stegoImage, key, restored, threads), bits.size()) != bits) return false;
+        if (!test::sameImage(restored, cover)) return false;
+        if (!test::sameImage(restoreHistogramShifting(stegoImage, key, threads), cover)) return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+STEGO_TEST(histogramMatchesCount) {
+    const Image<std::uint8_t> img = test::randomImage(123, 77, 1);
+    Histogram expected{};
+    for (std::size_t i = 0; i < img.total(); ++i) ++expected[img.data()[i]];
+    CHECK(calculateHistogram(img, 1) == expected);
+    CHECK(calculateHistogram(img, 4) == expected);
+}
+
+// SSE2 平移與逐像素參考實作逐位元相同；平行版本與單執行緒相同
+STEGO_TEST(histogramShiftMatchesReference) {
+    const Image<std::uint8_t> cover = test::naturalImage(173, 211, 2, 0, 254);
+    const Histogram histogram = calculateHistogram(cover);
+    const int peak = findPeakBin(histogram);
+    const int zero = findZeroBin(histogram, peak);
+    CHECK(zero > peak && histogram[zero] == 0);
+    const BitBuffer bits = test::randomBits(histogram[peak] - 37, 3);
+
+    Image<std::uint8_t> serial, parallel;
+    HSKey keySerial, keyParallel;
+    CHECK(embedHistogramShifting(cover, bits, serial, keySerial, 1));
+    CHECK(embedHistogramShifting(cover, bits, parallel, keyParallel, 4));
+    CHECK(keySerial.peak == peak && keySerial.zero == zero && keySerial.overflowCount == 0);
+    CHECK(keyParallel.peak == peak && keyParallel.zero == zero);
+    CHECK(test::sameImage(serial, referenceShift(cover, bits, peak, zero)));
+    CHECK(test::sameImage(serial, parallel));
+
+    HSKey key;
+    CHECK(roundTrip(cover, bits, key));
+    CHECK(!embedHistogramShifting(cover, test::randomBits(histogram[peak] + 1, 4), serial, key));  // 容量不足
+}
+
+// 含灰度 255 (以及 0) 且沒有空灰度值的影像：零點不是空的，原本位於 Z 的像素記錄在溢位表中
+STEGO_TEST(histogramShiftHandlesFullRange) {
+    Image<std::uint8_t> cover = test::naturalImage(128, 128, 4);
+    for (int c = 0; c < 128; ++c) {
+        cover.at(0, c) = 255;
+        cover.at(127, c) = 0;
+    }
+    const Histogram histogram = calculateHistogram(cover);
+    HSKey key;
+    CHECK(roundTrip(cover, test::randomBits(histogram[findPeakBin(histogram)], 5), key));
+
+    // 每個灰度值都有像素 (255 也是)：溢位表不為空
+    Image<std::uint8_t> full = test::randomImage(96, 160, 6);
+    for (int c = 0; c < 160; ++c) full.at(c % 96, c) = 255;
+    const Histogram fullHistogram = calculateHistogram(full);
+    CHECK(roundTrip(full, test::randomBits(fullHistogram[findPeakBin(fullHistogram)], 7), key));
+    CHECK(key.overflowCount == fullHistogram[key.zero]);
+    CHECK(key.overflowCount > 0);
+
+    // 訊息版本：自然影像的第一列填入 0-255 每個灰度值
+    Image<std::uint8_t> natural = test::naturalImage(128, 256, 8);
+    for (int c = 0; c < 256; ++c) natural.at(0, c) = static_cast<std::uint8_t>(c);
+    Image<std::uint8_t> stegoImage, restored;
+    CHECK(embedMessageHistogramShifting(natural, "255", stegoImage, key, 4));
+    CHECK(key.overflowCount > 0);
+    CHECK(extractMessageHistogramShifting(stegoImage, key, restored, nullptr, 4) == "255");
+    CHECK(test::sameImage(restored, natural));
+}
+
+// Z == P+1 且不是空的：溢位像素的值與嵌入 1 的峰點像素相同，提取時必須依溢位表略過
+STEGO_TEST(histogramShiftZeroNextToPeak) {
+    // 每個灰度值 40 個像素，100 有 600 個 (峰點)、101 只有 3 個 (零點)
+    std::vector<std::uint8_t> values;
+    for (int v = 0; v < 256; ++v) values.insert(values.end(), v == 100 ? 600 : v == 101 ? 3 : 40, static_cast<std::uint8_t>(v));
+    std::mt19937 rng(8);
+    std::shuffle(values.begin(), values.end(), rng);
+    Image<std::uint8_t> cover(1, static_cast<int>(values.size()));
+    std::copy(values.begin(), values.end(), cover.data());
+
+    HSKey key;
+    const BitBuffer bits = test::randomBits(600, 9);
+    CHECK(roundTrip(cover, bits, key));
+    CHECK(key.peak == 100 && key.zero == 101 && key.overflowCount == 3);
+
+    Image<std::uint8_t> stegoImage;
+    CHECK(embedHistogramShifting(cover, bits, stegoImage, key));
+    std::string streamed;
+    streamHistogramShifting(stegoImage, key, [&](std::uint8_t b) {
+        streamed += static_cast<char>(b);
+        return true;
+    });
+    CHECK(streamed == std::string(bits.data(), bits.data() + bits.byteSize()));
+
+    // 溢位表與影像不符時拒絕
+    HSKey broken = key;
+    broken.overflowCount = 4;
+    Image<std::uint8_t> restored;
+    CHECK(extractAndRestoreHistogramShifting(stegoImage, broken, restored).empty());
+    CHECK(restored.empty());
+}
+
+STEGO_TEST(histogramShiftMessageRoundTrip) {
+    const Image<std::uint8_t> cover = test::naturalImage(128, 128, 10, 0, 254);
+    const std::string message = "histogram shifting";
+    Image<std::uint8_t> stegoImage, restored;
+    HSKey key;
+    CHECK(embedMessageHistogramShifting(cover, message, stegoImage, key, 4));
+    FrameStatus status = FrameStatus::Incomplete;
+    CHECK(extractMessageHistogramShifting(stegoImage, key, restored, &status, 4) == message);
+    CHECK(status == FrameStatus::Ok);
+    CHECK(test::sameImage(restored, cover));
+}
+
+// 多組版本：含 0 與 255 的影像也能無損還原 (溢位像素記錄在溢位表中)
+STEGO_TEST(multiHistogramShiftRoundTrip) {
+    Image<std::uint8_t> cover = test::naturalImage(150, 190, 7);
+    for (int c = 0; c < 40; ++c) {
+        cover.at(3, c) = 0;
+        cover.at(140, c) = 255;
+    }
+    const BitBuffer bits = test::randomBits(1500, 8);
+    Image<std::uint8_t> serial, parallel;
+    MultiHSKey keySerial, keyParallel;
+    CHECK(embedMultiHistogramShifting(cover, bits, serial, keySerial, 8, 1));
+    CHECK(embedMultiHistogramShifting(cover, bits, parallel, keyParallel, 8, 4));
+    CHECK(test::sameImage(serial, parallel));
+    CHECK(keySerial.pairs.size() == keyParallel.pairs.size());
+    CHECK(keySerial.overflowMap == keyParallel.overflowMap);
+
+    for (int threads : {1, 4}) {
+        Image<std::uint8_t> restored;
+        const BitBuffer extracted = extractAndRestoreMultiHistogramShifting(serial, keySerial, restored, threads);
+        CHECK(prefix(extracted, bits.size()) == bits);
+        CHECK(test::sameImage(restored, cover));
+    }
+
+    Image<std::uint8_t> stegoImage, restored;
+    MultiHSKey key;
+    CHECK(embedMessageMultiHistogramShifting(cover, "multi pair", stegoImage, key, 4, 4));
+    CHECK(extractMessageMultiHistogramShifting(stegoImage, key, restored, nullptr, 4) == "multi pair");
+    CHECK(test::sameImage(restored, cover));
+}
+
+int main () { return test::runAll(); }
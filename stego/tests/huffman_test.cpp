@@ -0,0 +1,103 @@
+// 正規 Huffman 編碼的測試：各種輸入無損往返、查表解碼與長碼字路徑、偽造或截斷的串流被拒絕
+
+#include <cstring>
+#include <string>
+
+#include "stego/huffman.hpp"
+#include "testing.hpp"
+
+using namespace stego;
+
+namespace {
+
+bool roundTrip (const std::vector<std::uint8_t>& data) {
+    const BitBuffer encoded = huffmanEncode(data.data(), data.size());
+    std::vector<std::uint8_t> decoded(3, 0xAB);  // 原本的內容必須被取代
+    return huffmanDecode(encoded, decoded) && decoded == data;
+}
+
+std::vector<std::uint8_t> bytesOf (const std::string& s) {
+    return std::vector<std::uint8_t>(s.begin(), s.end());
+}
+
+}  // namespace
+
+STEGO_TEST(roundTripVariousInputs) {
+    CHECK(roundTrip({}));
+    CHECK(roundTrip({42}));
+    CHECK(roundTrip(std::vector<std::uint8_t>(1000, 7)));  // 只有一種符號 (碼長 1)
+    CHECK(roundTrip(bytesOf("the quick brown fox jumps over the lazy dog, again and again and again")));
+
+    const Image<std::uint8_t> noise = test::randomImage(1, 50000, 1);
+    CHECK(roundTrip(std::vector<std::uint8_t>(noise.data(), noise.data() + noise.total())));
+
+    // 自然影像的像素：大部分碼字走查表 (一次兩個符號) 的路徑
+    const Image<std::uint8_t> natural = test::naturalImage(64, 96, 2);
+    const std::vector<std::uint8_t> pixels(natural.data(), natural.data() + natural.total());
+    CHECK(roundTrip(pixels));
+    CHECK(huffmanEncode(pixels.data(), pixels.size()).size() < pixels.size() * 8);
+}
+
+// 次數呈指數分布時碼長會超過上限，必須限制在 HUFFMAN_MAX_BITS 以內且仍可解碼 (長碼字路徑)
+STEGO_TEST(lengthLimitedCodes) {
+    std::array<std::uint64_t, 256> frequencies{};
+    std::vector<std::uint8_t> data;
+    for (int s = 0; s < 24; ++s) {
+        frequencies[s] = 1ull << (24 - s);
+        data.insert(data.end(), s < 18 ? (1u << (18 - s)) : 1u, static_cast<std::uint8_t>(s));
+    }
+    const HuffmanLengths lengths = huffmanCodeLengths(frequencies);
+    int longest = 0;
+    double kraft = 0;
+    for (int s = 0; s < 256; ++s) {
+        longest = std::max<int>(longest, lengths[s]);
+        if (lengths[s]) kraft += 1.0 / (1 << lengths[s]);
+        CHECK((lengths[s] != 0) == (frequencies[s] != 0));
+    }
+    CHECK(longest <= HUFFMAN_MAX_BITS);
+    CHECK(longest > HUFFMAN_LOOKUP_BITS);
+    CHECK(kraft <= 1.0);
+    HuffmanCodes codes;
+    CHECK(canonicalHuffmanCodes(lengths, codes));
+    CHECK(roundTrip(data));
+}
+
+STEGO_TEST(canonicalCodesRejectInvalidLengths) {
+    HuffmanCodes codes;
+    HuffmanLengths lengths{};
+    lengths[0] = lengths[1] = 1;
+    CHECK(canonicalHuffmanCodes(lengths, codes));
+    CHECK(codes[0] == 0 && codes[1] == 1);
+
+    lengths[2] = 1;  // Kraft 和大於 1
+    CHECK(!canonicalHuffmanCodes(lengths, codes));
+
+    lengths = HuffmanLengths{};
+    lengths[0] = HUFFMAN_MAX_BITS + 1;
+    CHECK(!canonicalHuffmanCodes(lengths, codes));
+}
+
+// 偽造的符號數 (超過資料所能容納) 必須在配置輸出前被拒絕，out 清空
+STEGO_TEST(decodeRejectsForgedCount) {
+    const std::vector<std::uint8_t> data = bytesOf("forged symbol count");
+    const BitBuffer encoded = huffmanEncode(data.data(), data.size());
+    std::vector<std::uint8_t> bytes = encoded.bytes();
+    std::memset(bytes.data(), 0xFF, 4);  // 符號數 2^32 - 1
+    std::vector<std::uint8_t> out = data;
+    CHECK(!huffmanDecode(BitBuffer(bytes, encoded.size()), out));
+    CHECK(out.empty());
+
+    // 截斷：符號數正確，但碼字在符號數之前就用完
+    BitBuffer truncated = encoded;
+    truncated.resize(encoded.size() - 16);
+    out = data;
+    CHECK(!huffmanDecode(truncated, out));
+    CHECK(out.empty());
+
+    // 標頭不完整
+    BitBuffer header = encoded;
+    header.resize(100);
+    CHECK(!huffmanDecode(header, out));
+}
+
+int main () { return test::runAll(); }
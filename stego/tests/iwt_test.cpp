@@ -0,0 +1,70 @@
+// 整數小波 (IWT) 的測試：多層 lifting 轉換可逆；HH 子帶直方圖平移以峰點提取與盲提取 (只需要隱寫影像) 都能無損還原
+
+#include <string>
+
+#include "stego/iwt.hpp"
+#include "testing.hpp"
+
+using namespace stego;
+
+namespace {
+
+BitBuffer prefix (const BitBuffer& bits, std::size_t n) {
+    BitBuffer out = bits;
+    out.resize(n);
+    return out;
+}
+
+}  // namespace
+
+// 多層 lifting IWT 原地轉換後反轉換完全還原
+STEGO_TEST(iwtMultiLevelRoundTrip) {
+    const Image<std::uint8_t> img = test::randomImage(96, 160, 11);
+    for (Wavelet wavelet : {Wavelet::Haar, Wavelet::LeGall53}) {
+        for (int levels = 1; levels <= 4; ++levels) {
+            Image<std::int32_t> coeffs(img.rows(), img.cols());
+            for (std::size_t i = 0; i < img.total(); ++i) coeffs.data()[i] = img.data()[i];
+            const Image<std::int32_t> original = Image<std::int32_t>::clone(coeffs);
+            CHECK(forwardIWT(coeffs, levels, wavelet));
+            CHECK(!test::sameImage(coeffs, original));
+            CHECK(inverseIWT(coeffs, levels, wavelet));
+            CHECK(test::sameImage(coeffs, original));
+        }
+    }
+    // 尺寸不是 2^levels 的倍數時拒絕
+    Image<std::int32_t> odd(12, 20);
+    CHECK(!forwardIWT(odd, 3));
+
+    const Image<std::int32_t> haar = forwardIWTHaar(img);
+    CHECK(test::sameImage(inverseIWTHaar(haar), img));
+}
+
+STEGO_TEST(hhHistogramShiftRoundTrip) {
+    const Image<std::uint8_t> img = test::naturalImage(128, 128, 12);
+    const Image<std::int32_t> coeffs = forwardIWTHaar(img);
+    const BitBuffer bits = test::randomBits(300, 13);
+    int peak = INVALID_PEAK;
+    const Image<std::int32_t> stegoHH = embedHSInHH(coeffs, bits, peak);
+    CHECK(!stegoHH.empty());
+    Image<std::int32_t> restored;
+    CHECK(prefix(extractRestoreHSInHH(stegoHH, peak, restored), bits.size()) == bits);
+    CHECK(test::sameImage(restored, coeffs));
+
+    const Image<std::int32_t> message = embedMessageHSInHH(coeffs, "hh band", peak);
+    CHECK(extractMessageHSInHH(message, peak, restored) == "hh band");
+    CHECK(test::sameImage(restored, coeffs));
+}
+
+// 盲提取：不需要原圖的 HH 子帶或峰點，只由隱寫影像取出並還原
+STEGO_TEST(blindHHRoundTrip) {
+    const Image<std::uint8_t> cover = test::naturalImage(160, 160, 14, 10, 245);
+    const std::string message = "blind IWT";
+    Image<std::uint8_t> stegoImage, restored;
+    CHECK(embedMessageBlindHSInHH(cover, message, stegoImage));
+    FrameStatus status = FrameStatus::Incomplete;
+    CHECK(extractMessageBlindHSInHH(stegoImage, restored, &status) == message);
+    CHECK(status == FrameStatus::Ok);
+    CHECK(test::sameImage(restored, cover));
+}
+
+int main () { return test::runAll(); }
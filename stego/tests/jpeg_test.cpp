@@ -0,0 +1,139 @@
+// JPEG 量化係數域偽裝的測試：基線與漸進式 JPEG 的訊息往返、容量、不合法與截斷的輸入
+
+#include <cstdlib>
+#include <string>
+
+extern "C" {
+#include <cstdio>
+#include <jpeglib.h>
+}
+
+#include "stego/jpeg.hpp"
+#include "testing.hpp"
+
+using namespace stego;
+
+namespace {
+
+// 以 libjpeg 在記憶體中壓縮一張測試封面 (1 或 3 通道)
+JPEGBytes encodeJPEG (const Image<std::uint8_t>& img, bool progressive, int quality = 90) {
+    jpeg_compress_struct cinfo;
+    jpeg_error_mgr jerr;
+    cinfo.err = jpeg_std_error(&jerr);
+    jpeg_create_compress(&cinfo);
+    unsigned char* buffer = nullptr;
+    unsigned long size = 0;
+    jpeg_mem_dest(&cinfo, &buffer, &size);
+    cinfo.image_width = static_cast<JDIMENSION>(img.cols());
+    cinfo.image_height = static_cast<JDIMENSION>(img.rows());
+    cinfo.input_components = img.channels();
+    cinfo.in_color_space = img.channels() == 1 ? JCS_GRAYSCALE : JCS_RGB;
+    jpeg_set_defaults(&cinfo);
+    jpeg_set_quality(&cinfo, quality, TRUE);
+    if (progressive) jpeg_simple_progression(&cinfo);
+    jpeg_start_compress(&cinfo, TRUE);
+    while (cinfo.next_scanline < cinfo.image_height) {
+        JSAMPROW row = const_cast<JSAMPROW>(img.ptr(static_cast<int>(cinfo.next_scanline)));
+        jpeg_write_scanlines(&cinfo, &row, 1);
+    }
+    jpeg_finish_compress(&cinfo);
+    JPEGBytes out(buffer, buffer + size);
+    jpeg_destroy_compress(&cinfo);
+    std::free(buffer);
+    return out;
+}
+
+// 紋理夠多的封面：漸層加上亂數，AC 係數大多不是 0 或 1
+Image<std::uint8_t> texturedCover (int rows, int cols, int channels, std::uint32_t seed) {
+    const Image<std::uint8_t> base = test::naturalImage(rows, cols, seed);
+    const Image<std::uint8_t> noise = test::randomImage(rows, cols, seed + 1, channels);
+    Image<std::uint8_t> img(rows, cols, channels);
+    for (int r = 0; r < rows; ++r) {
+        for (int c = 0; c < cols; ++c) {
+            for (int ch = 0; ch < channels; ++ch) img.at(r, c, ch) = static_cast<std::uint8_t>((base.at(r, c) * 3 + noise.at(r, c, ch)) / 4);
+        }
+    }
+    return img;
+}
+
+std::string makeMessage (std::size_t size) {
+    std::string msg(size, '\0');
+    for (std::size_t i = 0; i < size; ++i) msg[i] = static_cast<char>(i * 37 + 11);
+    return msg;
+}
+
+}  // namespace
+
+STEGO_TEST(messageRoundTripBaselineAndProgressive) {
+    const std::string message = makeMessage(200);
+    for (bool progressive : {false, true}) {
+        for (int channels : {1, 3}) {
+            const JPEGBytes cover = encodeJPEG(texturedCover(160, 200, channels, 1), progressive);
+            JPEGBytes stegoJPEG;
+            CHECK(embedMessageJPEG(cover, stegoJPEG, message, 10));
+            FrameStatus status = FrameStatus::Incomplete;
+            CHECK(extractMessageJPEG(stegoJPEG, 10, &status) == message);
+            CHECK(status == FrameStatus::Ok);
+            // 嵌入不會產生或消除可用的係數 (JSteg 規則)，提取端看到的容量相同
+            CHECK(capacityJPEG(stegoJPEG, 10) == capacityJPEG(cover, 10));
+        }
+    }
+}
+
+STEGO_TEST(capacityBounds) {
+    const int rows = 96, cols = 128;
+    const JPEGBytes cover = encodeJPEG(texturedCover(rows, cols, 1, 2), false);
+    const std::size_t blocks = static_cast<std::size_t>(rows / 8) * (cols / 8);
+    CHECK(capacityJPEG(cover, 0) == 0);
+    std::size_t previous = 0;
+    for (int coeffs : {1, 5, 10, 20}) {
+        const std::size_t capacity = capacityJPEG(cover, coeffs);
+        CHECK(capacity > previous);
+        CHECK(capacity <= blocks * coeffs);
+        previous = capacity;
+    }
+    // 超過 20 個係數時以 20 為上限
+    CHECK(capacityJPEG(cover, 40) == capacityJPEG(cover, 20));
+
+    // 負載比容量長時只嵌入容量那麼多位元，取出的就是負載的前段
+    const std::size_t capacity = capacityJPEG(cover, 10);
+    const BitBuffer bits = test::randomBits(capacity + 100, 3);
+    std::size_t embedded = 0;
+    const JPEGBytes stegoJPEG = embedJPEG(cover, bits, 10, embedded);
+    CHECK(embedded == capacity);
+    BitBuffer expected = bits;
+    expected.resize(capacity);
+    CHECK(extractJPEG(stegoJPEG, 10, capacity) == expected);
+
+    JPEGBytes unchanged;
+    CHECK(!embedMessageJPEG(cover, unchanged, makeMessage(capacity / 8), 10));
+    CHECK(unchanged.empty());
+}
+
+// 不是 JPEG 的資料與截斷的 JPEG 都必須被拒絕
+STEGO_TEST(rejectsJunkAndTruncatedInput) {
+    const JPEGBytes junk(4096, 0x5A);
+    JPEGBytes stegoJPEG;
+    CHECK(capacityJPEG(junk, 10) == 0);
+    CHECK(!embedMessageJPEG(junk, stegoJPEG, "x", 10));
+    CHECK(!embedMessageJPEG(JPEGBytes(), stegoJPEG, "x", 10));
+
+    for (bool progressive : {false, true}) {
+        const JPEGBytes cover = encodeJPEG(texturedCover(128, 128, 3, 4), progressive);
+        const JPEGBytes truncated(cover.begin(), cover.begin() + cover.size() / 2);
+        CHECK(capacityJPEG(truncated, 10) == 0);
+        CHECK(!embedMessageJPEG(truncated, stegoJPEG, "short message", 10));
+        std::size_t embedded = 1;
+        CHECK(embedJPEG(truncated, test::randomBits(64, 5), 10, embedded).empty());
+        CHECK(embedded == 0);
+
+        // 嵌入後再截斷，提取端不會回報成功
+        CHECK(embedMessageJPEG(cover, stegoJPEG, "short message", 10));
+        FrameStatus status = FrameStatus::Ok;
+        extractMessageJPEG(JPEGBytes(stegoJPEG.begin(), stegoJPEG.begin() + stegoJPEG.size() / 2), 10, &status);
+        CHECK(status != FrameStatus::Ok);
+    }
+    CHECK(stegoJPEG.size() > 0);
+}
+
+int main () { return test::runAll(); }
@@ -0,0 +1,176 @@
+// 大影像逐列處理的測試：逐列 Haar DWT 與整張影像版本逐位元相同、記憶體映射讀取 raw / TIFF、拒絕不合法的 TIFF
+
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "stego/dwt.hpp"
+#include "stego/large_image.hpp"
+#include "testing.hpp"
+
+using namespace stego;
+
+namespace {
+
+Image<float> toFloat (ConstGrayView img) {
+    Image<float> out(img.rows, img.cols);
+    for (int r = 0; r < img.rows; ++r) {
+        for (int c = 0; c < img.cols; ++c) out.at(r, c) = img.at(r, c);
+    }
+    return out;
+}
+
+std::string tempPath (const char* name) {
+    return std::string("stego_large_image_test_") + name;
+}
+
+void writeFile (const std::string& path, const std::vector<std::uint8_t>& bytes) {
+    std::ofstream f(path, std::ios::binary | std::ios::trunc);
+    f.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+}
+
+void put16 (std::vector<std::uint8_t>& out, std::size_t at, std::uint32_t v) {
+    out[at] = static_cast<std::uint8_t>(v);
+    out[at + 1] = static_cast<std::uint8_t>(v >> 8);
+}
+
+void put32 (std::vector<std::uint8_t>& out, std::size_t at, std::uint32_t v) {
+    put16(out, at, v);
+    put16(out, at + 2, v >> 16);
+}
+
+// 最小的未壓縮 8 位元灰階 TIFF (little-endian，單一條帶)
+std::vector<std::uint8_t> makeTIFF (ConstGrayView img, int photometric) {
+    const int entries = 8;
+    const std::size_t ifd = 8, data = ifd + 2 + entries * 12 + 4;
+    std::vector<std::uint8_t> out(data + img.total());
+    out[0] = out[1] = 'I';
+    put16(out, 2, 42);
+    put32(out, 4, static_cast<std::uint32_t>(ifd));
+    put16(out, ifd, entries);
+    const std::uint32_t fields[entries][3] = {
+        {256, 4, static_cast<std::uint32_t>(img.cols)},
+        {257, 4, static_cast<std::uint32_t>(img.rows)},
+        {258, 3, 8},
+        {259, 3, 1},
+        {262, 3, static_cast<std::uint32_t>(photometric)},
+        {273, 4, static_cast<std::uint32_t>(data)},
+        {277, 3, 1},
+        {278, 4, static_cast<std::uint32_t>(img.rows)},
+    };
+    for (int i = 0; i < entries; ++i) {
+        const std::size_t at = ifd + 2 + i * 12;
+        put16(out, at, fields[i][0]);
+        put16(out, at + 2, fields[i][1]);
+        put32(out, at + 4, 1);
+        if (fields[i][1] == 3) {
+            put16(out, at + 8, fields[i][2]);
+        } else {
+            put32(out, at + 8, fields[i][2]);
+        }
+    }
+    for (int r = 0; r < img.rows; ++r) std::copy(img.ptr(r), img.ptr(r) + img.cols, out.begin() + data + static_cast<std::size_t>(r) * img.cols);
+    return out;
+}
+
+// 收集 streamHaarDWT 輸出的各子帶，依 (level, band) 存成影像
+using SubbandImages = std::map<std::pair<int, int>, Image<float>>;
+
+SubbandRowSink collect (SubbandImages& bands, int rows, int cols) {
+    return [&bands, rows, cols](int level, Subband band, int row, const float* data, int width) {
+        Image<float>& img = bands[{level, static_cast<int>(band)}];
+        if (img.empty()) img = Image<float>(rows >> level, cols >> level);
+        if (width != img.cols() || row >= img.rows()) return false;
+        std::copy(data, data + width, img.ptr(row));
+        return true;
+    };
+}
+
+bool bandsMatch (const SubbandImages& bands, ImageView<const float> coeffs, int levels) {
+    for (int level = 1; level <= levels; ++level) {
+        for (Subband band : {Subband::LL, Subband::HL, Subband::LH, Subband::HH}) {
+            if (band == Subband::LL && level != levels) continue;
+            const auto it = bands.find({level, static_cast<int>(band)});
+            if (it == bands.end() || !test::sameImage(it->second.view(), subband(coeffs, level, band))) return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+// 逐列分解的每個子帶與整張影像的 forwardHaarDWT 逐位元相同
+STEGO_TEST(streamMatchesInMemory) {
+    const Image<std::uint8_t> img = test::randomImage(48, 80, 4);
+    const int levels = 3;
+    Image<float> coeffs(48, 80);
+    CHECK(forwardHaarDWT(toFloat(img), coeffs, levels));
+
+    SubbandImages bands;
+    const bool ok = streamHaarDWT(48, 80, [&](int r, std::uint8_t* out) {
+        std::copy(img.ptr(r), img.ptr(r) + 80, out);
+        return true;
+    }, collect(bands, 48, 80), levels);
+    CHECK(ok);
+    CHECK(bandsMatch(bands, coeffs, levels));
+}
+
+STEGO_TEST(mappedRawAndTIFF) {
+    const Image<std::uint8_t> img = test::randomImage(40, 72, 5);
+    std::vector<std::uint8_t> raw(16 + img.total(), 0xEE);  // 前 16 個位元組是假標頭
+    std::copy(img.data(), img.data() + img.total(), raw.begin() + 16);
+    const std::string rawPath = tempPath("image.raw"), tiffPath = tempPath("image.tif"), invPath = tempPath("inverted.tif");
+    writeFile(rawPath, raw);
+    writeFile(tiffPath, makeTIFF(img, 1));
+    writeFile(invPath, makeTIFF(img, 0));
+
+    std::vector<std::uint8_t> row(72);
+    bool same = true;
+    MappedGrayImage mapped;
+    CHECK(mapped.openRaw(rawPath, 40, 72, 16));
+    for (int r = 0; r < 40; ++r) same = same && mapped.readRow(r, row.data()) && std::equal(row.begin(), row.end(), img.ptr(r));
+    CHECK(same);
+    CHECK(!mapped.openRaw(rawPath, 41, 72, 16));  // 超出檔案
+
+    CHECK(mapped.openTIFF(tiffPath));
+    CHECK(mapped.rows() == 40 && mapped.cols() == 72);
+    same = true;
+    for (int r = 0; r < 40; ++r) same = same && mapped.readRow(r, row.data()) && std::equal(row.begin(), row.end(), img.ptr(r));
+    CHECK(same);
+
+    // 從映射的檔案逐列分解，結果與整張影像相同
+    SubbandImages bands;
+    CHECK(streamHaarDWT(40, 72, mapped.rowSource(), collect(bands, 40, 72), 2));
+    Image<float> coeffs(40, 72);
+    CHECK(forwardHaarDWT(toFloat(img), coeffs, 2));
+    CHECK(bandsMatch(bands, coeffs, 2));
+
+    // WhiteIsZero 讀出時反相
+    CHECK(mapped.openTIFF(invPath));
+    CHECK(mapped.readRow(7, row.data()) && row[3] == 255 - img.at(7, 3));
+    mapped.close();
+
+    std::remove(rawPath.c_str());
+    std::remove(tiffPath.c_str());
+    std::remove(invPath.c_str());
+}
+
+// BigTIFF 的 IFD 項目數若讓 entries * 20 溢位，必須被拒絕而不是讀到映射範圍外
+STEGO_TEST(tiffRejectsOverflowingCounts) {
+    std::vector<std::uint8_t> file(64, 0);
+    file[0] = file[1] = 'I';
+    file[2] = 43;
+    file[4] = 8;
+    file[8] = 16;  // IFD 位置
+    const std::uint64_t entries = 0x0CCCCCCCCCCCCCCDull;  // * 20 在 64 位元下溢位成 4
+    for (int i = 0; i < 8; ++i) file[16 + i] = static_cast<std::uint8_t>(entries >> (8 * i));
+    const std::string path = tempPath("overflow.tif");
+    writeFile(path, file);
+    MappedGrayImage mapped;
+    CHECK(!mapped.openTIFF(path));
+    std::remove(path.c_str());
+}
+
+int main () { return test::runAll(); }
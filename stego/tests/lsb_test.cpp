@@ -0,0 +1,134 @@
+// 空間域 LSB 的測試：向量核心與逐樣本參考實作一致、平行版本與單執行緒相同
+
+#include <string>
+
+#include "stego/lsb.hpp"
+#include "testing.hpp"
+
+using namespace stego;
+
+namespace {
+
+// 逐樣本的參考實作：第 s 個樣本的最低 k 位元換成負載第 s * k 起的 k 個位元 (超出結尾補 0)
+void referenceEmbed (GrayView image, const BitBuffer& bits, int k, std::size_t firstSample) {
+    const std::uint8_t mask = static_cast<std::uint8_t>(~((1 << k) - 1));
+    const std::size_t rowLen = static_cast<std::size_t>(image.cols) * image.channels;
+    for (std::size_t i = 0; i * k < bits.size() && firstSample + i < image.samples(); ++i) {
+        const std::size_t s = firstSample + i;
+        std::uint8_t& px = image.ptr(static_cast<int>(s / rowLen))[s % rowLen];
+        px = static_cast<std::uint8_t>((px & mask) | bits.read(i * k, k));
+    }
+}
+
+}  // namespace
+
+// SIMD 核心處理對齊的區段、前後不對齊的部分逐樣本處理，合起來要和參考實作逐位元相同
+STEGO_TEST(embedMatchesScalarReference) {
+    const Image<std::uint8_t> cover = test::randomImage(61, 97, 10);
+    for (int k = 1; k <= 8; ++k) {
+        for (std::size_t first : {std::size_t(0), std::size_t(3), std::size_t(129)}) {
+            const BitBuffer bits = test::randomBits(cover.total() * k / 2 + 5, 20 + k);
+            Image<std::uint8_t> fast = Image<std::uint8_t>::clone(cover), slow = Image<std::uint8_t>::clone(cover);
+            embedLSB(fast, bits, k, first);
+            referenceEmbed(slow, bits, k, first);
+            CHECK(test::sameImage(fast, slow));
+
+            // 取出的位元與嵌入的相同
+            CHECK(extractLSB(fast, bits.size(), k, first) == bits);
+        }
+    }
+}
+
+// 不連續的視圖 (ROI) 逐列處理
+STEGO_TEST(embedHandlesRoi) {
+    Image<std::uint8_t> whole = test::randomImage(80, 80, 11);
+    const Image<std::uint8_t> original = Image<std::uint8_t>::clone(whole);
+    GrayView roi = whole.view().roi(5, 7, 50, 40);
+    const BitBuffer bits = test::randomBits(50 * 40 * 2, 12);
+    CHECK(embedLSB(roi, bits, 2) == bits.size());
+    CHECK(extractLSB(roi, bits.size(), 2) == bits);
+    // ROI 外的像素不變
+    bool outside = true;
+    for (int r = 0; r < 80; ++r) {
+        for (int c = 0; c < 80; ++c) {
+            if (r >= 7 && r < 47 && c >= 5 && c < 55) continue;
+            outside = outside && whole.at(r, c) == original.at(r, c);
+        }
+    }
+    CHECK(outside);
+}
+
+// 多通道影像依通道交錯順序嵌入
+STEGO_TEST(embedInterleavesChannels) {
+    Image<std::uint8_t> bgr = test::randomImage(33, 45, 13, 3), reference = Image<std::uint8_t>::clone(bgr);
+    const BitBuffer bits = test::randomBits(bgr.total() * 3 * 3, 14);
+    embedLSB(bgr, bits, 3);
+    referenceEmbed(reference, bits, 3, 0);
+    CHECK(test::sameImage(bgr, reference));
+}
+
+// 負載依樣本切段後各段獨立嵌入，結果要和單執行緒完全相同 (影像夠大才會真的切成多段)
+STEGO_TEST(parallelMatchesSerial) {
+    const Image<std::uint8_t> cover = test::randomImage(1024, 1100, 15);
+    for (int k : {1, 3, 4, 7}) {
+        const BitBuffer bits = test::randomBits(cover.total() * k - 11, 30 + k);
+        Image<std::uint8_t> serial = Image<std::uint8_t>::clone(cover), parallel = Image<std::uint8_t>::clone(cover);
+        const std::size_t a = embedLSB(serial, bits, k, 17);
+        const std::size_t b = embedLSBParallel(parallel, bits, k, 17, 4);
+        CHECK(a == b);
+        CHECK(test::sameImage(serial, parallel));
+        CHECK(extractLSBParallel(parallel, a, k, 17, 4) == extractLSB(serial, a, k, 17));
+    }
+}
+
+// 串流提取逐位元組交給 sink，sink 回傳 false 後停止
+STEGO_TEST(streamStopsWhenSinkDeclines) {
+    Image<std::uint8_t> image = test::randomImage(128, 160, 16);
+    embedLSB(image, BitBuffer::fromBytes("abcdef", 6), 1);
+    std::string got;
+    streamLSB(image, 1, [&](std::uint8_t b) {
+        got += static_cast<char>(b);
+        return got.size() < 3;
+    });
+    CHECK(got == "abc");
+}
+
+STEGO_TEST(messageRoundTrip) {
+    const Image<std::uint8_t> cover = test::randomImage(128, 160, 16);
+    const std::string message("LSB message with \0 inside", 25);
+    for (int threads : {1, 4}) {
+        Image<std::uint8_t> stegoImage;
+        CHECK(embedMessageLSB(cover, stegoImage, message, 2, threads));
+        FrameStatus status = FrameStatus::Incomplete;
+        CHECK(extractMessageLSB(stegoImage, 2, &status) == message);
+        CHECK(status == FrameStatus::Ok);
+    }
+    // 容量不足時失敗
+    Image<std::uint8_t> stegoImage;
+    CHECK(!embedMessageLSB(test::randomImage(8, 8, 17), stegoImage, message, 1));
+}
+
+STEGO_TEST(fixedAndAdaptiveRoundTrip) {
+    // 上半部是平坦區塊 (變異數 0)，適應性模式不會使用
+    Image<std::uint8_t> cover = test::naturalImage(96, 96, 18);
+    for (int r = 0; r < 48; ++r) std::fill(cover.ptr(r), cover.ptr(r) + 96, 100);
+    const BitBuffer payload = test::randomBits(17000, 19);
+    std::size_t embedded = 0;
+    FrameStatus status = FrameStatus::Incomplete;
+
+    const Image<std::uint8_t> fixed = embedFixedLSB(cover, payload, 2, embedded);
+    CHECK(embedded == payload.size());
+    CHECK(extractFixedLSB(fixed, 2, &status) == payload);
+    CHECK(status == FrameStatus::Ok);
+
+    // 適應性模式容量較小，負載截斷後標頭仍記錄實際嵌入的部分
+    const Image<std::uint8_t> adaptive = embedAdaptiveLSB(cover, payload, 8, 1.0, 2, embedded);
+    CHECK(!adaptive.empty());
+    CHECK(embedded > 0 && embedded < payload.size());
+    BitBuffer expected = payload;
+    expected.resize(embedded);
+    CHECK(extractAdaptiveLSB(adaptive, cover, 8, 1.0, 2, &status) == expected);
+    CHECK(status == FrameStatus::Ok);
+}
+
+int main () { return test::runAll(); }
@@ -0,0 +1,44 @@
+// 共用執行緒池的測試
+
+#include <atomic>
+#include <stdexcept>
+
+#include "stego/parallel.hpp"
+#include "testing.hpp"
+
+using namespace stego;
+
+STEGO_TEST(threadPoolRunsEveryTaskOnce) {
+    ThreadPool pool(4);
+    std::vector<std::atomic<int>> hits(1000);
+    pool.parallelFor(hits.size(), [&](std::size_t i) { hits[i]++; });
+    bool once = true;
+    for (const auto& h : hits) once = once && h == 1;
+    CHECK(once);
+
+    // 限制執行緒數時同樣每個工作只執行一次
+    for (auto& h : hits) h = 0;
+    pool.parallelFor(hits.size(), [&](std::size_t i) { hits[i]++; }, 2);
+    once = true;
+    for (const auto& h : hits) once = once && h == 1;
+    CHECK(once);
+}
+
+STEGO_TEST(threadPoolRethrowsTaskException) {
+    ThreadPool pool(3);
+    bool thrown = false;
+    try {
+        pool.parallelFor(100, [](std::size_t i) {
+            if (i == 42) throw std::runtime_error("task failed");
+        });
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    CHECK(thrown);
+    // 例外之後執行緒池仍然可用
+    std::atomic<int> count{0};
+    pool.parallelFor(50, [&](std::size_t) { count++; });
+    CHECK(count == 50);
+}
+
+int main () { return test::runAll(); }
@@ -0,0 +1,49 @@
+// 預測誤差擴張 (PEE) RDH 的測試：Rhombus 與 MED 預測器在含 0/255 的影像上無損還原，平行與單執行緒結果相同
+
+#include <string>
+
+#include "stego/pee.hpp"
+#include "testing.hpp"
+
+using namespace stego;
+
+namespace {
+
+BitBuffer prefix (const BitBuffer& bits, std::size_t n) {
+    BitBuffer out = bits;
+    out.resize(n);
+    return out;
+}
+
+}  // namespace
+
+STEGO_TEST(peeRoundTrip) {
+    Image<std::uint8_t> cover = test::naturalImage(140, 170, 9);
+    cover.at(0, 0) = 0;
+    cover.at(139, 169) = 255;
+    for (PEEPredictor predictor : {PEEPredictor::Rhombus, PEEPredictor::MED}) {
+        const BitBuffer bits = test::randomBits(5000, 10);
+        Image<std::uint8_t> serial, parallel;
+        PEEKey keySerial, keyParallel;
+        CHECK(embedPEE(cover, bits, serial, keySerial, predictor, 8, 1));
+        CHECK(embedPEE(cover, bits, parallel, keyParallel, predictor, 8, 4));
+        CHECK(test::sameImage(serial, parallel));
+        CHECK(keySerial.threshold == keyParallel.threshold);
+        CHECK(keySerial.overflowMap == keyParallel.overflowMap);
+
+        for (int threads : {1, 4}) {
+            Image<std::uint8_t> restored;
+            const BitBuffer extracted = extractAndRestorePEE(serial, keySerial, restored, threads);
+            CHECK(prefix(extracted, bits.size()) == bits);
+            CHECK(test::sameImage(restored, cover));
+        }
+
+        Image<std::uint8_t> stegoImage, restored;
+        PEEKey key;
+        CHECK(embedMessagePEE(cover, "prediction error", stegoImage, key, predictor, 8, 4));
+        CHECK(extractMessagePEE(stegoImage, key, restored, nullptr, 4) == "prediction error");
+        CHECK(test::sameImage(restored, cover));
+    }
+}
+
+int main () { return test::runAll(); }
@@ -0,0 +1,143 @@
+// 秘密分享的測試：GF(2^8) 運算與 Shamir 分享、GF(2^31 - 1) 批次拉格朗日、影像秘密分享
+// 任 k 張都能還原、少於 k 張看不出秘密，以及平行與單執行緒結果相同
+
+#include <random>
+#include <vector>
+
+#include "stego/shamir.hpp"
+#include "testing.hpp"
+
+using namespace stego;
+
+namespace {
+
+// GF(2^8) 乘法的逐位元參考實作 (既約多項式 0x11d)
+std::uint8_t referenceMul (std::uint8_t a, std::uint8_t b) {
+    unsigned result = 0, x = a;
+    for (int i = 0; i < 8; ++i) {
+        if (b & (1 << i)) result ^= x;
+        x <<= 1;
+        if (x & 0x100) x ^= 0x11d;
+    }
+    return static_cast<std::uint8_t>(result);
+}
+
+std::uint32_t mulMod (std::uint32_t a, std::uint32_t b) {
+    return static_cast<std::uint32_t>(static_cast<std::uint64_t>(a) * b % MERSENNE_31);
+}
+
+}  // namespace
+
+STEGO_TEST(gf256Arithmetic) {
+    bool ok = true;
+    for (int a = 0; a < 256; ++a) {
+        for (int b = 0; b < 256; ++b) ok = ok && gf256Mul(static_cast<std::uint8_t>(a), static_cast<std::uint8_t>(b)) == referenceMul(static_cast<std::uint8_t>(a), static_cast<std::uint8_t>(b));
+        if (a) ok = ok && gf256Mul(static_cast<std::uint8_t>(a), gf256Inv(static_cast<std::uint8_t>(a))) == 1;
+    }
+    CHECK(ok);
+}
+
+// 長度不是 32 的倍數，讓 AVX2 路徑之後還有純量尾端；跨越多個 4 KiB 區塊
+STEGO_TEST(shamirRoundTrip) {
+    const Image<std::uint8_t> secretImage = test::randomImage(1, 70001, 3);
+    const std::uint8_t* secret = secretImage.data();
+    const std::size_t size = secretImage.total();
+    const std::vector<ShamirShare> shares = shamirSplit(secret, size, 3, 6, 1234, 1);
+    CHECK(shares.size() == 6u);
+
+    const std::vector<ShamirShare> parallel = shamirSplit(secret, size, 3, 6, 1234, 4);
+    bool same = parallel.size() == shares.size();
+    for (std::size_t i = 0; same && i < shares.size(); ++i) same = shares[i].x == parallel[i].x && shares[i].data == parallel[i].data;
+    CHECK(same);
+
+    // 任 3 張 (以及多於 3 張) 都能還原
+    const std::vector<std::uint8_t> expected(secret, secret + size);
+    for (int a = 0; a < 6; ++a) {
+        for (int b = a + 1; b < 6; ++b) {
+            for (int c = b + 1; c < 6; ++c) {
+                CHECK(shamirCombine({shares[a], shares[b], shares[c]}, 1) == expected);
+            }
+        }
+    }
+    CHECK(shamirCombine(shares, 4) == expected);
+    // 只有 2 張時得到的不是秘密
+    CHECK(shamirCombine({shares[0], shares[1]}) != expected);
+
+    // 每張分享與秘密無關：單張分享等於秘密的位元組比例接近 1/256
+    std::size_t equal = 0;
+    for (std::size_t i = 0; i < size; ++i) equal += shares[0].data[i] == secret[i];
+    CHECK(equal < size / 64);
+
+    CHECK(shamirSplit(secret, size, 1, 3, 1).empty());
+    CHECK(shamirSplit(secret, size, 4, 3, 1).empty());
+    CHECK(shamirCombine({shares[0], shares[0]}).empty());
+}
+
+// 以隨機多項式在各 x 的取值還原常數項，單一、批次 (AVX2 每次 4 個秘密) 與平行的結果都相同
+STEGO_TEST(lagrangeReconstruction) {
+    std::mt19937 rng(4);
+    const int k = 5;
+    const std::vector<std::uint32_t> xs = {3, 17, 250, 1000003, MERSENNE_31 - 1};
+    const LagrangeReconstructor reconstructor(xs);
+    CHECK(reconstructor.valid());
+    CHECK(reconstructor.size() == k);
+
+    const std::size_t count = 10007;
+    std::vector<std::uint32_t> secrets(count);
+    std::vector<std::vector<std::uint32_t>> ys(k, std::vector<std::uint32_t>(count));
+    for (std::size_t j = 0; j < count; ++j) {
+        std::uint32_t coeffs[k];
+        for (std::uint32_t& a : coeffs) a = rng() % MERSENNE_31;
+        secrets[j] = coeffs[0];
+        for (int i = 0; i < k; ++i) {
+            std::uint32_t y = 0;
+            for (int d = k - 1; d >= 0; --d) y = (mulMod(y, xs[i]) + coeffs[d]) % MERSENNE_31;
+            ys[i][j] = y;
+        }
+    }
+
+    std::vector<const std::uint32_t*> rows;
+    for (const auto& y : ys) rows.push_back(y.data());
+    std::vector<std::uint32_t> serial(count), parallel(count);
+    reconstructor.reconstruct(rows.data(), count, serial.data(), 1);
+    reconstructor.reconstruct(rows.data(), count, parallel.data(), 4);
+    CHECK(serial == secrets);
+    CHECK(parallel == secrets);
+
+    std::uint32_t single[k];
+    for (int i = 0; i < k; ++i) single[i] = ys[i][123];
+    CHECK(reconstructor.reconstruct(single) == secrets[123]);
+
+    CHECK(!LagrangeReconstructor({1, 2, 2}).valid());
+    CHECK(!LagrangeReconstructor({0, 2}).valid());
+}
+
+STEGO_TEST(secretImageRoundTrip) {
+    // 包含 250 ~ 255 的像素 (GF251 需要拆成兩個值)，寬度不是 k 的倍數
+    const Image<std::uint8_t> secret = test::randomImage(45, 101, 5);
+    for (SharingField field : {SharingField::GF251, SharingField::GF256}) {
+        const std::vector<ShadowImage> shadows = splitSecretImage(secret, 3, 5, field, 1);
+        CHECK(shadows.size() == 5u);
+        if (shadows.size() != 5u) continue;
+        if (field == SharingField::GF256) CHECK(shadows[0].image.cols() == (101 + 2) / 3);
+
+        const std::vector<ShadowImage> parallel = splitSecretImage(secret, 3, 5, field, 4);
+        bool same = parallel.size() == shadows.size();
+        for (std::size_t i = 0; same && i < shadows.size(); ++i) same = test::sameImage(shadows[i].image, parallel[i].image);
+        CHECK(same);
+
+        for (const std::vector<int>& pick : {std::vector<int>{0, 1, 2}, {4, 2, 0}, {1, 3, 4}}) {
+            std::vector<ShadowImage> subset;
+            for (int i : pick) subset.push_back(shadows[i]);
+            Image<std::uint8_t> restored(secret.rows(), secret.cols());
+            CHECK(combineSecretImage(subset, 3, field, restored, 4));
+            CHECK(test::sameImage(restored, secret));
+        }
+
+        Image<std::uint8_t> restored(secret.rows(), secret.cols());
+        CHECK(!combineSecretImage({shadows[0], shadows[1]}, 3, field, restored));
+        CHECK(!combineSecretImage({shadows[0], shadows[0], shadows[1]}, 3, field, restored));
+    }
+}
+
+int main () { return test::runAll(); }
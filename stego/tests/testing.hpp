@@ -0,0 +1,115 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <random>
+#include <vector>
+
+#include "stego/bitstream.hpp"
+#include "stego/image.hpp"
+
+// --- stego_core 單元測試用的最小框架 (不依賴外部測試函式庫) ---
+// 每個測試檔各自是一個執行檔，以 STEGO_TEST 註冊測試、結尾呼叫 runAll()；
+// CHECK 失敗時印出位置並繼續執行，任何失敗都讓程式以 1 結束 (ctest 視為失敗)
+
+namespace stego {
+namespace test {
+
+struct Case {
+    const char* name;
+    void (*fn)();
+};
+
+inline std::vector<Case>& registry () {
+    static std::vector<Case> cases;
+    return cases;
+}
+
+inline int& failures () {
+    static int count = 0;
+    return count;
+}
+
+struct Registrar {
+    Registrar (const char* name, void (*fn)()) { registry().push_back({name, fn}); }
+};
+
+inline void fail (const char* file, int line, const char* expr) {
+    std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", file, line, expr);
+    ++failures();
+}
+
+inline int runAll () {
+    for (const Case& c : registry()) {
+        const int before = failures();
+        try {
+            c.fn();
+        } catch (const std::exception& e) {
+            std::fprintf(stderr, "%s: unexpected exception: %s\n", c.name, e.what());
+            ++failures();
+        }
+        std::printf("[%s] %s\n", failures() == before ? "  OK  " : " FAIL ", c.name);
+    }
+    return failures() ? 1 : 0;
+}
+
+// 類似自然影像的測試圖：平滑漸層加上小幅雜訊，直方圖集中 (RDH 才有足夠容量)；像素限制在 [lo, hi]
+inline Image<std::uint8_t> naturalImage (int rows, int cols, std::uint32_t seed, int lo = 0, int hi = 255) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> noise(-2, 2);
+    Image<std::uint8_t> img(rows, cols);
+    for (int r = 0; r < rows; ++r) {
+        for (int c = 0; c < cols; ++c) {
+            const int v = 128 + (r * 64) / rows - (c * 48) / cols + noise(rng);
+            img.at(r, c) = static_cast<std::uint8_t>(std::min(std::max(v, lo), hi));
+        }
+    }
+    return img;
+}
+
+// 均勻亂數影像 (通道交錯)
+inline Image<std::uint8_t> randomImage (int rows, int cols, std::uint32_t seed, int channels = 1) {
+    std::mt19937 rng(seed);
+    Image<std::uint8_t> img(rows, cols, channels);
+    for (std::size_t i = 0; i < img.total() * channels; ++i) img.data()[i] = static_cast<std::uint8_t>(rng());
+    return img;
+}
+
+inline BitBuffer randomBits (std::size_t numBits, std::uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::vector<std::uint8_t> bytes((numBits + 7) / 8);
+    for (std::uint8_t& b : bytes) b = static_cast<std::uint8_t>(rng());
+    return BitBuffer(std::move(bytes), numBits);
+}
+
+// 兩張影像的內容 (不看 step) 是否完全相同
+template <typename T>
+bool sameImage (ImageView<const T> a, ImageView<const T> b) {
+    if (a.rows != b.rows || a.cols != b.cols || a.channels != b.channels) return false;
+    for (int r = 0; r < a.rows; ++r) {
+        for (int c = 0; c < a.cols * a.channels; ++c) {
+            if (a.ptr(r)[c] != b.ptr(r)[c]) return false;
+        }
+    }
+    return true;
+}
+
+template <typename T>
+bool sameImage (const Image<T>& a, const Image<T>& b) {
+    return sameImage<T>(a.view(), b.view());
+}
+
+}  // namespace test
+}  // namespace stego
+
+#define STEGO_TEST(name)                                                          \
+    static void name ();                                                          \
+    static const ::stego::test::Registrar name##Registrar_(#name, &name);         \
+    static void name ()
+
+#define CHECK(expr)                                                               \
+    do {                                                                          \
+        if (!(expr)) ::stego::test::fail(__FILE__, __LINE__, #expr);              \
+    } while (0)
@@ -0,0 +1,97 @@
+// 視覺密碼的測試：位元打包的 (2,2)、(2,4) 分享圖與一般 (k,n) 基底矩陣，疊合後的黑子像素數，以及平行與單執行緒結果相同
+
+#include <algorithm>
+#include <vector>
+
+#include "stego/vc.hpp"
+#include "testing.hpp"
+
+using namespace stego;
+
+namespace {
+
+bool sameShares (const std::vector<ShareBitmap>& a, const std::vector<ShareBitmap>& b) {
+    if (a.size() != b.size()) return false;
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        if (a[i].rows() != b[i].rows() || a[i].cols() != b[i].cols()) return false;
+        for (int r = 0; r < a[i].rows(); ++r) {
+            if (!std::equal(a[i].row(r), a[i].row(r) + a[i].wordsPerRow(), b[i].row(r))) return false;
+        }
+    }
+    return true;
+}
+
+// 2x2 區塊 (br, bc) 內的黑色子像素數
+int blackIn (const ShareBitmap& share, int br, int bc) {
+    return share.black(2 * br, 2 * bc) + share.black(2 * br, 2 * bc + 1) + share.black(2 * br + 1, 2 * bc) + share.black(2 * br + 1, 2 * bc + 1);
+}
+
+}  // namespace
+
+// 寬度 70 個像素：分享圖每列 140 個子像素，跨越 64 位元字組邊界
+STEGO_TEST(visualCryptography2x2) {
+    const Image<std::uint8_t> secret = test::randomImage(37, 70, 1);
+    for (VCScheme scheme : {VCScheme::TwoOfTwo, VCScheme::TwoOfFour}) {
+        const std::vector<ShareBitmap> shares = generateShares(secret, scheme, 99, 1);
+        CHECK(shares.size() == (scheme == VCScheme::TwoOfTwo ? 2u : 4u));
+        CHECK(sameShares(shares, generateShares(secret, scheme, 99, 4)));
+        CHECK(!sameShares(shares, generateShares(secret, scheme, 100, 1)));
+
+        bool ok = true;
+        for (int r = 0; r < secret.rows(); ++r) {
+            for (int c = 0; c < secret.cols(); ++c) {
+                for (const ShareBitmap& share : shares) ok = ok && blackIn(share, r, c) == 2;  // 每張都是 2 黑 2 白
+            }
+        }
+        CHECK(ok);
+
+        // (2,2)：疊合後白點仍是 2 個黑子像素、黑點全黑
+        if (scheme == VCScheme::TwoOfTwo) {
+            const ShareBitmap stacked = stackShares(shares[0], shares[1]);
+            ok = true;
+            for (int r = 0; r < secret.rows(); ++r) {
+                for (int c = 0; c < secret.cols(); ++c) ok = ok && blackIn(stacked, r, c) == (secret.at(r, c) < 128 ? 4 : 2);
+            }
+            CHECK(ok);
+        }
+    }
+
+    const std::vector<ShareBitmap> shares = generateShares(secret, VCScheme::TwoOfTwo, 1, 1);
+    Image<std::uint8_t> unpacked(shares[0].rows(), shares[0].cols());
+    CHECK(unpackShare(shares[0], unpacked));
+    CHECK(unpacked.at(0, 0) == (shares[0].black(0, 0) ? 0 : 255));
+    CHECK(stackShares(shares[0], ShareBitmap(2, 2)).empty());
+}
+
+// 一般 (k,n)：逐一檢查全部 C(n, k) 種組合 (verifyShares)，少於 k 張疊合時黑白區塊的黑子像素數分布相同
+STEGO_TEST(visualCryptographyKN) {
+    const Image<std::uint8_t> secret = test::randomImage(20, 45, 2);
+    for (auto kn : {std::pair<int, int>{2, 3}, {3, 3}, {2, 4}, {3, 4}, {3, 5}, {4, 5}}) {
+        const VCBasis* basis = vcBasis(kn.first, kn.second);
+        CHECK(basis != nullptr);
+        if (!basis) continue;
+        CHECK(basis->whiteBlack < basis->blackBlack);
+
+        const std::vector<ShareBitmap> shares = generateShares(secret, *basis, 7, 1);
+        CHECK(shares.size() == static_cast<std::size_t>(kn.second));
+        CHECK(verifyShares(shares, secret, *basis));
+        CHECK(sameShares(shares, generateShares(secret, *basis, 7, 4)));
+        // 自行複製的基底 (沒有快取的排列表) 產生相同的分享圖
+        const VCBasis copy = *basis;
+        CHECK(sameShares(shares, generateShares(secret, copy, 7, 1)));
+
+        // 基底矩陣本身：前 k - 1 張的行向量在 S0 與 S1 中的分布相同
+        std::vector<std::uint32_t> white, black;
+        const std::uint32_t mask = (1u << (kn.first - 1)) - 1;
+        for (std::uint32_t col : basis->white) white.push_back(col & mask);
+        for (std::uint32_t col : basis->black) black.push_back(col & mask);
+        std::sort(white.begin(), white.end());
+        std::sort(black.begin(), black.end());
+        CHECK(white == black);
+    }
+    CHECK(vcBasis(1, 3) == nullptr);
+    CHECK(vcBasis(4, 3) == nullptr);
+    CHECK(vcBasis(2, 4) == vcBasis(2, 4));  // 同一組 (k,n) 只搜尋一次
+}
+
+int main () { return test::runAll(); }
@@ -0,0 +1,54 @@
+// 向量量化 (LBG 訓練、編碼、解碼) 的測試
+
+#include "stego/vq.hpp"
+#include "testing.hpp"
+
+using namespace stego;
+
+// 4x4 區塊只有兩種內容時，大小 2 的碼書可以無失真地表示每個區塊
+STEGO_TEST(trainEncodeDecodeRoundTrip) {
+    Image<std::uint8_t> img(32, 32);
+    for (int r = 0; r < 32; ++r) {
+        for (int c = 0; c < 32; ++c) img.at(r, c) = ((r / 4 + c / 4) % 2) ? 200 : 30;
+    }
+    const std::vector<VQVector> vectors = extractBlockVectors(img, 4);
+    CHECK(vectors.size() == 64u);
+    CHECK(vectors[0].size() == 16u);
+
+    const std::vector<VQVector> codebook = trainLBG(vectors, 2, 1e-3, 20, 0.01);
+    CHECK(codebook.size() == 2u);
+    const std::vector<int> indices = encodeVQ(vectors, codebook);
+    const std::vector<VQVector> decoded = decodeVQ(indices, codebook);
+    CHECK(decoded.size() == vectors.size());
+    double worst = 0;
+    for (std::size_t i = 0; i < vectors.size(); ++i) worst = std::max(worst, squaredDistance(vectors[i], decoded[i]));
+    CHECK(worst < 1e-9);
+    CHECK(indices[0] != indices[1]);
+
+    // 一般影像：碼書越大失真越小
+    const std::vector<VQVector> natural = extractBlockVectors(test::randomImage(64, 64, 1), 4);
+    double previous = -1;
+    for (int size : {1, 4, 16}) {
+        const std::vector<VQVector> book = trainLBG(natural, size, 1e-3, 20, 0.01);
+        CHECK(book.size() == static_cast<std::size_t>(size));
+        const std::vector<VQVector> back = decodeVQ(encodeVQ(natural, book), book);
+        double distortion = 0;
+        for (std::size_t i = 0; i < natural.size(); ++i) distortion += squaredDistance(natural[i], back[i]);
+        CHECK(previous < 0 || distortion < previous);
+        previous = distortion;
+    }
+
+    CHECK(decodeVQ({5, -1}, codebook)[0].empty());
+}
+
+// 不合法的碼書大小不能讓分裂迴圈無止境地執行
+STEGO_TEST(trainRejectsInvalidSize) {
+    const std::vector<VQVector> vectors = extractBlockVectors(test::randomImage(16, 16, 2), 4);
+    CHECK(trainLBG(vectors, 0, 1e-3, 10, 0.01).empty());
+    CHECK(trainLBG(vectors, -1, 1e-3, 10, 0.01).empty());
+    CHECK(trainLBG({}, 4, 1e-3, 10, 0.01).empty());
+    // 碼書大小以訓練向量數為上限
+    CHECK(trainLBG(vectors, 1000, 1e-3, 10, 0.01).size() == vectors.size());
+}
+
+int main () { return test::runAll(); }